@@ -0,0 +1,54 @@
+#include "AllocationCounter.hpp"
+
+#include <atomic>
+
+namespace
+{
+	// Ustawiane podczas inicjalizacji statycznej, przed utworzeniem wątków
+	bool Available = false;
+
+	thread_local AllocationCounter::Count_t ThreadAllocations = 0;
+	thread_local AllocationCounter::Count_t ThreadAllocatedBytes = 0;
+
+	// Liczniki procesu - wspólne dla wszystkich wątków, więc zwiększane tylko w programach z podmienionymi operatorami
+	std::atomic<AllocationCounter::Count_t> Allocations(0);
+	std::atomic<AllocationCounter::Count_t> AllocatedBytes(0);
+}
+
+bool AllocationCounter::IsAvailable()
+{
+	return Available;
+}
+
+AllocationCounter::Count_t AllocationCounter::GetThreadAllocations()
+{
+	return ThreadAllocations;
+}
+
+AllocationCounter::Count_t AllocationCounter::GetThreadAllocatedBytes()
+{
+	return ThreadAllocatedBytes;
+}
+
+AllocationCounter::Count_t AllocationCounter::GetAllocations()
+{
+	return Allocations.load(std::memory_order_relaxed);
+}
+
+AllocationCounter::Count_t AllocationCounter::GetAllocatedBytes()
+{
+	return AllocatedBytes.load(std::memory_order_relaxed);
+}
+
+void AllocationCounter::Enable()
+{
+	Available = true;
+}
+
+void AllocationCounter::Count(const std::size_t & Size)
+{
+	++ThreadAllocations;
+	ThreadAllocatedBytes += Size;
+	Allocations.fetch_add(1, std::memory_order_relaxed);
+	AllocatedBytes.fetch_add(Size, std::memory_order_relaxed);
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+	Licznik alokacji na stercie.
+
+	Zlicza wywołania new oraz zaalokowane bajty - osobno dla każdego wątku i łącznie dla procesu.
+	Służy do weryfikacji, że gorące pętle algorytmu (ParticleGroup::Run) nie alokują pamięci, oraz do pomiarów (PsoSppBench).
+
+	Liczniki zwiększają podmienione globalne operatory new / delete z AllocationCounterOperators.cpp. Plik ten nie należy do biblioteki algorytmu -
+	dołącza go tylko program, który chce liczyć alokacje (PsoSpp, PsoSppBench), więc biblioteka nie podmienia alokatora programu, który ją używa.
+	Bez niego IsAvailable() zwraca false, a wszystkie liczniki 0.
+*/
+class AllocationCounter
+{
+	public:
+		typedef uint64_t Count_t;
+
+	public:
+		/*
+			Czy program dołączył podmienione operatory (AllocationCounterOperators.cpp)
+		*/
+		static bool IsAvailable();
+
+		/*
+			Liczba alokacji wykonanych do tej pory przez bieżący wątek
+		*/
+		static Count_t GetThreadAllocations();
+
+		/*
+			Liczba bajtów zaalokowanych do tej pory przez bieżący wątek (rozmiary żądane w new, bez narzutu alokatora)
+		*/
+		static Count_t GetThreadAllocatedBytes();
+
+		/*
+			Liczba alokacji i zaalokowanych bajtów wszystkich wątków procesu
+		*/
+		static Count_t GetAllocations();
+		static Count_t GetAllocatedBytes();
+
+	public:
+		/*
+			Tylko dla podmienionych operatorów: włączenie liczników (inicjalizacja statyczna) i zliczenie jednej alokacji o rozmiarze Size
+		*/
+		static void Enable();
+		static void Count(const std::size_t & Size);
+};
@@ -0,0 +1,157 @@
+#include "AllocationCounter.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+/*
+	Podmienione globalne operatory new / delete zliczające alokacje (AllocationCounter).
+	Dołączany tylko do programów, które liczą alokacje - nie należy do biblioteki algorytmu.
+*/
+
+namespace
+{
+	// Liczniki dostępne od inicjalizacji statycznej programu
+	const bool Enabled = (AllocationCounter::Enable(), true);
+
+	void * Allocate(std::size_t Size)
+	{
+		// malloc(0) może zwrócić nullptr, new musi zwrócić unikalny wskaźnik
+		if(Size == 0)
+			Size = 1;
+
+		return std::malloc(Size);
+	}
+
+	void * AllocateAligned(std::size_t Size, const std::align_val_t & Alignment)
+	{
+		if(Size == 0)
+			Size = 1;
+
+#if defined(_MSC_VER)
+		return _aligned_malloc(Size, (std::size_t) Alignment);
+#else
+		void * Pointer = nullptr;
+		if(posix_memalign(&Pointer, std::max((std::size_t) Alignment, sizeof(void *)), Size) != 0)
+			return nullptr;
+		return Pointer;
+#endif
+	}
+
+	// Jak wymaga standard - przy braku pamięci wywołujemy std::new_handler i próbujemy ponownie. Bez handlera - std::bad_alloc
+	template<typename Allocate_t>
+	void * AllocateOrThrow(const std::size_t & Size, Allocate_t && AllocateFunction)
+	{
+		AllocationCounter::Count(Size);
+
+		while(true)
+		{
+			void * Pointer = AllocateFunction();
+			if(Pointer)
+				return Pointer;
+
+			const std::new_handler Handler = std::get_new_handler();
+			if(!Handler)
+				throw std::bad_alloc();
+			Handler();
+		}
+	}
+
+	void Free(void * Pointer)
+	{
+		std::free(Pointer);
+	}
+
+	void FreeAligned(void * Pointer)
+	{
+#if defined(_MSC_VER)
+		_aligned_free(Pointer);
+#else
+		std::free(Pointer);
+#endif
+	}
+}
+
+void * operator new(std::size_t Size)
+{
+	return AllocateOrThrow(Size, [&]() { return Allocate(Size); });
+}
+
+void * operator new[](std::size_t Size)
+{
+	return AllocateOrThrow(Size, [&]() { return Allocate(Size); });
+}
+
+void * operator new(std::size_t Size, const std::nothrow_t &) noexcept
+{
+	try
+	{
+		return operator new(Size);
+	}
+	catch(...)
+	{
+		return nullptr;
+	}
+}
+
+void * operator new[](std::size_t Size, const std::nothrow_t &) noexcept
+{
+	try
+	{
+		return operator new[](Size);
+	}
+	catch(...)
+	{
+		return nullptr;
+	}
+}
+
+void * operator new(std::size_t Size, std::align_val_t Alignment)
+{
+	return AllocateOrThrow(Size, [&]() { return AllocateAligned(Size, Alignment); });
+}
+
+void * operator new[](std::size_t Size, std::align_val_t Alignment)
+{
+	return AllocateOrThrow(Size, [&]() { return AllocateAligned(Size, Alignment); });
+}
+
+void operator delete(void * Pointer) noexcept
+{
+	Free(Pointer);
+}
+
+void operator delete[](void * Pointer) noexcept
+{
+	Free(Pointer);
+}
+
+void operator delete(void * Pointer, std::size_t) noexcept
+{
+	Free(Pointer);
+}
+
+void operator delete[](void * Pointer, std::size_t) noexcept
+{
+	Free(Pointer);
+}
+
+void operator delete(void * Pointer, std::align_val_t) noexcept
+{
+	FreeAligned(Pointer);
+}
+
+void operator delete[](void * Pointer, std::align_val_t) noexcept
+{
+	FreeAligned(Pointer);
+}
+
+void operator delete(void * Pointer, std::size_t, std::align_val_t) noexcept
+{
+	FreeAligned(Pointer);
+}
+
+void operator delete[](void * Pointer, std::size_t, std::align_val_t) noexcept
+{
+	FreeAligned(Pointer);
+}
@@ -0,0 +1,159 @@
+#include "DecodeScratch.hpp"
+
+#include <algorithm>
+#include <limits>
+
+DecodeScratch::DecodeScratch(const Graph & G):
+	Size(G.GetSize()),
+	VisitedMarks(new VisitedMark_t[Size]),
+	VisitedMark(0),
+	PathPositions(new uint32_t[Size]),
+	PathWeight(0),
+	NeighborsBuffer(G.CreateNeighborsBuffer()),
+	NeighborsBufferSecond(G.CreateNeighborsBuffer())
+{
+	std::fill(VisitedMarks.get(), VisitedMarks.get() + Size, 0);
+
+	// Ścieżka bez cykli ma co najwyżej Size wierzchołków
+	VertexIndexes.reserve(Size);
+	EdgeWeights.reserve(Size);
+	PathWeightPrefixes.reserve(Size);
+}
+
+void DecodeScratch::Begin()
+{
+	NextVisitedMark();
+
+	// clear() zachowuje pojemność bufora
+	VertexIndexes.clear();
+	EdgeWeights.clear();
+	PathWeight = 0;
+}
+
+void DecodeScratch::Push(const Graph::VertexIndex_t & VertexIndex, const Graph::EdgeWeight_t & EdgeWeight)
+{
+	VertexIndexes.push_back(VertexIndex);
+	EdgeWeights.push_back(EdgeWeight);
+	PathWeight += EdgeWeight;
+}
+
+void DecodeScratch::Visit(const Graph::VertexIndex_t & VertexIndex)
+{
+	VisitedMarks[VertexIndex] = VisitedMark;
+}
+
+void DecodeScratch::Truncate(const size_t & Length)
+{
+	for(size_t Position = Length; Position < VertexIndexes.size(); Position++)
+		PathWeight -= EdgeWeights[Position];
+
+	// resize() w dół nie zmienia pojemności
+	VertexIndexes.resize(Length);
+	EdgeWeights.resize(Length);
+}
+
+void DecodeScratch::IndexPath()
+{
+	NextVisitedMark();
+
+	// resize() w granicach zarezerwowanej pojemności - bez alokacji
+	PathWeightPrefixes.resize(VertexIndexes.size());
+
+	GraphPath::PathWeight_t PathWeightPrefix = 0;
+	for(size_t Position = 0; Position < VertexIndexes.size(); Position++)
+	{
+		VisitedMarks[VertexIndexes[Position]] = VisitedMark;
+		PathPositions[VertexIndexes[Position]] = (uint32_t) Position;
+
+		PathWeightPrefix += EdgeWeights[Position];
+		PathWeightPrefixes[Position] = PathWeightPrefix;
+	}
+}
+
+void DecodeScratch::ReplaceSegment(const size_t & PositionBegin, const size_t & PositionEnd, const bool & HasVertex, const Graph::VertexIndex_t & VertexIndex, const Graph::EdgeWeight_t & EdgeWeightIn, const Graph::EdgeWeight_t & EdgeWeightOut)
+{
+	// Waga usuwanego fragmentu
+	for(size_t Position = PositionBegin + 1; Position <= PositionEnd; Position++)
+		PathWeight -= EdgeWeights[Position];
+
+	// Usunięcie wierzchołków wewnętrznych - PositionEnd przesuwa się na PositionBegin + 1
+	VertexIndexes.erase(VertexIndexes.begin() + PositionBegin + 1, VertexIndexes.begin() + PositionEnd);
+	EdgeWeights.erase(EdgeWeights.begin() + PositionBegin + 1, EdgeWeights.begin() + PositionEnd);
+
+	// Wstawienie nowego wierzchołka. Ścieżka bez cykli mieści się w zarezerwowanym buforze - bez alokacji
+	if(HasVertex)
+	{
+		VertexIndexes.insert(VertexIndexes.begin() + PositionBegin + 1, VertexIndex);
+		EdgeWeights.insert(EdgeWeights.begin() + PositionBegin + 1, EdgeWeightIn);
+		EdgeWeights[PositionBegin + 2] = EdgeWeightOut;
+		PathWeight += (GraphPath::PathWeight_t) EdgeWeightIn + EdgeWeightOut;
+	}
+	else
+	{
+		EdgeWeights[PositionBegin + 1] = EdgeWeightIn;
+		PathWeight += EdgeWeightIn;
+	}
+}
+
+void DecodeScratch::NextVisitedMark()
+{
+	// Nowa epoka - wszystkie węzły stają się nieodwiedzone
+	++VisitedMark;
+
+	// Przepełnienie licznika epok - raz na 2^32 dekodowań czyścimy tablicę
+	if(VisitedMark == 0)
+	{
+		std::fill(VisitedMarks.get(), VisitedMarks.get() + Size, 0);
+		VisitedMark = 1;
+	}
+}
+
+const DecodeScratch::VisitedMark_t * DecodeScratch::GetVisitedMarks() const
+{
+	return VisitedMarks.get();
+}
+
+const DecodeScratch::VisitedMark_t & DecodeScratch::GetVisitedMark() const
+{
+	return VisitedMark;
+}
+
+const std::vector<Graph::VertexIndex_t> & DecodeScratch::GetVertexIndexes() const
+{
+	return VertexIndexes;
+}
+
+const std::vector<Graph::EdgeWeight_t> & DecodeScratch::GetEdgeWeights() const
+{
+	return EdgeWeights;
+}
+
+const GraphPath::PathWeight_t & DecodeScratch::GetPathWeight() const
+{
+	return PathWeight;
+}
+
+Graph::NeighborsBuffer_t & DecodeScratch::GetNeighborsBuffer()
+{
+	return NeighborsBuffer;
+}
+
+Graph::NeighborsBuffer_t & DecodeScratch::GetNeighborsBufferSecond()
+{
+	return NeighborsBufferSecond;
+}
+
+bool DecodeScratch::IsOnPath(const Graph::VertexIndex_t & VertexIndex) const
+{
+	return VisitedMarks[VertexIndex] == VisitedMark;
+}
+
+size_t DecodeScratch::GetPathPosition(const Graph::VertexIndex_t & VertexIndex) const
+{
+	return PathPositions[VertexIndex];
+}
+
+const GraphPath::PathWeight_t & DecodeScratch::GetPathWeightPrefix(const size_t & Position) const
+{
+	return PathWeightPrefixes[Position];
+}
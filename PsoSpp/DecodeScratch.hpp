@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Graph.hpp"
+#include "GraphPath.hpp"
+
+/*
+	Bufory robocze dekodowania cząstki (Particle::Run).
+
+	Jedna instancja na wątek (grupę cząstek), współdzielona przez wszystkie jej cząstki.
+	Po utworzeniu kolejne dekodowania nie wykonują żadnych alokacji:
+		- zbiór odwiedzonych węzłów to tablica znaczników epoki - nowe dekodowanie zwiększa epokę zamiast czyścić tablicę
+		- wierzchołki ścieżki trafiają do bufora zarezerwowanego na najdłuższą możliwą ścieżkę
+		- waga ścieżki liczona jest na bieżąco
+		- sąsiedzi wierzchołka grafu niejawnego wyliczani są do bufora przygotowanego przez graf
+
+	Po dekodowaniu bufory służą również przeszukiwaniu lokalnemu ścieżki (PathLocalSearch): IndexPath zapamiętuje pozycję każdego wierzchołka ścieżki,
+	a ReplaceSegment podmienia jej fragment w miejscu.
+*/
+class DecodeScratch
+{
+	public:
+		typedef uint32_t VisitedMark_t;
+
+	public:
+		/*
+			G - graf, dla którego przygotowywane są bufory
+		*/
+		DecodeScratch(const Graph & G);
+
+	private:
+		const Graph::VertexIndex_t Size;
+
+		/*
+			Węzeł jest odwiedzony w bieżącym dekodowaniu, jeśli VisitedMarks[Węzeł] == VisitedMark
+		*/
+		std::unique_ptr<VisitedMark_t[]> VisitedMarks; /* Size */
+		VisitedMark_t VisitedMark;
+
+		/*
+			Pozycja wierzchołka na ścieżce (IndexPath), ważna jeśli VisitedMarks[Węzeł] == VisitedMark
+		*/
+		std::unique_ptr<uint32_t[]> PathPositions; /* Size */
+
+		/*
+			Wierzchołki bieżącej ścieżki i wagi krawędzi prowadzących do nich (0 dla pierwszego)
+		*/
+		std::vector<Graph::VertexIndex_t> VertexIndexes;
+		std::vector<Graph::EdgeWeight_t> EdgeWeights;
+
+		/*
+			Waga bieżącej ścieżki
+		*/
+		GraphPath::PathWeight_t PathWeight;
+
+		/*
+			Waga ścieżki od początku do każdej pozycji (IndexPath) - waga fragmentu w O(1)
+		*/
+		std::vector<GraphPath::PathWeight_t> PathWeightPrefixes;
+
+		/*
+			Bufor na sąsiadów bieżącego wierzchołka (Graph::GetNeighbors)
+		*/
+		Graph::NeighborsBuffer_t NeighborsBuffer;
+
+		/*
+			Drugi bufor - na sąsiadów innego wierzchołka, gdy potrzebne są jednocześnie dwie listy (PathLocalSearch)
+		*/
+		Graph::NeighborsBuffer_t NeighborsBufferSecond;
+
+		/*
+			Nowa epoka znaczników - wszystkie węzły stają się nieodwiedzone
+		*/
+		void NextVisitedMark();
+
+	public:
+		/*
+			Rozpoczyna nowe dekodowanie - czyści ścieżkę i zbiór odwiedzonych węzłów
+		*/
+		void Begin();
+
+		/*
+			Dodaje wierzchołek na koniec ścieżki. EdgeWeight - waga krawędzi prowadzącej do niego (0 dla pierwszego)
+		*/
+		void Push(const Graph::VertexIndex_t & VertexIndex, const Graph::EdgeWeight_t & EdgeWeight);
+
+		/*
+			Oznacza węzeł jako odwiedzony
+		*/
+		void Visit(const Graph::VertexIndex_t & VertexIndex);
+
+		/*
+			Skraca ścieżkę do pierwszych Length wierzchołków (np. do pierwszego celu zadania wielocelowego). Waga ścieżki jest aktualizowana,
+			usunięte wierzchołki pozostają odwiedzone
+		*/
+		void Truncate(const size_t & Length);
+
+		/*
+			Rozpoczyna nową epokę znaczników, w której odwiedzone są dokładnie wierzchołki bieżącej ścieżki (łącznie z ostatnim),
+			i zapamiętuje ich pozycje (IsOnPath, GetPathPosition) oraz wagi ścieżki do każdej pozycji (GetPathWeightPrefix). Dekodowanie tej ścieżki jest już zakończone
+		*/
+		void IndexPath();
+
+		/*
+			Zastępuje wierzchołki pomiędzy pozycjami PositionBegin i PositionEnd (bez nich):
+				- pojedynczym wierzchołkiem VertexIndex, jeśli HasVertex. EdgeWeightIn - waga krawędzi do niego, EdgeWeightOut - z niego do PositionEnd
+				- niczym w przeciwnym razie. EdgeWeightIn - waga krawędzi z PositionBegin do PositionEnd
+			Waga ścieżki jest aktualizowana. Pozycje z IndexPath przestają być aktualne
+		*/
+		void ReplaceSegment(const size_t & PositionBegin, const size_t & PositionEnd, const bool & HasVertex, const Graph::VertexIndex_t & VertexIndex, const Graph::EdgeWeight_t & EdgeWeightIn, const Graph::EdgeWeight_t & EdgeWeightOut);
+
+	public:
+		const VisitedMark_t * GetVisitedMarks() const;
+		const VisitedMark_t & GetVisitedMark() const;
+
+		const std::vector<Graph::VertexIndex_t> & GetVertexIndexes() const;
+		const std::vector<Graph::EdgeWeight_t> & GetEdgeWeights() const;
+		const GraphPath::PathWeight_t & GetPathWeight() const;
+
+		bool IsOnPath(const Graph::VertexIndex_t & VertexIndex) const;
+		size_t GetPathPosition(const Graph::VertexIndex_t & VertexIndex) const;
+		const GraphPath::PathWeight_t & GetPathWeightPrefix(const size_t & Position) const;
+
+		Graph::NeighborsBuffer_t & GetNeighborsBuffer();
+		Graph::NeighborsBuffer_t & GetNeighborsBufferSecond();
+};
+
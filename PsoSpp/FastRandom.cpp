@@ -0,0 +1,93 @@
+#include "FastRandom.hpp"
+
+#include <algorithm>
+
+namespace
+{
+	const size_t RandomLanes = ParticleKernels::RandomLanes;
+
+	// Wielomiany przesunięcia xoshiro256 - o 2^128 (Jump) i o 2^192 (LongJump) kroków
+	const uint64_t JumpPolynomial[4] = { 0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull };
+	const uint64_t LongJumpPolynomial[4] = { 0x76E15D3EFEFDCBBFull, 0xC5004E441C522FB3ull, 0x77710069854EE241ull, 0x39109BB02ACBE635ull };
+
+	// Krok stanu xoshiro256 jednego toru (State[Słowo * RandomLanes + Lane])
+	void Step(uint64_t * State, const size_t & Lane)
+	{
+		uint64_t & S0 = State[0 * RandomLanes + Lane];
+		uint64_t & S1 = State[1 * RandomLanes + Lane];
+		uint64_t & S2 = State[2 * RandomLanes + Lane];
+		uint64_t & S3 = State[3 * RandomLanes + Lane];
+
+		const uint64_t T = S1 << 17;
+		S2 ^= S0;
+		S3 ^= S1;
+		S1 ^= S2;
+		S0 ^= S3;
+		S2 ^= T;
+		S3 = (S3 << 45) | (S3 >> 19);
+	}
+
+	// Przesunięcie toru o liczbę kroków zadaną wielomianem - 256 kroków zamiast 2^128 / 2^192
+	void Jump(uint64_t * State, const size_t & Lane, const uint64_t (& Polynomial)[4])
+	{
+		uint64_t Result[4] = { 0, 0, 0, 0 };
+		for(const uint64_t & Word : Polynomial)
+		{
+			for(size_t Bit = 0; Bit < 64; Bit++)
+			{
+				if(Word & (1ull << Bit))
+				{
+					for(size_t Index = 0; Index < 4; Index++)
+						Result[Index] ^= State[Index * RandomLanes + Lane];
+				}
+				Step(State, Lane);
+			}
+		}
+
+		for(size_t Index = 0; Index < 4; Index++)
+			State[Index * RandomLanes + Lane] = Result[Index];
+	}
+}
+
+FastRandom::FastRandom(const Seed_t & Seed)
+{
+	// splitmix64 - rozprowadza pojedynczą wartość na stan pierwszego toru, gwarantuje niezerowy stan
+	uint64_t SplitMixState = Seed;
+	for(size_t Index = 0; Index < 4; Index++)
+	{
+		uint64_t Z = (SplitMixState += 0x9E3779B97F4A7C15ull);
+		Z = (Z ^ (Z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		Z = (Z ^ (Z >> 27)) * 0x94D049BB133111EBull;
+		State[Index * RandomLanes] = Z ^ (Z >> 31);
+	}
+
+	// Kolejne tory - poprzedni tor przesunięty o 2^128 kroków
+	for(size_t Lane = 1; Lane < RandomLanes; Lane++)
+	{
+		for(size_t Index = 0; Index < 4; Index++)
+			State[Index * RandomLanes + Lane] = State[Index * RandomLanes + Lane - 1];
+		Jump(State, Lane, JumpPolynomial);
+	}
+}
+
+void FastRandom::Uniform(double * Output, const size_t & Count)
+{
+	// Pełne bloki - bezpośrednio do wyjścia
+	const size_t Blocks = Count / RandomLanes;
+	ParticleKernels::RandomUniformBlocks(State, Output, Blocks);
+
+	// Niepełny ostatni blok - przez bufor
+	const size_t Remaining = Count - Blocks * RandomLanes;
+	if(Remaining > 0)
+	{
+		double Buffer[RandomLanes];
+		ParticleKernels::RandomUniformBlocks(State, Buffer, 1);
+		std::copy(Buffer, Buffer + Remaining, Output + Blocks * RandomLanes);
+	}
+}
+
+void FastRandom::LongJump()
+{
+	for(size_t Lane = 0; Lane < RandomLanes; Lane++)
+		Jump(State, Lane, LongJumpPolynomial);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+
+#include "ParticleKernels.hpp"
+
+/*
+	Szybki generator liczb losowych do masowego losowania (np. czynników R1, R2 w Particle::Update).
+
+	xoshiro256+ w ParticleKernels::RandomLanes niezależnych torach - kolejne liczby z różnych torów mogą być liczone jednocześnie instrukcjami SIMD.
+	Stan pierwszego toru inicjowany jest z jednej wartości algorytmem splitmix64, kolejne tory to poprzedni tor przesunięty o 2^128 kroków (Jump xoshiro256).
+	Tory nie nakładają się więc, dopóki żaden z nich nie wygeneruje 2^128 liczb.
+
+	Niezależne strumienie (np. po jednym na cząstkę) tworzy się przez kopię generatora i LongJump - przesunięcie wszystkich torów o 2^192 kroków.
+	Stan zajmuje 256 B i nie jest współdzielony, więc każdy strumień może być używany przez inny wątek, a wynik nie zależy od kolejności ich wykonania.
+*/
+class FastRandom
+{
+	public:
+		typedef uint64_t Seed_t;
+
+	public:
+		/*
+			Seed - wartość inicjująca generator
+		*/
+		FastRandom(const Seed_t & Seed);
+
+	private:
+		/*
+			Stan generatora - 4 słowa po RandomLanes torów
+		*/
+		alignas(64) uint64_t State[4 * ParticleKernels::RandomLanes];
+
+	public:
+		/*
+			Wypełnia Output liczbami z zakresu [0.0; 1.0)
+			Count nie musi być wielokrotnością liczby torów - nadmiarowe liczby z ostatniego bloku są odrzucane
+		*/
+		void Uniform(double * Output, const size_t & Count);
+
+		/*
+			Przesuwa wszystkie tory o 2^192 kroków. Kopia generatora sprzed przesunięcia i generator po nim to dwa rozłączne strumienie
+		*/
+		void LongJump();
+};
+
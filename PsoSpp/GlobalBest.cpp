@@ -0,0 +1,77 @@
+#include "GlobalBest.hpp"
+
+#include <algorithm>
+#include <limits>
+
+GlobalBest::GlobalBest(const Graph::VertexIndex_t & Size, const size_t & SnapshotNumber):
+	Size(Size), SnapshotNumber(std::max<size_t>(2, SnapshotNumber)), Current(nullptr), PathWeight(std::numeric_limits<GraphPath::PathWeight_t>::max())
+{
+	Snapshots.reset(new Snapshot_t[this->SnapshotNumber]);
+	for(size_t SnapshotId = 0; SnapshotId < this->SnapshotNumber; SnapshotId++)
+	{
+		Snapshots[SnapshotId].PathWeight = std::numeric_limits<GraphPath::PathWeight_t>::max();
+		Snapshots[SnapshotId].Priorities.reset(new Particle::Priority_t[Size]);
+		Snapshots[SnapshotId].Readers.store(0);
+	}
+}
+
+GraphPath::PathWeight_t GlobalBest::GetPathWeight() const
+{
+	return PathWeight.load(std::memory_order_relaxed);
+}
+
+const GlobalBest::Snapshot_t * GlobalBest::Acquire()
+{
+	// Operacje na Current i Readers są sekwencyjnie spójne - pisarz, który nie zobaczył naszego licznika,
+	// musiał podmienić Current przed naszym ponownym sprawdzeniem
+	while(true)
+	{
+		Snapshot_t * Snapshot = Current.load();
+		if(!Snapshot)
+			return nullptr;
+
+		Snapshot->Readers.fetch_add(1);
+		if(Current.load() == Snapshot)
+			return Snapshot;
+
+		// Migawka przestała być bieżąca - może być właśnie nadpisywana
+		Snapshot->Readers.fetch_sub(1);
+	}
+}
+
+void GlobalBest::Release(const Snapshot_t * Snapshot)
+{
+	if(Snapshot)
+		const_cast<Snapshot_t *>(Snapshot)->Readers.fetch_sub(1, std::memory_order_release);
+}
+
+bool GlobalBest::Publish(const GraphPath::PathWeight_t & PathWeightNew, const Particle::Priority_t * Priorities)
+{
+	// Szybkie odrzucenie bez blokady
+	if(PathWeightNew >= PathWeight.load(std::memory_order_relaxed))
+		return false;
+
+	std::lock_guard<std::mutex> Lock(PublishMutex);
+
+	// Inny pisarz mógł w międzyczasie opublikować lepsze rozwiązanie
+	if(PathWeightNew >= PathWeight.load(std::memory_order_relaxed))
+		return false;
+
+	Snapshot_t * SnapshotCurrent = Current.load();
+	for(size_t SnapshotId = 0; SnapshotId < SnapshotNumber; SnapshotId++)
+	{
+		Snapshot_t & Snapshot = Snapshots[SnapshotId];
+		if(&Snapshot == SnapshotCurrent || Snapshot.Readers.load() != 0)
+			continue;
+
+		std::copy(Priorities, Priorities + Size, Snapshot.Priorities.get());
+		Snapshot.PathWeight = PathWeightNew;
+
+		Current.store(&Snapshot);
+		PathWeight.store(PathWeightNew, std::memory_order_relaxed);
+		return true;
+	}
+
+	// Wszystkie migawki zajęte przez czytelników
+	return false;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include "Particle.hpp"
+#include "GraphPath.hpp"
+
+/*
+	Najlepsze rozwiązanie wszystkich grup cząstek, publikowane w trakcie obliczeń (asynchroniczny wariant PSO).
+
+	Rozwiązanie przechowywane jest jako niezmienna migawka (Snapshot_t): waga i wektor priorytetów.
+	Publikacja (RCU) - pisarz wypełnia wolną migawkę i podmienia na nią atomowy wskaźnik Current. Migawki nie są zwalniane, tylko używane ponownie:
+		- czytelnik zwiększa licznik Readers migawki i sprawdza, czy nadal jest bieżąca - jeśli nie, wycofuje się i próbuje ponownie
+		- pisarz nadpisuje tylko migawkę, która nie jest bieżąca i nie ma czytelników
+	Odczyt nie blokuje i nie alokuje pamięci. Pisarze (rzadcy - tylko przy poprawie wyniku) są serializowani przez PublishMutex.
+
+	Liczba migawek ogranicza liczbę jednoczesnych czytelników - jeśli wszystkie są zajęte, publikacja się nie udaje i należy ją powtórzyć później.
+*/
+class GlobalBest
+{
+	public:
+		struct Snapshot_t
+		{
+			GraphPath::PathWeight_t PathWeight;
+			std::unique_ptr<Particle::Priority_t[]> Priorities; /* Size */
+
+			// Liczba czytelników trzymających migawkę
+			std::atomic<size_t> Readers;
+		};
+
+	public:
+		/*
+			Size - rozmiar grafu (długość wektora priorytetów)
+			SnapshotNumber - liczba migawek. Powinna przekraczać liczbę wątków czytających jednocześnie
+		*/
+		GlobalBest(const Graph::VertexIndex_t & Size, const size_t & SnapshotNumber);
+		GlobalBest(const GlobalBest &) = delete;
+		GlobalBest & operator=(const GlobalBest &) = delete;
+
+	private:
+		const Graph::VertexIndex_t Size;
+
+		std::unique_ptr<Snapshot_t[]> Snapshots;
+		const size_t SnapshotNumber;
+
+		/*
+			Bieżąca migawka. nullptr - nic jeszcze nie opublikowano
+		*/
+		std::atomic<Snapshot_t *> Current;
+
+		/*
+			Waga bieżącej migawki - do taniego sprawdzenia, czy warto publikować
+		*/
+		std::atomic<GraphPath::PathWeight_t> PathWeight;
+
+		std::mutex PublishMutex;
+
+	public:
+		/*
+			Waga bieżącego rozwiązania. std::numeric_limits<GraphPath::PathWeight_t>::max() - brak rozwiązania
+		*/
+		GraphPath::PathWeight_t GetPathWeight() const;
+
+	public:
+		/*
+			Pobiera bieżącą migawkę (lub nullptr, jeśli nic nie opublikowano). Migawka pozostaje niezmienna do wywołania Release
+		*/
+		const Snapshot_t * Acquire();
+		void Release(const Snapshot_t * Snapshot);
+
+		/*
+			Publikuje rozwiązanie, jeśli jest lepsze od bieżącego. Zwraca false, jeśli nie jest lepsze lub brak wolnej migawki
+		*/
+		bool Publish(const GraphPath::PathWeight_t & PathWeightNew, const Particle::Priority_t * Priorities);
+};
+
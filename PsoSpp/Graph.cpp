@@ -1,12 +1,47 @@
 #include "Graph.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <iomanip>
-#include <random>
+#include <limits>
+#include <numeric>
+#include <thread>
+#include <vector>
 
-Graph::Graph(const VertexId_t & Size, AdjascencyMatrix_t && AdjascencyMatrix):
-	SideSize(Size), AdjascencyMatrix(std::move(AdjascencyMatrix))
+#include <stdexcept>
+
+#include "GraphFile.hpp"
+#include "WaxmanModel.hpp"
+
+namespace
 {
+	// Tablice CSR grafu utworzonego na stercie
+	struct HeapStorage_t
+	{
+		Graph::EdgeOffsets_t EdgeOffsets;
+		Graph::NeighborVertexIndexes_t NeighborVertexIndexes;
+		Graph::EdgeWeights_t EdgeWeights;
+	};
+}
 
+Graph::Graph(const VertexId_t & Size, EdgeOffsets_t && EdgeOffsets, NeighborVertexIndexes_t && NeighborVertexIndexes, EdgeWeights_t && EdgeWeights):
+	SideSize(Size), EdgeOffsets(EdgeOffsets.get()), NeighborVertexIndexes(NeighborVertexIndexes.get()), EdgeWeights(EdgeWeights.get()),
+	Storage(std::make_shared<const HeapStorage_t>(HeapStorage_t{ std::move(EdgeOffsets), std::move(NeighborVertexIndexes), std::move(EdgeWeights) }))
+{
+
+}
+
+Graph::Graph(const VertexId_t & SideSize, const EdgeIndex_t * EdgeOffsets, const NeighborVertexIndex_t * NeighborVertexIndexes, const EdgeWeight_t * EdgeWeights, std::shared_ptr<const void> && Storage):
+	SideSize(SideSize), EdgeOffsets(EdgeOffsets), NeighborVertexIndexes(NeighborVertexIndexes), EdgeWeights(EdgeWeights), Storage(std::move(Storage))
+{
+
+}
+
+Graph::Graph(const WaxmanModel & Model):
+	SideSize(Model.GetSideSize()), EdgeOffsets(nullptr), NeighborVertexIndexes(nullptr), EdgeWeights(nullptr), Model(std::make_shared<const WaxmanModel>(Model))
+{
+	if(Model.GetEpsilon() <= 0)
+		throw std::invalid_argument("Model.GetEpsilon() <= 0");
 }
 
 const Graph::VertexId_t & Graph::GetSideSize() const
@@ -19,16 +54,119 @@ const Graph::VertexIndex_t Graph::GetSize() const
 	return SideSize * SideSize;
 }
 
+const Graph::EdgeIndex_t Graph::GetEdgeCount() const
+{
+	if(!Model)
+		return EdgeOffsets[GetSize()];
+
+	// Graf niejawny - zliczamy sąsiadów wszystkich wierzchołków
+	NeighborsBuffer_t Buffer = CreateNeighborsBuffer();
+
+	EdgeIndex_t EdgeCount = 0;
+	for(VertexIndex_t VertexIndex = 0; VertexIndex < GetSize(); VertexIndex++)
+		EdgeCount += GetNeighbors(VertexIndex, Buffer).Size;
+
+	return EdgeCount;
+}
+
+bool Graph::IsImplicit() const
+{
+	return (bool) Model;
+}
+
+size_t Graph::GetFootprint() const
+{
+	// Model z tablicą prawdopodobieństw w promieniu obcięcia
+	if(Model)
+		return Model->GetFootprint();
+
+	return (GetSize() + 1) * sizeof(EdgeIndex_t) + GetEdgeCount() * (sizeof(NeighborVertexIndex_t) + sizeof(EdgeWeight_t));
+}
+
 const Graph::EdgeWeight_t Graph::GetEdgeWeight(const VertexIndex_t & Vertex1Index, const VertexIndex_t & Vertex2Index) const
 {
-	// Indeksy krawdzi
-	const size_t Edge1Index = SideSize * SideSize * Vertex2Index + Vertex1Index;
-	// const size_t Edge2Index = SideSize * SideSize * Vertex2Index + Vertex1Index;
+	// Graf niejawny - wprost z modelu
+	if(Model)
+		return Model->GetEdgeWeight(Vertex1Index, Vertex2Index);
+
+	// Wiersz wierzchołka Vertex1Index
+	const EdgeIndex_t EdgeIndexBegin = EdgeOffsets[Vertex1Index];
+	const EdgeIndex_t EdgeIndexEnd = EdgeOffsets[Vertex1Index + 1];
+	const Neighbors_t Neighbors = { NeighborVertexIndexes + EdgeIndexBegin, EdgeWeights + EdgeIndexBegin, EdgeIndexEnd - EdgeIndexBegin };
+
+	// Sąsiedzi są posortowani - szukamy binarnie
+	const NeighborVertexIndex_t * NeighborVertexIndex = std::lower_bound(Neighbors.VertexIndexes, Neighbors.VertexIndexes + Neighbors.Size, Vertex2Index);
+
+	// Brak krawędzi
+	if(NeighborVertexIndex == Neighbors.VertexIndexes + Neighbors.Size || *NeighborVertexIndex != Vertex2Index)
+		return std::numeric_limits<EdgeWeight_t>::max();
+
+	// Pobierz wartość krawędzi
+	return Neighbors.EdgeWeights[NeighborVertexIndex - Neighbors.VertexIndexes];
+}
+
+const Graph::Neighbors_t Graph::GetNeighbors(const VertexIndex_t & VertexIndex, NeighborsBuffer_t & Buffer) const
+{
+	if(!Model)
+	{
+		const EdgeIndex_t EdgeIndexBegin = EdgeOffsets[VertexIndex];
+		const EdgeIndex_t EdgeIndexEnd = EdgeOffsets[VertexIndex + 1];
+
+		return {
+			NeighborVertexIndexes + EdgeIndexBegin,
+			EdgeWeights + EdgeIndexBegin,
+			EdgeIndexEnd - EdgeIndexBegin
+		};
+	}
+
+	// Graf niejawny - sąsiedzi w promieniu Radius wyliczani z modelu
+	const VertexId_t Radius = Model->GetRadius();
+
+	const VertexId_t Vertex1X = (VertexId_t) (VertexIndex % SideSize);
+	const VertexId_t Vertex1Y = (VertexId_t) (VertexIndex / SideSize);
+
+	const VertexId_t Vertex2XBegin = Vertex1X > Radius ? Vertex1X - Radius : 0;
+	const VertexId_t Vertex2XEnd = std::min<VertexId_t>(SideSize - 1, Vertex1X + Radius) + 1;
+	const VertexId_t Vertex2YBegin = Vertex1Y > Radius ? Vertex1Y - Radius : 0;
+	const VertexId_t Vertex2YEnd = std::min<VertexId_t>(SideSize - 1, Vertex1Y + Radius) + 1;
 
-	// Pobierz warto krawdzi
-	const EdgeWeight_t EdgeWeight = AdjascencyMatrix[Edge1Index];
+	// Wiersze, a w nich kolumny rosnąco - sąsiedzi posortowani po indeksie, tak jak w grafie CSR
+	size_t Size = 0;
+	for(VertexId_t Vertex2Y = Vertex2YBegin; Vertex2Y < Vertex2YEnd; Vertex2Y++)
+	{
+		for(VertexId_t Vertex2X = Vertex2XBegin; Vertex2X < Vertex2XEnd; Vertex2X++)
+		{
+			const VertexIndex_t Vertex2Index = (VertexIndex_t) SideSize * Vertex2Y + Vertex2X;
+
+			const EdgeWeight_t EdgeWeight = Model->GetEdgeWeight(VertexIndex, Vertex2Index);
+			if(EdgeWeight == std::numeric_limits<EdgeWeight_t>::max())
+				continue;
+
+			Buffer.VertexIndexes[Size] = (NeighborVertexIndex_t) Vertex2Index;
+			Buffer.EdgeWeights[Size] = EdgeWeight;
+			++Size;
+		}
+	}
+
+	return { Buffer.VertexIndexes.get(), Buffer.EdgeWeights.get(), Size };
+}
+
+Graph::NeighborsBuffer_t Graph::CreateNeighborsBuffer() const
+{
+	// Graf CSR nie potrzebuje bufora
+	VertexIndex_t Capacity = 0;
+
+	// Wszystkie wierzchołki kwadratu o boku 2 * Radius + 1 poza środkowym, nie więcej niż cały graf
+	if(Model)
+	{
+		const VertexIndex_t BoxSide = 2 * (VertexIndex_t) Model->GetRadius() + 1;
+		Capacity = std::min(GetSize() - 1, BoxSide * BoxSide - 1);
+	}
 
-	return EdgeWeight;
+	return {
+		std::unique_ptr<NeighborVertexIndex_t[]>(new NeighborVertexIndex_t[Capacity]),
+		std::unique_ptr<EdgeWeight_t[]>(new EdgeWeight_t[Capacity])
+	};
 }
 
 void Graph::GraphViz(std::ostream & Stream) const
@@ -45,37 +183,26 @@ void Graph::GraphViz(std::ostream & Stream) const
 		}
 	}
 
-	for(VertexId_t Vertex1Y = 0; Vertex1Y < SideSize; Vertex1Y++)
+	NeighborsBuffer_t Buffer = CreateNeighborsBuffer();
+	for(Graph::VertexIndex_t Vertex1Index = 0; Vertex1Index < GetSize(); Vertex1Index++)
 	{
-		for(VertexId_t Vertex1X = 0; Vertex1X < SideSize; Vertex1X++)
-		{
-			for(VertexId_t Vertex2Y = 0; Vertex2Y < SideSize; Vertex2Y++)
-			{
-				for(VertexId_t Vertex2X = 0; Vertex2X < SideSize; Vertex2X++)
-				{
-					// Pominicie krawdzi
-					if(Vertex2Y > Vertex1Y || (Vertex2Y == Vertex1Y && Vertex2X >= Vertex1X))
-						continue;
-
-					// Indeksy wierzchokw
-					const Graph::VertexIndex_t Vertex1Index = SideSize * Vertex1Y + Vertex1X;
-					const Graph::VertexIndex_t Vertex2Index = SideSize * Vertex2Y + Vertex2X;
+		const VertexId_t Vertex1X = (VertexId_t) (Vertex1Index % SideSize);
+		const VertexId_t Vertex1Y = (VertexId_t) (Vertex1Index / SideSize);
 
-					// Indeksy krawdzi
-					const size_t Edge1Index = SideSize * SideSize * Vertex2Index + Vertex1Index;
-					// const size_t Edge2Index = SideSize * SideSize * Vertex2Index + Vertex1Index;
+		const Neighbors_t Neighbors = GetNeighbors(Vertex1Index, Buffer);
+		for(size_t NeighborId = 0; NeighborId < Neighbors.Size; NeighborId++)
+		{
+			const Graph::VertexIndex_t Vertex2Index = Neighbors.VertexIndexes[NeighborId];
 
-					// Pobierz warto krawdzi
-					const EdgeWeight_t EdgeWeight = AdjascencyMatrix[Edge1Index];
+			// Pominięcie krawędzi - każdą rysujemy tylko raz. Sąsiedzi są posortowani, więc dalej są już tylko większe indeksy
+			if(Vertex2Index >= Vertex1Index)
+				break;
 
-					// Jeli krawd nie istneije - jedziemy dalej
-					if(EdgeWeight == std::numeric_limits<EdgeWeight_t>::max())
-						continue;
+			const VertexId_t Vertex2X = (VertexId_t) (Vertex2Index % SideSize);
+			const VertexId_t Vertex2Y = (VertexId_t) (Vertex2Index / SideSize);
 
-					// Dodaj definicj krawdzi
-					Stream << "\tx" << Vertex1X << "y" << Vertex1Y << " -- x" << Vertex2X << "y" << Vertex2Y << " [ label = \"" << (unsigned int) EdgeWeight << "\" ];\n";
-				}
-			}
+			// Dodaj definicję krawędzi
+			Stream << "\tx" << Vertex1X << "y" << Vertex1Y << " -- x" << Vertex2X << "y" << Vertex2Y << " [ label = \"" << (unsigned int) Neighbors.EdgeWeights[NeighborId] << "\" ];\n";
 		}
 	}
 	Stream << "}\n";
@@ -102,16 +229,12 @@ void Graph::DumpAdjascencyMatrix(std::ostream & Stream) const
 			{
 				for(VertexId_t Vertex2X = 0; Vertex2X < SideSize; Vertex2X++)
 				{
-					// Indeksy wierzchokw
+					// Indeksy wierzchołków
 					const Graph::VertexIndex_t Vertex1Index = SideSize * Vertex1Y + Vertex1X;
 					const Graph::VertexIndex_t Vertex2Index = SideSize * Vertex2Y + Vertex2X;
 
-					// Indeksy krawdzi
-					const size_t Edge1Index = SideSize * SideSize * Vertex2Index + Vertex1Index;
-					// const size_t Edge2Index = SideSize * SideSize * Vertex2Index + Vertex1Index;
-
-					// Pobierz warto krawdzi
-					const EdgeWeight_t EdgeWeight = AdjascencyMatrix[Edge1Index];
+					// Pobierz wartość krawędzi
+					const EdgeWeight_t EdgeWeight = GetEdgeWeight(Vertex1Index, Vertex2Index);
 
 					Stream << std::setw(8) << (int) EdgeWeight;
 				}
@@ -123,83 +246,181 @@ void Graph::DumpAdjascencyMatrix(std::ostream & Stream) const
 	Stream << "\n";
 }
 
-Graph Graph::GenerateWaxmanRandom(const VertexId_t & SideSize, const double & Alpha, const double & Beta, const EdgeWeight_t & EdgeWeightMin, const EdgeWeight_t & EdgeWeightMax)
+void Graph::Write(const std::string & Path) const
+{
+	if(Model)
+		throw std::invalid_argument("Graph is implicit");
+
+	GraphFile::Write(*this, Path);
+}
+
+Graph Graph::Load(const std::string & Path, const bool & HugePages, const bool & VerifyChecksum)
+{
+	// Mapowanie sprawdza poprawność pliku i żyje tak długo, jak graf (i jego kopie)
+	std::shared_ptr<const GraphFile> File = std::make_shared<const GraphFile>(Path, HugePages, VerifyChecksum);
+
+	const VertexId_t SideSize = File->GetHeader().SideSize;
+	const EdgeIndex_t * EdgeOffsets = File->GetEdgeOffsets();
+	const NeighborVertexIndex_t * NeighborVertexIndexes = File->GetNeighborVertexIndexes();
+	const EdgeWeight_t * EdgeWeights = File->GetEdgeWeights();
+
+	return Graph{ SideSize, EdgeOffsets, NeighborVertexIndexes, EdgeWeights, std::move(File) };
+}
+
+Graph Graph::Replicate() const
+{
+	if(Model)
+		return Graph(*Model);
+
+	const VertexIndex_t Size = GetSize();
+	const EdgeIndex_t EdgeCount = EdgeOffsets[Size];
+
+	EdgeOffsets_t EdgeOffsetsReplica(new EdgeIndex_t[Size + 1]);
+	NeighborVertexIndexes_t NeighborVertexIndexesReplica(new NeighborVertexIndex_t[EdgeCount]);
+	EdgeWeights_t EdgeWeightsReplica(new EdgeWeight_t[EdgeCount]);
+
+	std::copy(EdgeOffsets, EdgeOffsets + Size + 1, EdgeOffsetsReplica.get());
+	std::copy(NeighborVertexIndexes, NeighborVertexIndexes + EdgeCount, NeighborVertexIndexesReplica.get());
+	std::copy(EdgeWeights, EdgeWeights + EdgeCount, EdgeWeightsReplica.get());
+
+	return Graph(SideSize, std::move(EdgeOffsetsReplica), std::move(NeighborVertexIndexesReplica), std::move(EdgeWeightsReplica));
+}
+
+Graph Graph::GenerateWaxmanRandom(const VertexId_t & SideSize, const double & Alpha, const double & Beta, const EdgeWeight_t & EdgeWeightMin, const EdgeWeight_t & EdgeWeightMax, const uint64_t & Seed, const double & Epsilon, const size_t & ThreadNumber)
 {
-	// Sprawdzenie sensownoci parametrw generowania
-	if(SideSize <= 0)
-		throw std::invalid_argument("SideSize <= 0");
+	// Model sprawdza sensowność parametrów generowania
+	const WaxmanModel Model(SideSize, Alpha, Beta, EdgeWeightMin, EdgeWeightMax, Seed, Epsilon);
 
-	if(Alpha < 0 || Alpha > 1)
-		throw std::invalid_argument("Alpha < 0 || Alpha > 1");
+	return GenerateWaxmanRandom(Model, ThreadNumber);
+}
 
-	if(Beta < 0 || Beta > 1)
-		throw std::invalid_argument("Beta < 0 || Beta > 1");
+Graph Graph::GenerateWaxmanRandom(const WaxmanModel & Model, const size_t & ThreadNumber)
+{
+	const VertexId_t SideSize = Model.GetSideSize();
+	const VertexIndex_t Size = (VertexIndex_t) SideSize * SideSize;
 
-	if(EdgeWeightMin >= EdgeWeightMax || EdgeWeightMin <= 0 || EdgeWeightMax >= std::numeric_limits<EdgeWeight_t>::max())
-		throw std::invalid_argument("EdgeWeightMin >= EdgeWeightMax || EdgeWeightMin <= 0 || EdgeWeightMax >= std::numeric_limits<EdgeWeight_t>::max()");
+	// Poza promieniem obcięcia krawędzi nie ma
+	const VertexId_t Radius = Model.GetRadius();
 
-	// Macierz ssiedztwa
-	AdjascencyMatrix_t AdjascencyMatrix(new EdgeWeight_t[(SideSize * SideSize) * (SideSize * SideSize)]);
-	// std::fill(AdjascencyMatrix.get(), AdjascencyMatrix.get() + (SideSize * SideSize) * (SideSize * SideSize), 0);
+	// Wiersze dzielimy na bloki stałej wielkości, przydzielane wątkom dynamicznie
+	// Zawartość bloku zależy tylko od modelu, więc wynik nie zależy od liczby wątków
+	const VertexIndex_t BlockSize = 256;
+	const size_t BlockNumber = (Size + BlockSize - 1) / BlockSize;
 
-	// Traktujemy (VertexId1, VertexId2) jako (x, y)
-	const double VertexDistanceEuclideanMaximal = sqrt(2 * (SideSize * SideSize));
+	// Sąsiedzi o mniejszym indeksie (Vertex2Index < Vertex1Index) kolejnych wierszy bloku
+	struct Block_t
+	{
+		std::vector<NeighborVertexIndex_t> NeighborVertexIndexes;
+		std::vector<EdgeWeight_t> EdgeWeights;
+	};
+	std::vector<Block_t> Blocks(BlockNumber);
 
-	std::mt19937 RandomGenerator;
-	std::uniform_real_distribution<double> RDistribution(0.0, 1.0);
+	// Liczba sąsiadów o mniejszym indeksie dla każdego wiersza
+	std::unique_ptr<EdgeIndex_t[]> LowerCounts(new EdgeIndex_t[Size]);
 
-	for(Graph::VertexId_t Vertex1Y = 0; Vertex1Y < SideSize; Vertex1Y++)
+	std::atomic<size_t> BlockIdNext(0);
+	auto Worker = [&]()
 	{
-		for(Graph::VertexId_t Vertex1X = 0; Vertex1X < SideSize; Vertex1X++)
+		while(true)
 		{
-			// Brak krawdzi pomidzy tymi samymi punktami (na przektnej)
-			const Graph::VertexIndex_t VertexIndex = SideSize * Vertex1Y + Vertex1X;
-			const size_t EdgeIndex = SideSize * SideSize * VertexIndex + VertexIndex;
+			const size_t BlockId = BlockIdNext++;
+			if(BlockId >= BlockNumber)
+				break;
 
-			AdjascencyMatrix[EdgeIndex] = std::numeric_limits<Graph::EdgeWeight_t>::max();;
+			Block_t & Block = Blocks[BlockId];
 
-			for(Graph::VertexId_t Vertex2Y = 0; Vertex2Y < SideSize; Vertex2Y++)
+			const VertexIndex_t Vertex1IndexEnd = std::min(Size, (BlockId + 1) * BlockSize);
+			for(VertexIndex_t Vertex1Index = BlockId * BlockSize; Vertex1Index < Vertex1IndexEnd; Vertex1Index++)
 			{
-				for(Graph::VertexId_t Vertex2X = 0; Vertex2X < SideSize; Vertex2X++)
+				EdgeIndex_t LowerCount = 0;
+
+				const VertexId_t Vertex1X = (VertexId_t) (Vertex1Index % SideSize);
+				const VertexId_t Vertex1Y = (VertexId_t) (Vertex1Index / SideSize);
+
+				// Mniejsze indeksy w promieniu Radius - wiersze od Vertex1Y - Radius do Vertex1Y, rosnąco
+				const VertexId_t Vertex2YBegin = Vertex1Y > Radius ? Vertex1Y - Radius : 0;
+				const VertexId_t Vertex2XBegin = Vertex1X > Radius ? Vertex1X - Radius : 0;
+				const VertexId_t Vertex2XEnd = std::min<VertexId_t>(SideSize - 1, Vertex1X + Radius) + 1;
+
+				for(VertexId_t Vertex2Y = Vertex2YBegin; Vertex2Y <= Vertex1Y; Vertex2Y++)
 				{
-					// Pominicie krawdzi
-					if(Vertex2Y > Vertex1Y || (Vertex2Y == Vertex1Y && Vertex2X >= Vertex1X))
-						continue;
+					for(VertexId_t Vertex2X = Vertex2XBegin; Vertex2X < Vertex2XEnd; Vertex2X++)
+					{
+						const VertexIndex_t Vertex2Index = (VertexIndex_t) SideSize * Vertex2Y + Vertex2X;
+
+						// Pominięcie krawędzi
+						if(Vertex2Index >= Vertex1Index)
+							break;
+
+						const EdgeWeight_t EdgeWeight = Model.GetEdgeWeight(Vertex1Index, Vertex2Index);
+						if(EdgeWeight == std::numeric_limits<EdgeWeight_t>::max())
+							continue;
+
+						Block.NeighborVertexIndexes.push_back((NeighborVertexIndex_t) Vertex2Index);
+						Block.EdgeWeights.push_back(EdgeWeight);
+						++LowerCount;
+					}
+				}
 
-					// Odlego pomidzy dwoma wierzchokami
-					const double VertexDistanceX = 1.0 * Vertex2X - 1.0 * Vertex1X;
-					const double VertexDistanceY = 1.0 * Vertex2Y - 1.0 * Vertex1Y;
-					const double VertexDistanceEuclidean = sqrt(VertexDistanceX * VertexDistanceX + VertexDistanceY * VertexDistanceY);
+				LowerCounts[Vertex1Index] = LowerCount;
+			}
+		}
+	};
 
-					// Formua Waxmana - prawdopodobiestwo ssiedzstwa VertexId1, VertexId2
-					const double AdjascencyProbability = Alpha * exp((-1.0 * VertexDistanceEuclidean) / (Beta * VertexDistanceEuclideanMaximal));
+	// Jeśli użytkownik nie podał liczby wątków - dobieramy automatycznie
+	const size_t ThreadNumberReal = std::max<size_t>(1, std::min<size_t>(ThreadNumber ? ThreadNumber : std::thread::hardware_concurrency(), BlockNumber));
 
-					// Czy krawd istnieje?
-					const bool EdgeExists = (AdjascencyProbability) >= RDistribution(RandomGenerator);
+	std::vector<std::thread> Threads;
+	for(size_t ThreadId = 1; ThreadId < ThreadNumberReal; ThreadId++)
+		Threads.emplace_back(Worker);
+	Worker();
+	for(std::thread & Thread : Threads)
+		Thread.join();
 
-					// Indeksy wierzchokw
-					const Graph::VertexIndex_t Vertex1Index = SideSize * Vertex1Y + Vertex1X;
-					const Graph::VertexIndex_t Vertex2Index = SideSize * Vertex2Y + Vertex2X;
+	// Stopnie wierzchołków -> przesunięcia wierszy
+	EdgeOffsets_t EdgeOffsets(new EdgeIndex_t[Size + 1]);
+	EdgeOffsets[0] = 0;
+	std::copy(LowerCounts.get(), LowerCounts.get() + Size, EdgeOffsets.get() + 1);
 
-					// Indeksy krawdzi
-					const size_t Edge1Index = SideSize * SideSize * Vertex2Index + Vertex1Index;
-					const size_t Edge2Index = SideSize * SideSize * Vertex1Index + Vertex2Index;
+	for(const Block_t & Block : Blocks)
+		for(const NeighborVertexIndex_t & Vertex2Index : Block.NeighborVertexIndexes)
+			++EdgeOffsets[Vertex2Index + 1];
 
-					// Domylnie brak krawdzi = maksymalna dostpna waga
-					Graph::EdgeWeight_t EdgeWeight = std::numeric_limits<Graph::EdgeWeight_t>::max();
+	std::partial_sum(EdgeOffsets.get(), EdgeOffsets.get() + Size + 1, EdgeOffsets.get());
 
-					// Krawd istnieje - ustawiamy losow wag z zakresu [EdgeWeightMin, EdgeWeightMax]
-					if(EdgeExists)
-						EdgeWeight = EdgeWeightMin + (Graph::EdgeWeight_t) (RDistribution(RandomGenerator) * (EdgeWeightMax - EdgeWeightMin));
+	NeighborVertexIndexes_t NeighborVertexIndexes(new NeighborVertexIndex_t[EdgeOffsets[Size]]);
+	EdgeWeights_t EdgeWeights(new EdgeWeight_t[EdgeOffsets[Size]]);
 
-					// Wpisujemy dane do macierzy
-					AdjascencyMatrix[Edge1Index] = EdgeWeight;
-					AdjascencyMatrix[Edge2Index] = EdgeWeight;
-				}
+	// Wypełnianie wierszy
+	// Przechodzimy wiersze rosnąco: wiersz V dostaje najpierw swoich mniejszych sąsiadów (rosnąco), a później - przy kolejnych, większych wierszach - większych (również rosnąco).
+	// Wiersze są więc posortowane bez dodatkowego sortowania
+	std::unique_ptr<EdgeIndex_t[]> EdgeCursors(new EdgeIndex_t[Size]);
+	std::copy(EdgeOffsets.get(), EdgeOffsets.get() + Size, EdgeCursors.get());
+
+	for(size_t BlockId = 0; BlockId < BlockNumber; BlockId++)
+	{
+		const Block_t & Block = Blocks[BlockId];
+		size_t BlockEdgeId = 0;
+
+		const VertexIndex_t Vertex1IndexEnd = std::min(Size, (BlockId + 1) * BlockSize);
+		for(VertexIndex_t Vertex1Index = BlockId * BlockSize; Vertex1Index < Vertex1IndexEnd; Vertex1Index++)
+		{
+			for(EdgeIndex_t LowerId = 0; LowerId < LowerCounts[Vertex1Index]; LowerId++, BlockEdgeId++)
+			{
+				const NeighborVertexIndex_t Vertex2Index = Block.NeighborVertexIndexes[BlockEdgeId];
+				const EdgeWeight_t EdgeWeight = Block.EdgeWeights[BlockEdgeId];
+
+				const EdgeIndex_t Edge1Index = EdgeCursors[Vertex1Index]++;
+				NeighborVertexIndexes[Edge1Index] = Vertex2Index;
+				EdgeWeights[Edge1Index] = EdgeWeight;
+
+				const EdgeIndex_t Edge2Index = EdgeCursors[Vertex2Index]++;
+				NeighborVertexIndexes[Edge2Index] = (NeighborVertexIndex_t) Vertex1Index;
+				EdgeWeights[Edge2Index] = EdgeWeight;
 			}
 		}
 	}
 
 	// Zwracamy docelowy obiekt grafu
-	return Graph{ SideSize, std::move(AdjascencyMatrix) };
+	return Graph{ SideSize, std::move(EdgeOffsets), std::move(NeighborVertexIndexes), std::move(EdgeWeights) };
 }
\ No newline at end of file
@@ -1,37 +1,120 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <ostream>
+#include <string>
+
+class WaxmanModel;
+class GraphFile;
 
 /*
 	Klasa reprezentuje `kwadratowy` nieskierowany graf o rozmiarze SideSize * SideSize
+
+	Krawędzie przechowywane są w formacie CSR (compressed sparse row):
+		- EdgeOffsets - dla każdego wierzchołka indeks pierwszej krawędzi w tablicach NeighborVertexIndexes / EdgeWeights (+ wartownik na końcu)
+		- NeighborVertexIndexes - indeksy sąsiadów, w obrębie jednego wierzchołka posortowane rosnąco
+		- EdgeWeights - wagi odpowiadających krawędzi
+	Każda krawędź nieskierowana zapisana jest dwukrotnie - raz w wierszu każdego z końców.
+	Tablice mogą należeć do grafu (sterta) albo pochodzić z pliku zmapowanego do pamięci (Load) - kopie grafu współdzielą tę samą pamięć.
+
+	Graf może być też niejawny (implicit) - bez żadnych tablic krawędzi. Istnienie i waga krawędzi wyliczane są wtedy na żądanie z modelu (WaxmanModel),
+	a zajętość pamięci zależy tylko od promienia obcięcia modelu (Epsilon > 0), nie od rozmiaru grafu. Oba rodzaje grafu obsługiwane są tym samym interfejsem i dają identyczne wyniki dla tego samego modelu.
 */
 class Graph
 {
 	public:
-		// Id wierzchoka
+		// Id wierzchołka
 		typedef unsigned int VertexId_t;
 
-		// Indeks wierzchoka w wektorze / tablicy
+		// Indeks wierzchołka w wektorze / tablicy
 		typedef size_t VertexIndex_t;
 
-		// Waga krawdzi
+		// Indeks wierzchołka przechowywany w tablicy sąsiadów. Krótszy typ - połowa pamięci na krawędź
+		typedef uint32_t NeighborVertexIndex_t;
+
+		// Indeks krawędzi w tablicach NeighborVertexIndexes / EdgeWeights
+		typedef size_t EdgeIndex_t;
+
+		// Waga krawędzi
+		// Ponieważ celem zadania jest minimalizacja sumarycznej wagi ścieżki, brak krawędzi reprezentowany jest przez std::numeric_limits<EdgeWeight_t>::max()
 		typedef uint8_t EdgeWeight_t;
 
-		// Macierz ssiedztwa zawierajca wagi poszczeglnych krawdzi
-		// Poniewa celem zadania jest minimalizacja sumarycznej wagi cieki, brak krawdzi reprezentowany jest przez std::numeric_limits<EdgeWeight_t>::max()
-		typedef std::unique_ptr<Graph::EdgeWeight_t[]> AdjascencyMatrix_t; /* (SideSize * SideSize) * (SideSize * SideSize) */
+		// Tablice CSR
+		typedef std::unique_ptr<EdgeIndex_t[]> EdgeOffsets_t; /* SideSize * SideSize + 1 */
+		typedef std::unique_ptr<NeighborVertexIndex_t[]> NeighborVertexIndexes_t; /* EdgeOffsets[SideSize * SideSize] */
+		typedef std::unique_ptr<EdgeWeight_t[]> EdgeWeights_t; /* EdgeOffsets[SideSize * SideSize] */
+
+		/*
+			Widok na sąsiadów pojedynczego wierzchołka.
+			Dla grafu CSR wskazuje bezpośrednio na ciągły fragment tablic CSR, ważny tak długo jak graf.
+			Dla grafu niejawnego wskazuje na NeighborsBuffer_t, ważny do następnego GetNeighbors z tym samym buforem.
+		*/
+		struct Neighbors_t
+		{
+			const NeighborVertexIndex_t * VertexIndexes;
+			const EdgeWeight_t * EdgeWeights;
+			size_t Size;
+		};
+
+		/*
+			Bufor na sąsiadów jednego wierzchołka grafu niejawnego (CreateNeighborsBuffer).
+			Jeden bufor na wątek - GetNeighbors nie wykonuje wtedy żadnych alokacji.
+		*/
+		struct NeighborsBuffer_t
+		{
+			std::unique_ptr<NeighborVertexIndex_t[]> VertexIndexes;
+			std::unique_ptr<EdgeWeight_t[]> EdgeWeights;
+		};
 
 	public:
 		/*
-			SideSize - dugo boku (graf jest kwadratowy)
-			AdjascencyMatrix - macierz SideSize ^ 4 z wagami bokw
+			SideSize - długość boku (graf jest kwadratowy)
+			EdgeOffsets, NeighborVertexIndexes, EdgeWeights - tablice CSR opisane wyżej
+		*/
+		Graph(const VertexId_t & SideSize, EdgeOffsets_t && EdgeOffsets, NeighborVertexIndexes_t && NeighborVertexIndexes, EdgeWeights_t && EdgeWeights);
+
+		/*
+			Graf niejawny
+
+			Model - model, z którego wyliczane są krawędzie. Graf przechowuje własną kopię.
+				Model musi mieć Epsilon > 0 - bez obcięcia promień obejmuje cały graf i każde GetNeighbors przegląda O(V) par
 		*/
-		Graph(const VertexId_t & SideSize, AdjascencyMatrix_t && AdjascencyMatrix);
+		Graph(const WaxmanModel & Model);
+
+	private:
+		/*
+			Graf CSR na cudzej pamięci
+
+			Storage - właściciel pamięci tablic (np. zmapowany plik), zwalniany razem z ostatnią kopią grafu
+		*/
+		Graph(const VertexId_t & SideSize, const EdgeIndex_t * EdgeOffsets, const NeighborVertexIndex_t * NeighborVertexIndexes, const EdgeWeight_t * EdgeWeights, std::shared_ptr<const void> && Storage);
+
+		// Zapis tablic CSR do pliku
+		friend class GraphFile;
+
+		// Położenie stron tablic CSR na węzłach NUMA
+		friend class NumaPlacement;
 
 	private:
 		VertexId_t SideSize;
-		AdjascencyMatrix_t AdjascencyMatrix;
+
+		/*
+			Tablice CSR, nullptr dla grafu niejawnego
+		*/
+		const EdgeIndex_t * EdgeOffsets;
+		const NeighborVertexIndex_t * NeighborVertexIndexes;
+		const EdgeWeight_t * EdgeWeights;
+
+		/*
+			Właściciel pamięci tablic CSR
+		*/
+		std::shared_ptr<const void> Storage;
+
+		/*
+			Model grafu niejawnego, nullptr dla grafu CSR
+		*/
+		std::shared_ptr<const WaxmanModel> Model;
 
 	public:
 		/*
@@ -40,34 +123,103 @@ class Graph
 		const VertexId_t & GetSideSize() const;
 
 		/*
-			Rozmiar grafu (w sensie liczby wierzchokw)
+			Rozmiar grafu (w sensie liczby wierzchołków)
 		*/
 		const VertexIndex_t GetSize() const;
 
+		/*
+			Liczba wpisów w tablicach CSR (każda krawędź nieskierowana liczona dwukrotnie)
+			Dla grafu niejawnego liczona przez przejście wszystkich wierzchołków - O(V * Radius^2)
+		*/
+		const EdgeIndex_t GetEdgeCount() const;
+
+		/*
+			Czy graf jest niejawny
+		*/
+		bool IsImplicit() const;
+
+		/*
+			Pamięć zajmowana przez krawędzie grafu (tablice CSR lub model) w bajtach
+		*/
+		size_t GetFootprint() const;
+
 	public:
+		/*
+			Waga krawędzi pomiędzy wierzchołkami lub std::numeric_limits<EdgeWeight_t>::max() jeśli krawędź nie istnieje.
+			Wyszukiwanie binarne w wierszu Vertex1Index, dla grafu niejawnego - bezpośrednio z modelu.
+		*/
 		const EdgeWeight_t GetEdgeWeight(const VertexIndex_t & Vertex1Index, const VertexIndex_t & Vertex2Index) const;
 
+		/*
+			Sąsiedzi wierzchołka, posortowani rosnąco po indeksie
+
+			Buffer - bufor utworzony przez CreateNeighborsBuffer() tego grafu. Graf CSR z niego nie korzysta
+		*/
+		const Neighbors_t GetNeighbors(const VertexIndex_t & VertexIndex, NeighborsBuffer_t & Buffer) const;
+
+		/*
+			Bufor mieszczący sąsiadów dowolnego wierzchołka (pusty dla grafu CSR)
+		*/
+		NeighborsBuffer_t CreateNeighborsBuffer() const;
+
 	public:
 		/*
-			Generuje posta grafu ktr mona zwizualizow.
+			Generuje postać grafu którą można zwizualizowć.
 			https://dreampuf.github.io/GraphvizOnline/
-			naley wybra Engine: fdp
+			należy wybrać Engine: fdp
 		*/
 		void GraphViz(std::ostream & Stream) const;
 
 		/*
-			Rysuje graficzn reprezentacj macierzy ssiedztwa
+			Rysuje graficzną reprezentację macierzy sąsiedztwa
 		*/
 		void DumpAdjascencyMatrix(std::ostream & Stream) const;
 
 	public:
 		/*
-			Generowanie grafu metod Waxman'a.
+			Zapis grafu CSR w binarnym formacie GraphFile. Plik zapisywany jest pod nazwą tymczasową i podmieniany na końcu,
+			więc procesy mapujące poprzednią wersję pliku nie widzą zapisu w połowie.
+			Graf niejawny nie ma tablic do zapisania - std::invalid_argument
+		*/
+		void Write(const std::string & Path) const;
+
+		/*
+			Odczyt grafu z pliku zapisanego przez Write. Plik mapowany jest do pamięci tylko do odczytu, bez kopiowania -
+			start jest niemal natychmiastowy, a procesy korzystające z tego samego pliku dzielą strony pamięci podręcznej systemu.
+
+			HugePages - prośba o duże strony dla mapowania (Linux, madvise). Bez gwarancji, nie wpływa na wynik
+			VerifyChecksum - sprawdzenie sumy kontrolnej tablic. Wymaga przeczytania całego pliku
+
+			Błędny lub niepasujący plik - std::runtime_error
+		*/
+		static Graph Load(const std::string & Path, const bool & HugePages, const bool & VerifyChecksum);
+
+		/*
+			Kopia grafu z własnymi tablicami CSR (również dla grafu z pliku), zaalokowanymi i wypełnionymi przez wątek wywołujący.
+			Przy domyślnej polityce pamięci Linux (first touch) tablice trafiają na węzeł NUMA tego wątku - NumaPlacement tworzy tak kopię grafu dla każdego węzła.
+			Graf niejawny kopiuje tylko model
+		*/
+		Graph Replicate() const;
+
+	public:
+		/*
+			Generowanie grafu metodą Waxman'a.
 
-			SideSize - dugo boku kwadratowego grafu
-			Parametry Alpha i Beta w zakresie 0.0 - 1.0 steruj prawdopodobiestwem pojawienia si krawdzi pomidzy dwoma punktami.
-			EdgeWeightMin, EdgeWeightMax - minimalna i maksymalna waga krawdzi
+			SideSize - długość boku kwadratowego grafu
+			Parametry Alpha i Beta w zakresie 0.0 - 1.0 sterują prawdopodobieństwem pojawienia się krawędzi pomiędzy dwoma punktami.
+			EdgeWeightMin, EdgeWeightMax - minimalna i maksymalna waga krawędzi
+			Seed - wartość inicjująca generator. Ten sam Seed (i parametry) daje zawsze identyczny graf
+			Epsilon - próg obcięcia modelu (WaxmanModel). 0 - graf dokładny, większe wartości pomijają odległe pary o znikomym prawdopodobieństwie krawędzi
+			ThreadNumber - liczba wątków generujących. Podanie 0 spowoduje automatyczne ustalenie wartości na podstawie hardware concurency. Nie wpływa na wynik
+
+			Krawędzie losowane są generatorem licznikowym (WaxmanModel), wiersze grafu generowane są równolegle.
+		*/
+		static Graph GenerateWaxmanRandom(const VertexId_t & SideSize, const double & Alpha, const double & Beta, const EdgeWeight_t & EdgeWeightMin, const EdgeWeight_t & EdgeWeightMax, const uint64_t & Seed, const double & Epsilon, const size_t & ThreadNumber);
+
+		/*
+			Jak wyżej, dla gotowego modelu - pozwala odczytać z modelu np. pominiętą masę prawdopodobieństwa.
+			Dla każdego wierzchołka sprawdzane są tylko pary w promieniu Model.GetRadius().
 		*/
-		static Graph GenerateWaxmanRandom(const VertexId_t & SideSize, const double & Alpha, const double & Beta, const EdgeWeight_t & EdgeWeightMin, const EdgeWeight_t & EdgeWeightMax);
+		static Graph GenerateWaxmanRandom(const WaxmanModel & Model, const size_t & ThreadNumber);
 };
 
@@ -0,0 +1,304 @@
+#include "GraphFile.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(_WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace
+{
+	const char Magic[8] = { 'P', 's', 'o', 'S', 'p', 'p', 'G', '\0' };
+	const uint32_t ByteOrder = 0x01020304;
+
+	const uint64_t ChecksumBasis = 0xCBF29CE484222325ull;
+	const uint64_t ChecksumPrime = 0x100000001B3ull;
+
+	// Zaokrąglenie położenia w pliku w górę do granicy sekcji
+	uint64_t AlignSection(const uint64_t & Offset)
+	{
+		return (Offset + GraphFile::SectionAlignment - 1) / GraphFile::SectionAlignment * GraphFile::SectionAlignment;
+	}
+
+	// Koniec sekcji Count elementów o rozmiarze ElementSize od położenia Offset. Zwraca false, jeśli koniec nie mieści się w uint64_t (nagłówek spreparowany)
+	bool CalculateSectionEnd(const uint64_t & Offset, const uint64_t & Count, const uint64_t & ElementSize, uint64_t & End)
+	{
+		if(Count > (std::numeric_limits<uint64_t>::max() - Offset) / ElementSize)
+			return false;
+
+		End = Offset + Count * ElementSize;
+		return true;
+	}
+
+	// Dopisuje zera do strumienia aż do położenia Offset
+	void Pad(std::ostream & Stream, const uint64_t & Offset)
+	{
+		static const char Zeros[GraphFile::SectionAlignment] = {};
+		const uint64_t Position = (uint64_t) Stream.tellp();
+		Stream.write(Zeros, (std::streamsize) (Offset - Position));
+	}
+}
+
+static_assert(std::is_trivially_copyable<GraphFile::Header_t>::value, "GraphFile::Header_t must be trivially copyable");
+static_assert(sizeof(GraphFile::Header_t) <= GraphFile::SectionAlignment, "GraphFile::Header_t must fit before the first section");
+
+GraphFile::GraphFile(const std::string & Path, const bool & HugePages, const bool & VerifyChecksum):
+	Data(nullptr), Size(0)
+{
+#if defined(_WIN32)
+	// Duże strony dla mapowań plików nie są dostępne w Windows - HugePages jest ignorowane
+	(void) HugePages;
+
+	const HANDLE FileHandle = CreateFileA(Path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if(FileHandle == INVALID_HANDLE_VALUE)
+		throw std::runtime_error("Cannot open graph file: " + Path);
+
+	LARGE_INTEGER FileSize;
+	if(!GetFileSizeEx(FileHandle, &FileSize) || FileSize.QuadPart == 0)
+	{
+		CloseHandle(FileHandle);
+		throw std::runtime_error("Cannot read graph file size: " + Path);
+	}
+	Size = (size_t) FileSize.QuadPart;
+
+	const HANDLE MappingHandle = CreateFileMappingA(FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(FileHandle);
+	if(MappingHandle == nullptr)
+		throw std::runtime_error("Cannot map graph file: " + Path);
+
+	// Widok utrzymuje mapowanie - uchwyt można od razu zamknąć
+	Data = static_cast<const uint8_t *>(MapViewOfFile(MappingHandle, FILE_MAP_READ, 0, 0, 0));
+	CloseHandle(MappingHandle);
+	if(Data == nullptr)
+		throw std::runtime_error("Cannot map graph file: " + Path);
+#else
+	const int FileDescriptor = open(Path.c_str(), O_RDONLY);
+	if(FileDescriptor < 0)
+		throw std::runtime_error("Cannot open graph file: " + Path);
+
+	struct stat FileStat;
+	if(fstat(FileDescriptor, &FileStat) != 0 || FileStat.st_size == 0)
+	{
+		close(FileDescriptor);
+		throw std::runtime_error("Cannot read graph file size: " + Path);
+	}
+	Size = (size_t) FileStat.st_size;
+
+	// Mapowanie współdzielone - strony pamięci podręcznej pliku są wspólne dla wszystkich procesów
+	void * Mapping = mmap(nullptr, Size, PROT_READ, MAP_SHARED, FileDescriptor, 0);
+	close(FileDescriptor);
+	if(Mapping == MAP_FAILED)
+		throw std::runtime_error("Cannot map graph file: " + Path);
+
+	Data = static_cast<const uint8_t *>(Mapping);
+
+	#if defined(MADV_HUGEPAGE)
+		// Transparent huge pages dla pamięci podręcznej pliku - jądro może odmówić, wtedy zostają zwykłe strony
+		if(HugePages)
+			madvise(Mapping, Size, MADV_HUGEPAGE);
+	#else
+		(void) HugePages;
+	#endif
+#endif
+
+	// Od tego miejsca mapowanie jest już własnością obiektu - przy błędzie trzeba je zwolnić ręcznie, destruktor nie zostanie wywołany
+	try
+	{
+		if(Size < sizeof(Header_t))
+			throw std::runtime_error("Graph file too small: " + Path);
+
+		const Header_t & Header = GetHeader();
+
+		if(std::memcmp(Header.Magic, Magic, sizeof(Magic)) != 0)
+			throw std::runtime_error("Not a graph file: " + Path);
+
+		if(Header.Version != Version)
+			throw std::runtime_error("Unsupported graph file version: " + Path);
+
+		if(Header.ByteOrder != ByteOrder || Header.EdgeIndexSize != sizeof(Graph::EdgeIndex_t) || Header.NeighborVertexIndexSize != sizeof(Graph::NeighborVertexIndex_t) || Header.EdgeWeightSize != sizeof(Graph::EdgeWeight_t))
+			throw std::runtime_error("Graph file layout does not match this build: " + Path);
+
+		if(Header.SideSize == 0 || (uint64_t) Header.SideSize * Header.SideSize > (uint64_t) std::numeric_limits<int32_t>::max())
+			throw std::runtime_error("Graph file SideSize out of range: " + Path);
+
+		// Sekcje muszą być wyrównane, leżeć w pliku i nie nachodzić na siebie
+		const uint64_t VertexNumber = (uint64_t) Header.SideSize * Header.SideSize;
+		uint64_t EdgeOffsetsEnd = 0;
+		uint64_t NeighborVertexIndexesEnd = 0;
+		uint64_t EdgeWeightsEnd = 0;
+
+		if(!CalculateSectionEnd(Header.EdgeOffsetsOffset, VertexNumber + 1, sizeof(Graph::EdgeIndex_t), EdgeOffsetsEnd)
+			|| !CalculateSectionEnd(Header.NeighborVertexIndexesOffset, Header.EdgeCount, sizeof(Graph::NeighborVertexIndex_t), NeighborVertexIndexesEnd)
+			|| !CalculateSectionEnd(Header.EdgeWeightsOffset, Header.EdgeCount, sizeof(Graph::EdgeWeight_t), EdgeWeightsEnd)
+			|| Header.FileSize != Size
+			|| Header.EdgeOffsetsOffset % SectionAlignment != 0 || Header.NeighborVertexIndexesOffset % SectionAlignment != 0 || Header.EdgeWeightsOffset % SectionAlignment != 0
+			|| Header.EdgeOffsetsOffset < sizeof(Header_t) || EdgeOffsetsEnd > Header.NeighborVertexIndexesOffset || NeighborVertexIndexesEnd > Header.EdgeWeightsOffset || EdgeWeightsEnd > Size)
+			throw std::runtime_error("Graph file truncated or corrupted: " + Path);
+
+		/*
+			Spójność CSR - zawsze, niezależnie od sumy kontrolnej, bo GetNeighbors i dekodowanie ufają tablicom bez sprawdzania zakresów.
+			O(V + E): przesunięcia rosną od 0 do EdgeCount, sąsiedzi są wierzchołkami grafu, w obrębie wiersza posortowani rosnąco
+		*/
+		const Graph::EdgeIndex_t * EdgeOffsets = GetEdgeOffsets();
+		const Graph::NeighborVertexIndex_t * NeighborVertexIndexes = GetNeighborVertexIndexes();
+
+		if(EdgeOffsets[0] != 0 || EdgeOffsets[VertexNumber] != Header.EdgeCount)
+			throw std::runtime_error("Graph file truncated or corrupted: " + Path);
+
+		for(uint64_t VertexIndex = 0; VertexIndex < VertexNumber; VertexIndex++)
+		{
+			// Górna granica przed przejściem wiersza - przesunięcie za EdgeCount wykryte dopiero przy następnym wierzchołku oznaczałoby już odczyt poza tablicą
+			if(EdgeOffsets[VertexIndex] > EdgeOffsets[VertexIndex + 1] || EdgeOffsets[VertexIndex + 1] > Header.EdgeCount)
+				throw std::runtime_error("Graph file corrupted (edge offsets not monotonic or out of range): " + Path);
+
+			for(Graph::EdgeIndex_t EdgeIndex = EdgeOffsets[VertexIndex]; EdgeIndex < EdgeOffsets[VertexIndex + 1]; EdgeIndex++)
+			{
+				if(NeighborVertexIndexes[EdgeIndex] >= VertexNumber || (EdgeIndex > EdgeOffsets[VertexIndex] && NeighborVertexIndexes[EdgeIndex] <= NeighborVertexIndexes[EdgeIndex - 1]))
+					throw std::runtime_error("Graph file corrupted (neighbor vertex index out of range or unsorted): " + Path);
+			}
+		}
+
+		if(VerifyChecksum)
+		{
+			uint64_t Checksum = ChecksumBasis;
+			Checksum = CalculateChecksum(Data + Header.EdgeOffsetsOffset, EdgeOffsetsEnd - Header.EdgeOffsetsOffset, Checksum);
+			Checksum = CalculateChecksum(Data + Header.NeighborVertexIndexesOffset, NeighborVertexIndexesEnd - Header.NeighborVertexIndexesOffset, Checksum);
+			Checksum = CalculateChecksum(Data + Header.EdgeWeightsOffset, EdgeWeightsEnd - Header.EdgeWeightsOffset, Checksum);
+
+			if(Checksum != Header.Checksum)
+				throw std::runtime_error("Graph file checksum mismatch: " + Path);
+		}
+	}
+	catch(...)
+	{
+		Unmap();
+		throw;
+	}
+}
+
+GraphFile::~GraphFile()
+{
+	Unmap();
+}
+
+void GraphFile::Unmap()
+{
+	if(Data == nullptr)
+		return;
+
+#if defined(_WIN32)
+	UnmapViewOfFile(Data);
+#else
+	munmap(const_cast<uint8_t *>(Data), Size);
+#endif
+
+	Data = nullptr;
+}
+
+const GraphFile::Header_t & GraphFile::GetHeader() const
+{
+	return *reinterpret_cast<const Header_t *>(Data);
+}
+
+const Graph::EdgeIndex_t * GraphFile::GetEdgeOffsets() const
+{
+	return reinterpret_cast<const Graph::EdgeIndex_t *>(Data + GetHeader().EdgeOffsetsOffset);
+}
+
+const Graph::NeighborVertexIndex_t * GraphFile::GetNeighborVertexIndexes() const
+{
+	return reinterpret_cast<const Graph::NeighborVertexIndex_t *>(Data + GetHeader().NeighborVertexIndexesOffset);
+}
+
+const Graph::EdgeWeight_t * GraphFile::GetEdgeWeights() const
+{
+	return reinterpret_cast<const Graph::EdgeWeight_t *>(Data + GetHeader().EdgeWeightsOffset);
+}
+
+void GraphFile::Write(const Graph & G, const std::string & Path)
+{
+	const uint64_t VertexNumber = G.GetSize();
+	const uint64_t EdgeCount = G.GetEdgeCount();
+
+	const uint64_t EdgeOffsetsSize = (VertexNumber + 1) * sizeof(Graph::EdgeIndex_t);
+	const uint64_t NeighborVertexIndexesSize = EdgeCount * sizeof(Graph::NeighborVertexIndex_t);
+	const uint64_t EdgeWeightsSize = EdgeCount * sizeof(Graph::EdgeWeight_t);
+
+	Header_t Header = {};
+	std::memcpy(Header.Magic, Magic, sizeof(Magic));
+	Header.Version = Version;
+	Header.ByteOrder = ByteOrder;
+	Header.SideSize = G.GetSideSize();
+	Header.EdgeIndexSize = sizeof(Graph::EdgeIndex_t);
+	Header.NeighborVertexIndexSize = sizeof(Graph::NeighborVertexIndex_t);
+	Header.EdgeWeightSize = sizeof(Graph::EdgeWeight_t);
+	Header.EdgeCount = EdgeCount;
+	Header.EdgeOffsetsOffset = AlignSection(sizeof(Header_t));
+	Header.NeighborVertexIndexesOffset = AlignSection(Header.EdgeOffsetsOffset + EdgeOffsetsSize);
+	Header.EdgeWeightsOffset = AlignSection(Header.NeighborVertexIndexesOffset + NeighborVertexIndexesSize);
+	Header.FileSize = Header.EdgeWeightsOffset + EdgeWeightsSize;
+
+	Header.Checksum = ChecksumBasis;
+	Header.Checksum = CalculateChecksum(G.EdgeOffsets, EdgeOffsetsSize, Header.Checksum);
+	Header.Checksum = CalculateChecksum(G.NeighborVertexIndexes, NeighborVertexIndexesSize, Header.Checksum);
+	Header.Checksum = CalculateChecksum(G.EdgeWeights, EdgeWeightsSize, Header.Checksum);
+
+	// Zapis do pliku tymczasowego
+	const std::string PathTemporary = Path + ".tmp";
+	{
+		std::ofstream Stream(PathTemporary, std::ios::binary | std::ios::trunc);
+		if(!Stream)
+			throw std::runtime_error("Cannot create graph file: " + PathTemporary);
+
+		Stream.write(reinterpret_cast<const char *>(&Header), sizeof(Header));
+
+		Pad(Stream, Header.EdgeOffsetsOffset);
+		Stream.write(reinterpret_cast<const char *>(G.EdgeOffsets), (std::streamsize) EdgeOffsetsSize);
+
+		Pad(Stream, Header.NeighborVertexIndexesOffset);
+		Stream.write(reinterpret_cast<const char *>(G.NeighborVertexIndexes), (std::streamsize) NeighborVertexIndexesSize);
+
+		Pad(Stream, Header.EdgeWeightsOffset);
+		Stream.write(reinterpret_cast<const char *>(G.EdgeWeights), (std::streamsize) EdgeWeightsSize);
+
+		Stream.close();
+		if(!Stream)
+			throw std::runtime_error("Cannot write graph file: " + PathTemporary);
+	}
+
+	// Podmiana pliku - procesy, które zmapowały poprzednią wersję, zachowują ją do końca
+	std::filesystem::rename(PathTemporary, Path);
+}
+
+uint64_t GraphFile::CalculateChecksum(const void * Data, const uint64_t & Size, const uint64_t & Checksum)
+{
+	const uint8_t * Bytes = static_cast<const uint8_t *>(Data);
+	uint64_t Result = Checksum;
+
+	// Pełne słowa
+	uint64_t Offset = 0;
+	for(; Offset + sizeof(uint64_t) <= Size; Offset += sizeof(uint64_t))
+	{
+		uint64_t Word;
+		std::memcpy(&Word, Bytes + Offset, sizeof(Word));
+		Result = (Result ^ Word) * ChecksumPrime;
+	}
+
+	// Końcówka bajtami
+	for(; Offset < Size; Offset++)
+		Result = (Result ^ Bytes[Offset]) * ChecksumPrime;
+
+	return Result;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "Graph.hpp"
+
+/*
+	Binarny format pliku grafu CSR oraz jego mapowanie do pamięci (tylko do odczytu).
+
+	Układ pliku:
+		- nagłówek Header_t
+		- EdgeOffsets - (SideSize * SideSize + 1) wpisów Graph::EdgeIndex_t
+		- NeighborVertexIndexes - EdgeCount wpisów Graph::NeighborVertexIndex_t
+		- EdgeWeights - EdgeCount wpisów Graph::EdgeWeight_t
+	Każda sekcja zaczyna się na granicy SectionAlignment, więc po zmapowaniu tablice są wyrównane i używane bezpośrednio, bez kopiowania.
+	Liczby zapisane są w natywnym porządku bajtów - nagłówek zawiera znacznik ByteOrder oraz rozmiary typów, plik z innej architektury jest odrzucany.
+*/
+class GraphFile
+{
+	public:
+		// Wersja formatu - zmiana układu pliku wymaga jej podbicia
+		static const uint32_t Version = 1;
+
+		// Wyrównanie sekcji - rozmiar strony
+		static const uint64_t SectionAlignment = 4096;
+
+		struct Header_t
+		{
+			char Magic[8]; /* "PsoSppG" */
+			uint32_t Version;
+			uint32_t ByteOrder; /* 0x01020304 */
+
+			uint32_t SideSize;
+			uint8_t EdgeIndexSize;
+			uint8_t NeighborVertexIndexSize;
+			uint8_t EdgeWeightSize;
+			uint8_t Reserved;
+
+			uint64_t EdgeCount;
+
+			// Położenie sekcji w pliku (w bajtach od początku)
+			uint64_t EdgeOffsetsOffset;
+			uint64_t NeighborVertexIndexesOffset;
+			uint64_t EdgeWeightsOffset;
+			uint64_t FileSize;
+
+			// Suma kontrolna wszystkich sekcji (CalculateChecksum)
+			uint64_t Checksum;
+		};
+
+	public:
+		/*
+			Mapuje plik do pamięci i sprawdza jego nagłówek
+
+			Path - ścieżka do pliku
+			HugePages - prośba o duże strony dla mapowania (tylko Linux, madvise). Bez gwarancji
+			VerifyChecksum - sprawdzenie sumy kontrolnej. Wymaga przeczytania całego pliku
+
+			Struktura CSR (przesunięcia, zakres i kolejność sąsiadów) sprawdzana jest zawsze - uszkodzony plik nie prowadzi do odczytów poza tablicami
+		*/
+		GraphFile(const std::string & Path, const bool & HugePages, const bool & VerifyChecksum);
+		GraphFile(const GraphFile &) = delete;
+		GraphFile & operator=(const GraphFile &) = delete;
+		~GraphFile();
+
+	private:
+		const uint8_t * Data;
+		size_t Size;
+
+		void Unmap();
+
+	public:
+		const Header_t & GetHeader() const;
+
+		const Graph::EdgeIndex_t * GetEdgeOffsets() const;
+		const Graph::NeighborVertexIndex_t * GetNeighborVertexIndexes() const;
+		const Graph::EdgeWeight_t * GetEdgeWeights() const;
+
+	public:
+		/*
+			Zapisuje graf CSR do pliku. Zapis idzie do pliku tymczasowego (Path + ".tmp"), który na końcu zastępuje Path
+		*/
+		static void Write(const Graph & G, const std::string & Path);
+
+		/*
+			Suma kontrolna bloku danych, kontynuowana od Checksum (FNV-1a na słowach 64-bitowych)
+		*/
+		static uint64_t CalculateChecksum(const void * Data, const uint64_t & Size, const uint64_t & Checksum);
+};
+
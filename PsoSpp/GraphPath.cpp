@@ -8,6 +8,14 @@ GraphPath::GraphPath(const Graph & G, VertexIndexes_t && VertexIndexes):
 
 }
 
+GraphPath::GraphPath(const Graph & G, VertexIndexes_t && VertexIndexes, const PathWeight_t & PathWeight):
+	GWrapper(G),
+	VertexIndexes(std::move(VertexIndexes)),
+	PathWeight(PathWeight)
+{
+
+}
+
 const GraphPath::VertexIndexes_t & GraphPath::GetVertexIndexes() const
 {
 	return VertexIndexes;
@@ -17,6 +25,13 @@ const GraphPath::PathWeight_t & GraphPath::GetPathWeight() const
 	return PathWeight;
 }
 
+void GraphPath::Assign(const VertexIndexes_t & VertexIndexes, const PathWeight_t & PathWeight)
+{
+	// Przypisanie wektora zachowuje jego pojemność
+	this->VertexIndexes = VertexIndexes;
+	this->PathWeight = PathWeight;
+}
+
 bool GraphPath::IsBetterThan(const GraphPath & Other) const
 {
 	return PathWeight < Other.PathWeight;
@@ -24,45 +39,25 @@ bool GraphPath::IsBetterThan(const GraphPath & Other) const
 
 void GraphPath::DumpPath(std::ostream & Stream) const
 {
-	// czna waga
+	// Łączna waga
 	Stream << "(" << PathWeight << "): ";
 
-	// Lista wierzchokw i poszczeglnych wag
-	VertexIndexes_t::const_iterator First = VertexIndexes.cbegin();
-	while(true)
-	{
-		VertexIndexes_t::const_iterator Second = std::next(First);
-
-		if(Second == VertexIndexes.cend())
-			break;
-
-		Stream << *First << " -" << (int) GWrapper.get().GetEdgeWeight(*First, *Second) << "-> " << *Second << " ";
-
-		First = Second;
-	}
+	// Lista wierzchołków i poszczególnych wag
+	for(size_t Position = 1; Position < VertexIndexes.size(); Position++)
+		Stream << VertexIndexes[Position - 1] << " -" << (int) GWrapper.get().GetEdgeWeight(VertexIndexes[Position - 1], VertexIndexes[Position]) << "-> " << VertexIndexes[Position] << " ";
 }
 
 GraphPath::PathWeight_t GraphPath::CalculatePathWeight(const Graph & G, const VertexIndexes_t & VertexIndexes)
 {
-	// Waga zerowa, jeli cieka pusta
+	// Waga zerowa, jeśli ścieżka pusta
 	if(VertexIndexes.size() <= 1)
 		return 0;
 
 	// Akumulator
 	PathWeight_t PathWeight = 0;
 
-	VertexIndexes_t::const_iterator First = VertexIndexes.cbegin();
-	while(true)
-	{
-		VertexIndexes_t::const_iterator Second = std::next(First);
-
-		if(Second == VertexIndexes.cend())
-			break;
-
-		PathWeight += G.GetEdgeWeight(*First, *Second);
-
-		First = Second;
-	}
+	for(size_t Position = 1; Position < VertexIndexes.size(); Position++)
+		PathWeight += G.GetEdgeWeight(VertexIndexes[Position - 1], VertexIndexes[Position]);
 
 	return PathWeight;
-}
\ No newline at end of file
+}
@@ -1,48 +1,58 @@
 #pragma once
 
-#include <list>
+#include <vector>
 #include <functional>
 #include <ostream>
 
 #include "Graph.hpp"
 
 /*
-	Klasa reprezentujca ciek w grafie
+	Klasa reprezentująca ścieżkę w grafie
+
+	Wierzchołki przechowywane są w ciągłym buforze - jedna alokacja na ścieżkę zamiast jednej na wierzchołek.
+	Assign nadpisuje ścieżkę w miejscu, więc ścieżka aktualizowana wielokrotnie (np. najlepsza ścieżka cząstki) przestaje alokować, gdy bufor osiągnie potrzebną pojemność.
 */
 class GraphPath
 {
 	public:
-		// Lista wierzchokw
-		typedef std::list<Graph::VertexIndex_t> VertexIndexes_t;
+		// Kolejne wierzchołki ścieżki
+		typedef std::vector<Graph::VertexIndex_t> VertexIndexes_t;
 
-		// Waga cieki jako sumy wag krawdzi
+		// Waga ścieżki jako sumy wag krawędzi
 		typedef unsigned long PathWeight_t;
 
 	public:
 		/*
 			Konstruktor.
 
-			Poniewa lista powstaje zazwyczaj na bazie obiektw tymczasowych - kontruktor przenoszcy list
+			Ponieważ wektor wierzchołków powstaje zazwyczaj na bazie obiektów tymczasowych - kontruktor przenoszący
 
 			G - Graf
-			VertexIndexes - lista wierzchokw
+			VertexIndexes - kolejne wierzchołki ścieżki
 		*/
 		GraphPath(const Graph & G, VertexIndexes_t && VertexIndexes);
 
+		/*
+			Konstruktor dla ścieżki o znanej już wadze (np. policzonej w trakcie dekodowania) - bez ponownego przechodzenia ścieżki
+
+			PathWeight - waga ścieżki, musi być równa CalculatePathWeight(G, VertexIndexes)
+		*/
+		GraphPath(const Graph & G, VertexIndexes_t && VertexIndexes, const PathWeight_t & PathWeight);
+
 	private:
 		/*
-			Chcemy umoliwi kopiowanie i przenoszenie, wic trzymamy refrence_wrapper
+			Chcemy umożliwić kopiowanie i przenoszenie, więc trzymamy refrence_wrapper
 		*/
 		std::reference_wrapper<const Graph> GWrapper;
 
 		/*
-			Lista wierzchokw
+			Kolejne wierzchołki ścieżki
 		*/
 		VertexIndexes_t VertexIndexes;
 
 	private:
 		/*
-			Obliczona w kontruktorze waga cieki
+			Obliczona w kontruktorze waga ścieżki
 		*/
 		PathWeight_t PathWeight;
 
@@ -52,19 +62,24 @@ class GraphPath
 
 	public:
 		/*
-			Sprawdza czy podana cieka jest lepsza od drugiej
+			Zastępuje ścieżkę kopią VertexIndexes o znanej wadze PathWeight, w istniejącym buforze (alokacja tylko, gdy bufor jest za mały)
+		*/
+		void Assign(const VertexIndexes_t & VertexIndexes, const PathWeight_t & PathWeight);
+
+		/*
+			Sprawdza czy podana ścieżka jest lepsza od drugiej
 		*/
 		bool IsBetterThan(const GraphPath & Other) const;
 
 	public:
 		/*
-			Drukuje graficzn reprezentacj do strumienia
+			Drukuje graficzną reprezentację do strumienia
 		*/
 		void DumpPath(std::ostream & Stream) const;
 
 	public:
 		/*
-			Metoda pomocnicza obliczajca dugo cieki dla podanego grafu i listy
+			Metoda pomocnicza obliczająca długość ścieżki dla podanego grafu i wierzchołków
 		*/
 		static PathWeight_t CalculatePathWeight(const Graph & G, const VertexIndexes_t & VertexIndexes);
 };
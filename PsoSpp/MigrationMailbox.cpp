@@ -0,0 +1,28 @@
+#include "MigrationMailbox.hpp"
+
+MigrationMailbox::MigrationMailbox():
+	Slot(nullptr)
+{
+
+}
+
+MigrationMailbox::~MigrationMailbox()
+{
+	// Migrant, którego nikt nie odebrał
+	delete Slot.load();
+}
+
+void MigrationMailbox::Send(std::unique_ptr<Migrant_t> && Migrant)
+{
+	// Poprzedni migrant należy teraz do nadawcy - std::unique_ptr go usunie
+	std::unique_ptr<Migrant_t> MigrantPrevious(Slot.exchange(Migrant.release(), std::memory_order_acq_rel));
+}
+
+std::unique_ptr<MigrationMailbox::Migrant_t> MigrationMailbox::Receive()
+{
+	// Tani odczyt - większość sprawdzeń trafia na pustą skrzynkę
+	if(Slot.load(std::memory_order_relaxed) == nullptr)
+		return nullptr;
+
+	return std::unique_ptr<Migrant_t>(Slot.exchange(nullptr, std::memory_order_acq_rel));
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "Particle.hpp"
+#include "GraphPath.hpp"
+
+/*
+	Skrzynka migracji pomiędzy grupami cząstek (model wyspowy).
+
+	Skrzynka przechowuje co najwyżej jednego, najnowszego migranta - najlepsze rozwiązanie innej grupy.
+	Wymiana odbywa się bez blokad, na jednym atomowym wskaźniku:
+		- nadawca podmienia wskaźnik na nowego migranta i usuwa poprzedniego, jeśli nikt go jeszcze nie odebrał
+		- odbiorca zabiera migranta podmieniając wskaźnik na nullptr
+	W każdej chwili migrant ma dokładnie jednego właściciela, więc do jednej skrzynki może pisać wiele grup naraz.
+*/
+class MigrationMailbox
+{
+	public:
+		struct Migrant_t
+		{
+			// Priorytety najlepszego rozwiązania grupy nadawcy
+			std::vector<Particle::Priority_t> Priorities;
+
+			// Ścieżka odpowiadająca priorytetom
+			GraphPath Path;
+		};
+
+	public:
+		MigrationMailbox();
+		MigrationMailbox(const MigrationMailbox &) = delete;
+		MigrationMailbox & operator=(const MigrationMailbox &) = delete;
+		~MigrationMailbox();
+
+	private:
+		/*
+			Własna linia pamięci podręcznej - skrzynki kolejnych grup nie przeszkadzają sobie nawzajem
+		*/
+		alignas(64) std::atomic<Migrant_t *> Slot;
+
+	public:
+		/*
+			Wstawia migranta w miejsce poprzedniego (nieodebrany poprzedni migrant jest usuwany)
+		*/
+		void Send(std::unique_ptr<Migrant_t> && Migrant);
+
+		/*
+			Zabiera migranta ze skrzynki lub zwraca nullptr, jeśli skrzynka jest pusta
+		*/
+		std::unique_ptr<Migrant_t> Receive();
+};
+
@@ -0,0 +1,292 @@
+#include "NumaPlacement.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#if defined(__linux__)
+	#include <cstdlib>
+	#include <filesystem>
+	#include <fstream>
+	#include <sstream>
+	#include <string>
+
+	#include <sys/syscall.h>
+	#include <unistd.h>
+#endif
+
+namespace
+{
+#if defined(__linux__)
+	// Lista procesorów w formacie jądra, np. "0-3,8-11"
+	std::vector<size_t> ParseCpuList(const std::string & CpuList)
+	{
+		std::vector<size_t> Cpus;
+
+		std::stringstream Stream(CpuList);
+		std::string Range;
+		while(std::getline(Stream, Range, ','))
+		{
+			if(Range.empty() || Range == "\n")
+				continue;
+
+			const size_t Separator = Range.find('-');
+			const size_t CpuFirst = std::strtoul(Range.c_str(), nullptr, 10);
+			const size_t CpuLast = Separator == std::string::npos ? CpuFirst : std::strtoul(Range.c_str() + Separator + 1, nullptr, 10);
+			for(size_t Cpu = CpuFirst; Cpu <= CpuLast; Cpu++)
+				Cpus.push_back(Cpu);
+		}
+
+		return Cpus;
+	}
+#endif
+
+	// Wszystkie procesory jako jeden węzeł
+	NumaPlacement::Topology_t CreateTopologySingle()
+	{
+		NumaPlacement::Node_t Node;
+		Node.Id = 0;
+		for(size_t Cpu = 0; Cpu < std::max<size_t>(1, std::thread::hardware_concurrency()); Cpu++)
+			Node.Cpus.push_back(Cpu);
+
+		return NumaPlacement::Topology_t(1, Node);
+	}
+}
+
+NumaPlacement::NumaPlacement(const Graph & G, const Topology_t & Topology, const size_t & ThreadNumber, const bool & Pin):
+	G(G), Topology(Topology.empty() ? CreateTopologySingle() : Topology)
+{
+	size_t CpuNumber = 0;
+	for(const Node_t & Node : this->Topology)
+		CpuNumber += Node.Cpus.size();
+
+	// Pule węzłów - wątki proporcjonalnie do liczby procesorów węzła, zawsze ograniczone do procesorów węzła (inaczej first touch w RunOnNode trafiałby na dowolny węzeł)
+	for(const Node_t & Node : this->Topology)
+	{
+		const size_t NodeThreadNumber = ThreadNumber ? std::max<size_t>(1, ThreadNumber * Node.Cpus.size() / std::max<size_t>(1, CpuNumber)) : std::max<size_t>(1, Node.Cpus.size());
+		Pools.emplace_back(new ThreadPool(NodeThreadNumber, Node.Cpus, Pin ? ThreadPool::Affinity_t::Cpu : ThreadPool::Affinity_t::CpuSet));
+	}
+
+	// Kopie grafu - każda zapisywana przez wątek swojego węzła
+	if(this->Topology.size() > 1)
+	{
+		Replicas.resize(this->Topology.size());
+		RunOnNodes([&](const size_t & Node)
+		{
+			Replicas[Node].reset(new Graph(G.Replicate()));
+		});
+	}
+
+	// Tablice CSR grafu każdego węzła. Graf niejawny - tylko model, stron nie liczymy
+	GraphPages.resize(this->Topology.size());
+	for(size_t Node = 0; Node < this->Topology.size(); Node++)
+	{
+		const Graph & NodeGraph = GetGraph(Node);
+		if(NodeGraph.IsImplicit())
+			continue;
+
+		const Graph::EdgeIndex_t EdgeCount = NodeGraph.EdgeOffsets[NodeGraph.GetSize()];
+		CountPages(NodeGraph.EdgeOffsets, (NodeGraph.GetSize() + 1) * sizeof(Graph::EdgeIndex_t), this->Topology[Node].Id, GraphPages[Node]);
+		CountPages(NodeGraph.NeighborVertexIndexes, EdgeCount * sizeof(Graph::NeighborVertexIndex_t), this->Topology[Node].Id, GraphPages[Node]);
+		CountPages(NodeGraph.EdgeWeights, EdgeCount * sizeof(Graph::EdgeWeight_t), this->Topology[Node].Id, GraphPages[Node]);
+	}
+}
+
+size_t NumaPlacement::GetNodeNumber() const
+{
+	return Topology.size();
+}
+
+const NumaPlacement::Node_t & NumaPlacement::GetNode(const size_t & Node) const
+{
+	return Topology[Node];
+}
+
+ThreadPool & NumaPlacement::GetPool(const size_t & Node) const
+{
+	return *Pools[Node];
+}
+
+const Graph & NumaPlacement::GetGraphSource() const
+{
+	return G;
+}
+
+const Graph & NumaPlacement::GetGraph(const size_t & Node) const
+{
+	return Replicas.empty() ? G : *Replicas[Node];
+}
+
+const NumaPlacement::Pages_t & NumaPlacement::GetGraphPages(const size_t & Node) const
+{
+	return GraphPages[Node];
+}
+
+size_t NumaPlacement::GetThreadNumber() const
+{
+	size_t ThreadNumber = 0;
+	for(const std::unique_ptr<ThreadPool> & Pool : Pools)
+		ThreadNumber += Pool->GetThreadNumber();
+
+	return ThreadNumber;
+}
+
+size_t NumaPlacement::GetThreadsPinned() const
+{
+	size_t ThreadsPinned = 0;
+	for(const std::unique_ptr<ThreadPool> & Pool : Pools)
+		ThreadsPinned += Pool->GetThreadsPinned();
+
+	return ThreadsPinned;
+}
+
+void NumaPlacement::RunOnNode(const size_t & Node, const std::function<void()> & Function)
+{
+	std::mutex Mutex;
+	std::condition_variable Condition;
+	bool Done = false;
+	std::exception_ptr Exception;
+
+	Pools[Node]->Post([&]()
+	{
+		// Wyjątek nie może opuścić zadania puli - przekazujemy go czekającemu
+		std::exception_ptr FunctionException;
+		try
+		{
+			Function();
+		}
+		catch(...)
+		{
+			FunctionException = std::current_exception();
+		}
+
+		// Powiadomienie pod blokadą - zmienne żyją na stosie czekającego
+		std::lock_guard<std::mutex> Lock(Mutex);
+		Exception = FunctionException;
+		Done = true;
+		Condition.notify_all();
+	});
+
+	std::unique_lock<std::mutex> Lock(Mutex);
+	Condition.wait(Lock, [&] { return Done; });
+
+	if(Exception)
+		std::rethrow_exception(Exception);
+}
+
+void NumaPlacement::RunOnNodes(const std::function<void(const size_t &)> & Function)
+{
+	std::mutex Mutex;
+	std::condition_variable Condition;
+	size_t Remaining = Pools.size();
+	std::exception_ptr Exception;
+
+	for(size_t Node = 0; Node < Pools.size(); Node++)
+	{
+		Pools[Node]->Post([&, Node]()
+		{
+			std::exception_ptr FunctionException;
+			try
+			{
+				Function(Node);
+			}
+			catch(...)
+			{
+				FunctionException = std::current_exception();
+			}
+
+			// Zapamiętujemy pierwszy wyjątek, ale czekamy na wszystkie węzły
+			std::lock_guard<std::mutex> Lock(Mutex);
+			if(FunctionException && !Exception)
+				Exception = FunctionException;
+			--Remaining;
+			Condition.notify_all();
+		});
+	}
+
+	std::unique_lock<std::mutex> Lock(Mutex);
+	Condition.wait(Lock, [&] { return Remaining == 0; });
+
+	if(Exception)
+		std::rethrow_exception(Exception);
+}
+
+NumaPlacement::Topology_t NumaPlacement::DetectTopology()
+{
+#if defined(__linux__)
+	Topology_t Topology;
+
+	std::error_code Error;
+	for(const std::filesystem::directory_entry & Entry : std::filesystem::directory_iterator("/sys/devices/system/node", Error))
+	{
+		const std::string Name = Entry.path().filename().string();
+		if(Name.compare(0, 4, "node") != 0 || Name.size() == 4 || !std::all_of(Name.begin() + 4, Name.end(), [](const char & Character) { return Character >= '0' && Character <= '9'; }))
+			continue;
+
+		std::ifstream Stream(Entry.path() / "cpulist");
+		std::string CpuList;
+		std::getline(Stream, CpuList);
+
+		// Węzeł bez procesorów (sama pamięć) nie dostaje puli
+		Node_t Node;
+		Node.Id = std::atoi(Name.c_str() + 4);
+		Node.Cpus = ParseCpuList(CpuList);
+		if(!Node.Cpus.empty())
+			Topology.push_back(std::move(Node));
+	}
+
+	if(Topology.empty())
+		return CreateTopologySingle();
+
+	std::sort(Topology.begin(), Topology.end(), [](const Node_t & Node1, const Node_t & Node2) { return Node1.Id < Node2.Id; });
+	return Topology;
+#else
+	return CreateTopologySingle();
+#endif
+}
+
+void NumaPlacement::CountPages(const void * Data, const size_t & Size, const int & NodeId, Pages_t & Pages)
+{
+#if defined(__linux__) && defined(SYS_move_pages)
+	if(Data == nullptr || Size == 0)
+		return;
+
+	const uintptr_t PageSize = (uintptr_t) sysconf(_SC_PAGESIZE);
+	const uintptr_t Begin = (uintptr_t) Data / PageSize * PageSize;
+	const uintptr_t End = (uintptr_t) Data + Size;
+
+	// move_pages bez węzłów docelowych tylko odczytuje położenie stron. Paczkami - bez alokacji
+	const size_t BatchSize = 1024;
+	void * Addresses[BatchSize];
+	int Status[BatchSize];
+
+	for(uintptr_t Address = Begin; Address < End; )
+	{
+		size_t Count = 0;
+		for(; Count < BatchSize && Address < End; Count++, Address += PageSize)
+			Addresses[Count] = reinterpret_cast<void *>(Address);
+
+		if(syscall(SYS_move_pages, 0, (unsigned long) Count, Addresses, nullptr, Status, 0) != 0)
+			return;
+
+		// Ujemny stan - strona nieprzydzielona lub niedostępna
+		for(size_t PageId = 0; PageId < Count; PageId++)
+		{
+			if(Status[PageId] < 0)
+				continue;
+
+			if(Status[PageId] == NodeId)
+				++Pages.Local;
+			else
+				++Pages.Remote;
+		}
+	}
+#else
+	(void) Data;
+	(void) Size;
+	(void) NodeId;
+	(void) Pages;
+#endif
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "Graph.hpp"
+#include "ThreadPool.hpp"
+
+/*
+	Rozmieszczenie obliczeń na węzłach NUMA (ParticleGroupRunner::SetPlacement).
+
+	Dla każdego węzła tworzona jest własna pula wątków ograniczonych do procesorów węzła (opcjonalnie przypiętych do kolejnych procesorów węzła) i własna kopia grafu (Graph::Replicate), tworzona przez wątek węzła.
+	Linux przydziela stronę pamięci węzłowi wątku, który pierwszy do niej pisze (first touch), więc kopia grafu i stan grup tworzonych przez RunOnNode leżą w pamięci lokalnej węzła.
+	Grupy przypisane do węzła wykonywane są wyłącznie na jego puli - odczyty grafu w Particle::Run nie przechodzą przez połączenie pomiędzy gniazdami.
+
+	Na maszynie z jednym węzłem (lub bez informacji o topologii) powstaje jedna pula, a kopia grafu nie jest tworzona - używany jest graf oryginalny.
+	Położenie stron (CountPages) odczytywane jest przez move_pages (Linux) - na innych systemach strony nie są liczone.
+*/
+class NumaPlacement
+{
+	public:
+		struct Node_t
+		{
+			// Numer węzła w systemie
+			int Id;
+
+			// Procesory węzła
+			std::vector<size_t> Cpus;
+		};
+		typedef std::vector<Node_t> Topology_t;
+
+		// Liczba stron węzła lokalnego i pozostałych węzłów
+		struct Pages_t
+		{
+			uint64_t Local = 0;
+			uint64_t Remote = 0;
+		};
+
+	public:
+		/*
+			Konstruktor.
+
+			G - graf zadań. Musi żyć dłużej niż obiekt
+			Topology - węzły (DetectTopology lub zadane, np. podzbiór węzłów). Pusta - jeden węzeł ze wszystkimi procesorami
+			ThreadNumber - łączna liczba wątków wszystkich pul, dzielona pomiędzy węzły proporcjonalnie do liczby procesorów (co najmniej jeden na węzeł). 0 - po jednym na procesor
+			Pin - przypięcie każdego wątku puli węzła do jednego, kolejnego procesora węzła. Bez przypięcia wątki puli mogą działać na dowolnym procesorze węzła
+		*/
+		NumaPlacement(const Graph & G, const Topology_t & Topology, const size_t & ThreadNumber, const bool & Pin);
+		NumaPlacement(const NumaPlacement &) = delete;
+		NumaPlacement & operator=(const NumaPlacement &) = delete;
+
+	private:
+		const Graph & G;
+		const Topology_t Topology;
+
+		std::vector<std::unique_ptr<ThreadPool>> Pools; /* Topology.size() */
+
+		/*
+			Kopie grafu węzłów - puste przy jednym węźle
+		*/
+		std::vector<std::unique_ptr<const Graph>> Replicas;
+
+		/*
+			Położenie stron grafu każdego węzła - liczone raz, w konstruktorze
+		*/
+		std::vector<Pages_t> GraphPages;
+
+	public:
+		size_t GetNodeNumber() const;
+		const Node_t & GetNode(const size_t & Node) const;
+		ThreadPool & GetPool(const size_t & Node) const;
+
+		/*
+			Graf, dla którego utworzono rozmieszczenie (G z konstruktora)
+		*/
+		const Graph & GetGraphSource() const;
+
+		/*
+			Graf węzła - kopia lub, przy jednym węźle, graf oryginalny
+		*/
+		const Graph & GetGraph(const size_t & Node) const;
+		const Pages_t & GetGraphPages(const size_t & Node) const;
+
+		/*
+			Łączna liczba wątków i wątków przypiętych (do procesora lub procesorów węzła) wszystkich pul
+		*/
+		size_t GetThreadNumber() const;
+		size_t GetThreadsPinned() const;
+
+	public:
+		/*
+			Wykonuje Function() na wątku puli węzła Node i czeka na zakończenie - pamięć zapisana po raz pierwszy przez Function trafia na węzeł Node.
+			Nie wywoływać z wątku puli węzła. Wyjątek rzucony przez Function jest ponownie rzucany w wątku wywołującym
+		*/
+		void RunOnNode(const size_t & Node, const std::function<void()> & Function);
+
+		/*
+			Wykonuje Function(Node) dla wszystkich węzłów równolegle, każde na wątku puli swojego węzła, i czeka na zakończenie.
+			Wyjątek rzucony przez Function jest ponownie rzucany (pierwszy z nich) po zakończeniu wszystkich węzłów
+		*/
+		void RunOnNodes(const std::function<void(const size_t &)> & Function);
+
+	public:
+		/*
+			Węzły NUMA z procesorami (Linux - /sys/devices/system/node). Brak informacji - jeden węzeł ze wszystkimi procesorami
+		*/
+		static Topology_t DetectTopology();
+
+		/*
+			Dolicza do Pages strony bloku Data o rozmiarze Size: leżące na węźle NodeId (Local) i na innych węzłach (Remote).
+			Strony jeszcze nieprzydzielone i system bez move_pages - nieliczone
+		*/
+		static void CountPages(const void * Data, const size_t & Size, const int & NodeId, Pages_t & Pages);
+};
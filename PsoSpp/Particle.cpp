@@ -1,160 +1,204 @@
 #include "Particle.hpp"
 
 #include <algorithm>
+#include <cmath>
 
 #include "ParticleGroup.hpp"
+#include "ParticleKernels.hpp"
+#include "PathLocalSearch.hpp"
 #include "Task.hpp"
 #include "Graph.hpp"
 #include "GraphPath.hpp"
 
-Particle::Particle(const ParticleGroup & PG, std::mt19937 & RandomGenerator):
+Particle::Particle(const ParticleGroup & PG, const FastRandom & RandomGenerator, const SwarmMatrix & Swarm, const size_t & ParticleId):
 	PG(PG),
 	RandomGenerator(RandomGenerator),
-	Priorities(new Priority_t[PG.GetTask().GetGraph().GetSize()]),
-	Velocities(new Velocity_t[PG.GetTask().GetGraph().GetSize()]),
-	BestPriorities(new Priority_t[PG.GetTask().GetGraph().GetSize()])
+	Priorities(Swarm.GetPriorities(ParticleId)),
+	Velocities(Swarm.GetVelocities(ParticleId)),
+	BestPriorities(Swarm.GetBestPriorities(ParticleId))
 {
 	// Inicjalizacja losowego stanu
 	RandomInitialize();
 }
 
-Particle::Particle(const Particle & Other):
-	PG(Other.PG),
-	RandomGenerator(Other.RandomGenerator),
-	Priorities(new Priority_t[PG.GetTask().GetGraph().GetSize()]),
-	Velocities(new Velocity_t[PG.GetTask().GetGraph().GetSize()]),
-	BestPriorities(new Priority_t[PG.GetTask().GetGraph().GetSize()]),
-	BestGraphPath(Other.BestGraphPath)
+const std::optional<GraphPath>& Particle::GetBestGraphPath() const
 {
-	std::copy(Other.Priorities.get(), Other.Priorities.get() + PG.GetTask().GetGraph().GetSize(), Priorities.get());
-	std::copy(Other.Velocities.get(), Other.Velocities.get() + PG.GetTask().GetGraph().GetSize(), Velocities.get());
-	std::copy(Other.BestPriorities.get(), Other.BestPriorities.get() + PG.GetTask().GetGraph().GetSize(), BestPriorities.get());
+	return BestGraphPath;
 }
 
-
-
-const std::optional<const GraphPath>& Particle::GetBestGraphPath() const
+const Particle::Priority_t * Particle::GetBestPriorities() const
 {
-	return BestGraphPath;
+	return BestPriorities;
 }
 
 void Particle::RandomInitialize()
 {
-	std::uniform_real_distribution<double> PriorityDistribution(0.0, 1.0);
-	std::uniform_real_distribution<double> VelocityDistribution(0.0, 1.0);
+	const Graph::VertexIndex_t Size = PG.GetTask().GetGraph().GetSize();
 
-	// Losowe Priorities, Velocities, [0.0; 1.0]
-	std::generate(Priorities.get(), Priorities.get() + PG.GetTask().GetGraph().GetSize(), [&] { return PriorityDistribution(RandomGenerator); });
-	std::generate(Velocities.get(), Velocities.get() + PG.GetTask().GetGraph().GetSize(), [&] { return VelocityDistribution(RandomGenerator); });
+	// Losowe Priorities, Velocities, [0.0; 1.0)
+	RandomGenerator.Uniform(Priorities, Size);
+	RandomGenerator.Uniform(Velocities, Size);
 
-	// Jeli wze nie niesie za sob adnego najlepszego rozwizania - rwnie inicjujemy wze najlepszego rozwizania jako wze lokalnego rozwizania
+	// Jeśli węzeł nie niesie za sobą żadnego najlepszego rozwiązania - również inicjujemy węzeł najlepszego rozwiązania jako węzeł lokalnego rozwiązania
 	if(!BestGraphPath)
 	{
-		std::copy(Priorities.get(), Priorities.get() + PG.GetTask().GetGraph().GetSize(), BestPriorities.get());
+		std::copy(Priorities, Priorities + Size, BestPriorities);
 	}
 }
 
-bool Particle::Run()
+void Particle::SeedInitialize(const Priority_t * SeedPriorities, const double & Noise)
 {
-	// Lista odwiedzonych wzw, aby nie tworzy cykli
-	std::unique_ptr<bool[]> VisitedNodes(new bool[PG.GetTask().GetGraph().GetSize()]);
-	std::fill(VisitedNodes.get(), VisitedNodes.get() + PG.GetTask().GetGraph().GetSize(), false);
-
-	// Rozwizanie czciowe - bufor na wierzchoki czciowo zbudowanej cieki
-	GraphPath::VertexIndexes_t PartialSolution;
+	const Graph::VertexIndex_t Size = PG.GetTask().GetGraph().GetSize();
 
-	// Zaczynamy od wierzchoka startowego
-	Graph::VertexIndex_t CurrentVertexIndex = PG.GetTask().GetVertexIndexStart();
+	// Czynniki zaburzenia losowane w miejscu priorytetów, [1 - Noise; 1 + Noise)
+	RandomGenerator.Uniform(Priorities, Size);
+	for(Graph::VertexIndex_t VertexIndex = 0; VertexIndex < Size; VertexIndex++)
+		Priorities[VertexIndex] = SeedPriorities[VertexIndex] * (1.0 - Noise + 2.0 * Noise * Priorities[VertexIndex]);
+	RandomGenerator.Uniform(Velocities, Size);
 
-	while(true)
+	if(!BestGraphPath)
 	{
-		// Dodaj obecny wierzchoek do historii
-		PartialSolution.push_back(CurrentVertexIndex);
+		std::copy(Priorities, Priorities + Size, BestPriorities);
+	}
+}
 
-		// Jeli zadanie zostao spenione - koczymy
-		if(CurrentVertexIndex == PG.GetTask().GetVertexIndexEnd())
-		{
-			// Czy cieka ulega poprawie?
-			GraphPath GP(
-				PG.GetTask().GetGraph(),
-				std::move(PartialSolution)
-			);
-
-			// Obecna cieka istnieje, a nowa nie jest lepsza, kryterium nie ulego poprawie
-			if(BestGraphPath && !GP.IsBetterThan(BestGraphPath.value()))
-				return false;
+bool Particle::Run(DecodeScratch & Scratch, TargetBest & Targets, PerformanceCounters::Values_t & Counters)
+{
+	++Counters.Decodes;
 
-			// Zapamitaj obecny stan jako najlepszy
-			std::copy(Priorities.get(), Priorities.get() + PG.GetTask().GetGraph().GetSize(), BestPriorities.get());
+	const Task & T = PG.GetTask();
 
-			// Zapisujemy ciek
-			BestGraphPath.emplace(
-				std::move(GP)
-			);
+	// Czyścimy bufory - zbiór odwiedzonych węzłów (aby nie tworzyć cykli) i rozwiązanie częściowe
+	Scratch.Begin();
 
-			// cieka ulega poprawie
-			return true;
-		}
+	// Zaczynamy od wierzchołka startowego
+	Graph::VertexIndex_t CurrentVertexIndex = T.GetVertexIndexStart();
+	Graph::EdgeWeight_t CurrentEdgeWeight = 0;
+
+	// Zadanie wielocelowe - liczba celów jeszcze nieodwiedzonych i długość ścieżki do pierwszego celu (0 - jeszcze nie osiągnięty)
+	const bool MultiTarget = T.IsMultiTarget();
+	size_t TargetsRemaining = T.GetVertexIndexEnds().size();
+	size_t EndPathLength = 0;
+
+	while(true)
+	{
+		// Dodaj obecny wierzchołek do historii
+		Scratch.Push(CurrentVertexIndex, CurrentEdgeWeight);
+		++Counters.DecodeSteps;
 
-		// Odznaczamy obecny wierzchoek jako odwiedzony
-		VisitedNodes[CurrentVertexIndex] = true;
+		if(MultiTarget)
+		{
+			// Cel zadania wielocelowego - dotychczasowa ścieżka prowadzi do niego, zgłaszamy ją i idziemy dalej, dopóki zostały nieodwiedzone cele
+			const Task::TargetId_t & TargetId = T.GetTargetId(CurrentVertexIndex);
+			if(TargetId != Task::TargetIdNone)
+			{
+				if(Targets.Offer(TargetId, Scratch))
+					++Counters.TargetImprovements;
 
-		// Wybierz nastpny wierzchoek do przejcia
-		// Sprawd wszystkie wierzchoki, minmalizcujc Weight * Priority
-		bool AnyFound = false;
-		Graph::VertexIndex_t BestNextVertexIndex;
-		double BestWeight;
+				if(CurrentVertexIndex == T.GetVertexIndexEnd())
+					EndPathLength = Scratch.GetVertexIndexes().size();
 
-		for(Graph::VertexIndex_t NextVertexIndex = 0; NextVertexIndex < PG.GetTask().GetGraph().GetSize(); NextVertexIndex++)
+				if(--TargetsRemaining == 0)
+					break;
+			}
+		}
+		else if(CurrentVertexIndex == T.GetVertexIndexEnd())
 		{
-			// Pomijamy odwiedzone wzy
-			if(VisitedNodes[NextVertexIndex])
-				continue;
+			// Jeśli zadanie zostało spełnione - kończymy
+			break;
+		}
 
-			// Pobieramy warto krawdzi, sprawdzamy czy w ogle istnieje
-			const Graph::EdgeWeight_t EdgeWeight = PG.GetTask().GetGraph().GetEdgeWeight(CurrentVertexIndex, NextVertexIndex);
-			if(EdgeWeight == std::numeric_limits<Graph::EdgeWeight_t>::max())
-				continue;
+		// Odznaczamy obecny wierzchołek jako odwiedzony
+		Scratch.Visit(CurrentVertexIndex);
 
-			// Wze nie zosta odwiedzony, krawd istnieje - obliczamy priotytet
-			double Weight = Priorities[NextVertexIndex] * EdgeWeight;
+		// Wybierz następny wierzchołek do przejścia
+		// Sprawdź wszystkich sąsiadów, minmalizcując Weight * Priority
+		const Graph::Neighbors_t Neighbors = T.GetGraph().GetNeighbors(CurrentVertexIndex, Scratch.GetNeighborsBuffer());
+		const size_t BestNeighborId = ParticleKernels::NeighborArgMin(Neighbors, Priorities, Scratch.GetVisitedMarks(), Scratch.GetVisitedMark());
 
-			// Sprawdzamy czy to lepsze rozwizanie
-			if(!AnyFound || Weight < BestWeight)
+		// Nie ma dokąd pójść
+		if(BestNeighborId == Neighbors.Size)
+		{
+			// Przed osiągnięciem (pierwszego) celu - brak rozwiązania
+			if(EndPathLength == 0)
 			{
-				AnyFound = true;
-				BestNextVertexIndex = NextVertexIndex;
-				BestWeight = Weight;
+				++Counters.DecodeDeadEnds;
+				return false;
 			}
+
+			break;
 		}
 
-		// Nie ma dokd pj
-		if(!AnyFound)
-			return false;
+		// Idziemy do najlepszego wierzchołka
+		CurrentVertexIndex = Neighbors.VertexIndexes[BestNeighborId];
+		CurrentEdgeWeight = Neighbors.EdgeWeights[BestNeighborId];
+	}
+
+	// Ścieżka zadania wielocelowego mogła pójść dalej - rozwiązaniem cząstki jest jej początek, aż do pierwszego celu
+	if(MultiTarget)
+		Scratch.Truncate(EndPathLength);
+
+	// Przeszukiwanie lokalne każdej pełnej ścieżki - ścieżka nieco gorsza od najlepszej często staje się po nim lepsza
+	const PathLocalSearch::Mode_t LocalSearch = PG.GetLocalSearch();
+	if(LocalSearch != PathLocalSearch::Mode_t::None)
+		PathLocalSearch::Improve(T.GetGraph(), Scratch);
+
+	// Obecna ścieżka istnieje, a nowa nie jest lepsza, kryterium nie uległo poprawie
+	if(BestGraphPath && !(Scratch.GetPathWeight() < BestGraphPath.value().GetPathWeight()))
+		return false;
+
+	// Priorytety odtwarzające poprawioną ścieżkę
+	if(LocalSearch == PathLocalSearch::Mode_t::PathAndPriorities)
+		PathLocalSearch::WriteBack(T.GetGraph(), Scratch, Priorities);
 
-		// Idziemy do najlepszego wierzchoka
-		CurrentVertexIndex = BestNextVertexIndex;
+	// Zapamiętaj obecny stan jako najlepszy
+	std::copy(Priorities, Priorities + T.GetGraph().GetSize(), BestPriorities);
+
+	// Zapisujemy ścieżkę - w miejscu poprzedniej, jeśli taka była
+	if(BestGraphPath)
+	{
+		BestGraphPath.value().Assign(Scratch.GetVertexIndexes(), Scratch.GetPathWeight());
 	}
+	else
+	{
+		BestGraphPath.emplace(
+			T.GetGraph(),
+			GraphPath::VertexIndexes_t(Scratch.GetVertexIndexes()),
+			Scratch.GetPathWeight()
+		);
+	}
+
+	// Ścieżka uległa poprawie
+	++Counters.Improvements;
+	return true;
 }
 
-void Particle::Update(const double & Fi1, const double & Fi2, const Particle & ParticleBest)
+void Particle::Update(const double & Fi1, const double & Fi2, const double & Chi, const Priority_t * ParticleBestPriorities, double * RandomFactors)
 {
-	std::uniform_real_distribution<double> RDistribution(0.0, 1.0);
+	const Graph::VertexIndex_t Size = PG.GetTask().GetGraph().GetSize();
+
+	// Czynniki losowe R1, R2 dla wszystkich węzłów naraz
+	RandomGenerator.Uniform(RandomFactors, 2 * Size);
+
+	// 2.3, 2.2
+	// Zaktualizuj trajektorię na podstawie pozycji swojej i najlepszego z otoczenia, następnie położenie na podstawie trajektorii
+	ParticleKernels::UpdateVelocities(
+		Size,
+		Chi,
+		Fi1,
+		Fi2,
+		RandomFactors,
+		RandomFactors + Size,
+		BestPriorities,
+		ParticleBestPriorities,
+		Velocities,
+		Priorities
+	);
+}
 
+double Particle::CalculateChi(const double & Fi1, const double & Fi2)
+{
 	// 2.4
 	const double Phi = Fi1 + Fi2;
-	const double Chi = 1.0 / (2 * abs(2 - Phi - sqrt(pow(Phi, 2) - 4.0 * Phi)));
-
-	for(Graph::VertexIndex_t VertexIndex = 0; VertexIndex < PG.GetTask().GetGraph().GetSize(); VertexIndex++)
-	{
-		// 2.3
-		// Zaktualizuj trajektori na podstawie pozycji swojej i najlepszego z otoczenia
-		const double R1 = RDistribution(RandomGenerator);
-		const double R2 = RDistribution(RandomGenerator);
-		Velocities[VertexIndex] = Chi * (Velocities[VertexIndex] + Fi1 * R1 * (BestPriorities[VertexIndex] - Priorities[VertexIndex]) + Fi2 * R2 * (ParticleBest.BestPriorities[VertexIndex] - Priorities[VertexIndex]));
-
-		// 2.2
-		// Zaktualizuj pooenie na podstawie trajektorii
-		Priorities[VertexIndex] += Velocities[VertexIndex];
-	}
+	return 1.0 / (2 * std::abs(2 - Phi - std::sqrt(std::pow(Phi, 2) - 4.0 * Phi)));
 }
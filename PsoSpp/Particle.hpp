@@ -1,17 +1,21 @@
 #pragma once
 
 #include <optional>
-#include <random>
 
 #include "Task.hpp"
 #include "GraphPath.hpp"
+#include "DecodeScratch.hpp"
+#include "TargetBest.hpp"
+#include "FastRandom.hpp"
+#include "SwarmMatrix.hpp"
+#include "PerformanceCounters.hpp"
 
 class ParticleGroup;
 
 /*
-	Czstka algorytmu PSO korzystajca z "cost-priority-based particle encoding/decoding"
+	Cząstka algorytmu PSO korzystająca z "cost-priority-based particle encoding/decoding"
 	https://www.emis.de/journals/HOA/DDNS/Volume2007/27383.pdf
-	Rodzia 3.2
+	Rodział 3.2
 */
 class Particle
 {
@@ -21,68 +25,98 @@ class Particle
 
 	public:
 		/*
-			Konstruktor. Inicjuje czstk losowymi priorytetami i wektorem prdkoci
+			Konstruktor. Inicjuje cząstkę losowymi priorytetami i wektorem prędkości
 
-			PG - Grupa czstek do ktrej naley ta czstka
-			RandomGenerator - Generator liczb losowych
-		*/
-		Particle(const ParticleGroup & PG, std::mt19937 & RandomGenerator);
-		
-		/*
-			Konstruktor kopiujcy
+			PG - Grupa cząstek do której należy ta cząstka
+			RandomGenerator - Strumień liczb losowych cząstki - kopiowany, rozłączny ze strumieniami innych cząstek (FastRandom::LongJump)
+			Swarm - Macierz stanu roju, w której przechowywane są wektory tej cząstki
+			ParticleId - Numer wiersza cząstki w Swarm
+
+			Cząstka jest lekkim widokiem na wiersze Swarm - nie posiada własnych tablic, więc nie może być kopiowana.
+			Poza najlepszą ścieżką cząstka posiada tylko własny generator, więc RandomInitialize, SeedInitialize i Update różnych cząstek mogą być wykonywane równolegle.
 		*/
-		Particle(const Particle & Other);
+		Particle(const ParticleGroup & PG, const FastRandom & RandomGenerator, const SwarmMatrix & Swarm, const size_t & ParticleId);
+
+		Particle(const Particle & Other) = delete;
+		Particle(Particle && Other) = default;
 
 	private:
 		const ParticleGroup & PG;
-		std::mt19937 & RandomGenerator;
+
+		/*
+			Własny strumień liczb losowych - inicjalizacja i czynniki R1, R2 aktualizacji
+		*/
+		FastRandom RandomGenerator;
 
 	private:
 		/*
-			Kolekcje priorytetw i prdkoci dla kolejnych wzw
+			Priorytety i prędkości dla kolejnych węzłów - wiersze macierzy roju
 		*/
-		const std::unique_ptr<Priority_t[]> Priorities;
-		const std::unique_ptr<Velocity_t[]> Velocities;
+		Priority_t * const Priorities;
+		Velocity_t * const Velocities;
 
 
 	private:
 		/*
-			Wektor priorytetw dla najlepszego lokalnego rozwizania.
+			Wektor priorytetów dla najlepszego lokalnego rozwiązania - wiersz macierzy roju.
 			Ma sens tylko gdy (bool) BestGraphPath
 		*/
-		const std::unique_ptr<Priority_t[]> BestPriorities;
+		Priority_t * const BestPriorities;
 
 		/*
-			cieka dla najlepszego lokalnego rozwizania
+			Ścieżka dla najlepszego lokalnego rozwiązania
 		*/
-		std::optional<const GraphPath> BestGraphPath;
+		std::optional<GraphPath> BestGraphPath;
 
 	public:
-		const std::optional<const GraphPath> & GetBestGraphPath() const;
+		const std::optional<GraphPath> & GetBestGraphPath() const;
+		const Priority_t * GetBestPriorities() const;
 
 	public:
 		/*
 			Inicjuje priorytety losowymi danymi
-			"Mikki reset" wza, przydatny przy osadzeniu na minimum lokalnym
+			"Miękki reset" węzła, przydatny przy osadzeniu na minimum lokalnym
 		*/
 		void RandomInitialize();
 
 		/*
-			Krok iteracji wza.
-			Dla posiadanych priotytetw i prdkoci poszukuje kolejnego rozwizania.
-			Jeli takie znajdzie - zapisuje BestPriorities i BestGraphPath oraz zwraca true
-			Jeli nie znajdzie - zwraca false
+			Inicjuje priorytety wartościami SeedPriorities (GetSize() wpisów) zaburzonymi o czynnik losowy z zakresu [1 - Noise; 1 + Noise].
+			Prędkości - losowe, jak w RandomInitialize
 		*/
-		bool Run();
+		void SeedInitialize(const Priority_t * SeedPriorities, const double & Noise);
 
 		/*
-			Wykonuje aktualizacj prdkoci czstki korzystajc z obecnie najlepszego wza w grupie.
+			Krok iteracji węzła.
+			Dla posiadanych priotytetów i prędkości poszukuje kolejnego rozwiązania.
+			Jeśli takie znajdzie - zapisuje BestPriorities i BestGraphPath oraz zwraca true
+			Jeśli nie znajdzie - zwraca false
 
-			Parametry dostrajalne Fi1 Fi2, (warunek: Fi1 + Fi2 > 4) okrelaj moc wpywu kolejno:
-				- lokalnej najlepszej czstki
-				- grupowej najlepszej czstki (ParticleBest)
-			Na kierunek przemieszczania si tej czstki
+			Zadanie wielocelowe - dekodowanie idzie dalej, aż odwiedzi wszystkie cele lub utknie, i zgłasza do Targets ścieżkę do każdego odwiedzonego celu.
+			Rozwiązaniem cząstki pozostaje ścieżka do pierwszego celu zadania
+
+			Scratch - bufory robocze wątku. Dekodowanie, które nie poprawia wyniku, nie wykonuje żadnych alokacji
+			Targets - najlepsze ścieżki fragmentu do celów zadania wielocelowego (nieużywane dla zadania z jednym celem)
+			Counters - liczniki fragmentu: dekodowania, kroki, ślepe zaułki i poprawy
+		*/
+		bool Run(DecodeScratch & Scratch, TargetBest & Targets, PerformanceCounters::Values_t & Counters);
+
+		/*
+			Wykonuje aktualizację prędkości cząstki korzystając z obecnie najlepszego węzła w grupie.
+
+			Parametry dostrajalne Fi1 Fi2, (warunek: Fi1 + Fi2 > 4) określają moc wpływu kolejno:
+				- lokalnej najlepszej cząstki
+				- grupowej najlepszej cząstki (ParticleBestPriorities)
+			Na kierunek przemieszczania się tej cząstki
+
+			Chi - współczynnik wyliczony przez CalculateChi(Fi1, Fi2)
+			RandomFactors - bufor roboczy na 2 * GetSize() czynników losowych R1, R2, losowanych hurtowo dla wszystkich węzłów
+		*/
+		void Update(const double & Fi1, const double & Fi2, const double & Chi, const Priority_t * ParticleBestPriorities, double * RandomFactors);
+
+	public:
+		/*
+			Współczynnik Chi (wzór 2.4) dla parametrów Fi1, Fi2. Zależy tylko od parametrów, więc wystarczy policzyć go raz
 		*/
-		void Update(const double & Fi1, const double & Fi2, const Particle & ParticleBest);
+		static double CalculateChi(const double & Fi1, const double & Fi2);
 };
 
@@ -1,16 +1,45 @@
 #include "ParticleGroup.hpp"
 
+#include <algorithm>
+#include <limits>
+
 #include "Task.hpp"
 #include "Particle.hpp"
 #include "GraphPath.hpp"
 
-ParticleGroup::ParticleGroup(const Task & T, const size_t & ParticleNumber, const size_t & ParticleIterations, const size_t & ParticleBetterSolutionFoundNoCountMax, const double & Fi1, const double & Fi2, const std::mt19937::result_type & Seed):
+ParticleGroup::ParticleGroup(const Task & T, const size_t & ParticleNumber, const size_t & ParticleIterations, const size_t & ParticleBetterSolutionFoundNoCountMax, const double & Fi1, const double & Fi2, const FastRandom::Seed_t & Seed):
 	T(T),
 	ParticleNumber(ParticleNumber), ParticleIterations(ParticleIterations), ParticleBetterSolutionFoundNoCountMax(ParticleBetterSolutionFoundNoCountMax),
 	Fi1(Fi1), Fi2(Fi2),
-	RandomGenerator(Seed)
+	Chi(Particle::CalculateChi(Fi1, Fi2)),
+	RandomGenerator(Seed),
+	Swarm(ParticleNumber, T.GetGraph().GetSize()),
+	ParticlesBetterSolutionFound(new bool[ParticleNumber]),
+	ParticleBestId(ParticleNumber),
+	MigrantPriorities(T.GetGraph().GetSize()),
+	SteadyStateIterations(0), SteadyStateAllocations(0),
+	Targets(T),
+	MigrationInbox(nullptr), MigrationInterval(0), MigrationOutboxRandom(false), MigrationsAccepted(0),
+	Stopped(false),
+	GlobalBestShared(nullptr),
+	CountersShared(nullptr),
+	Trace(nullptr), TraceParticleGroupId(0),
+	SeedPriorities(nullptr), SeedParticleNumber(0),
+	LocalSearch(PathLocalSearch::Mode_t::None)
 {
-
+	// Fragmenty - bufory robocze współdzielone przez cząstki fragmentu
+	const size_t ChunkNumber = (ParticleNumber + ChunkParticleNumber - 1) / ChunkParticleNumber;
+	Chunks.reserve(ChunkNumber);
+	for(size_t ChunkId = 0; ChunkId < ChunkNumber; ChunkId++)
+	{
+		Chunks.push_back({
+			DecodeScratch(T.GetGraph()),
+			TargetBest(T),
+			std::unique_ptr<double[]>(new double[2 * T.GetGraph().GetSize()]),
+			0,
+			PerformanceCounters::Values_t()
+		});
+	}
 }
 
 const Task & ParticleGroup::GetTask() const
@@ -18,83 +47,341 @@ const Task & ParticleGroup::GetTask() const
 	return T;
 }
 
-const std::optional<const Particle> & ParticleGroup::GetParticleBest() const
+const size_t & ParticleGroup::GetParticleNumber() const
+{
+	return ParticleNumber;
+}
+
+const PathLocalSearch::Mode_t & ParticleGroup::GetLocalSearch() const
+{
+	return LocalSearch;
+}
+
+const SwarmMatrix & ParticleGroup::GetSwarm() const
+{
+	return Swarm;
+}
+
+const Particle::Priority_t * ParticleGroup::GetParticleBestPriorities() const
+{
+	return ParticleBestId < ParticleNumber ? Particles[ParticleBestId].GetBestPriorities() : MigrantPriorities.data();
+}
+
+const std::optional<GraphPath> & ParticleGroup::GetParticleBestGraphPath() const
+{
+	return ParticleBestId < ParticleNumber ? Particles[ParticleBestId].GetBestGraphPath() : MigrantGraphPath;
+}
+
+const size_t & ParticleGroup::GetSteadyStateIterations() const
+{
+	return SteadyStateIterations;
+}
+
+const AllocationCounter::Count_t & ParticleGroup::GetSteadyStateAllocations() const
+{
+	return SteadyStateAllocations;
+}
+
+const size_t & ParticleGroup::GetMigrationsAccepted() const
+{
+	return MigrationsAccepted;
+}
+
+const bool & ParticleGroup::IsStopped() const
+{
+	return Stopped;
+}
+
+const PerformanceCounters::Values_t & ParticleGroup::GetCounters() const
+{
+	return Counters;
+}
+
+const TargetBest & ParticleGroup::GetTargets() const
 {
-	return ParticleBest;
+	return Targets;
 }
 
-const ParticleGroup::HistoryEntries_t & ParticleGroup::GetHistoryEntries() const
+void ParticleGroup::SetMigration(MigrationMailbox * Inbox, std::vector<MigrationMailbox *> && Outboxes, const size_t & Interval, const bool & OutboxRandom)
 {
-	return HistoryEntries;
+	MigrationInbox = Inbox;
+	MigrationOutboxes = std::move(Outboxes);
+	MigrationInterval = Interval;
+	MigrationOutboxRandom = OutboxRandom;
 }
 
+void ParticleGroup::SetGlobalBest(GlobalBest * Best)
+{
+	GlobalBestShared = Best;
+}
 
-bool ParticleGroup::Run()
+void ParticleGroup::SetSeed(const Particle::Priority_t * Priorities, const size_t & ParticleNumber)
 {
-	// Inicjalizacja roju czstek
+	SeedPriorities = Priorities;
+	SeedParticleNumber = std::min(ParticleNumber, this->ParticleNumber);
+}
+
+void ParticleGroup::SetLocalSearch(const PathLocalSearch::Mode_t & Mode)
+{
+	LocalSearch = Mode;
+
+	// Ścieżki do celów zadania wielocelowego również skracane przeszukiwaniem lokalnym
+	if(T.IsMultiTarget())
+		for(Chunk_t & Chunk : Chunks)
+			Chunk.Targets.SetLocalSearch(Mode != PathLocalSearch::Mode_t::None);
+}
+
+void ParticleGroup::SetCounters(PerformanceCounters * Shared)
+{
+	CountersShared = Shared;
+}
+
+void ParticleGroup::SetTrace(TraceRing * Ring, const size_t & ParticleGroupId)
+{
+	Trace = Ring;
+	TraceParticleGroupId = ParticleGroupId;
+}
+
+
+bool ParticleGroup::Run(ThreadPool & Pool, StopToken & Stop)
+{
+	// Inicjalizacja roju cząstek - każda cząstka dostaje kolejny, rozłączny strumień liczb losowych
 	Particles.reserve(ParticleNumber);
+	FastRandom ParticleRandomGenerator = RandomGenerator;
 	for(size_t ParticleId = 0; ParticleId < ParticleNumber; ParticleId++)
-		Particles.emplace_back(*this, RandomGenerator);
+	{
+		ParticleRandomGenerator.LongJump();
+		Particles.emplace_back(*this, ParticleRandomGenerator, Swarm, ParticleId);
+	}
+
+	// Cząstki startujące z priorytetów heurystycznych
+	for(size_t ParticleId = 0; ParticleId < SeedParticleNumber; ParticleId++)
+		Particles[ParticleId].SeedInitialize(SeedPriorities, SeedNoise);
 
-	// Gwna ptla programu
+	// Główna pętla programu
 	bool BetterSolutionFound = false;
 
-	// Jeli przez kilka iteracji adna z czstek nie ulegnie poprawie - wykonujemy reinicjalizacj wag
+	// Jeśli przez kilka iteracji żadna z cząstek nie ulegnie poprawie - wykonujemy reinicjalizację wag
 	size_t ParticleBetterSolutionFoundNoCount = 0;
 
+	// Czy najlepsze rozwiązanie grupy zmieniło się od ostatniej wysyłki do innych grup?
+	bool MigrationPending = false;
+
+	// Stan sprawdzania kryteriów zakończenia
+	StopToken::Progress_t StopProgress;
+
 	for(size_t ParticleIteration = 0; ParticleIteration < ParticleIterations; ParticleIteration++)
 	{
-		// Czy ktrakolwiek czsta ulega poprawie?
+		// Zapytanie anulowane lub spełnione kryterium zakończenia (również wykryte przez inną grupę) - kończymy z tym, co już znaleziono
+		if(Stop.Check(StopProgress, ParticleIteration))
+		{
+			Stopped = true;
+			break;
+		}
+
+		// Czy najlepsze rozwiązanie grupy zmieniło się w tej iteracji?
+		bool ParticleBestChanged = false;
+
+		// Czy którakolwiek cząsta uległa poprawie?
 		bool ParticleBetterSolutionFoundAny = false;
 
-		for(size_t ParticleId = 0; ParticleId < ParticleNumber; ParticleId++)
+		// Alokacje iteracji - wątku prowadzącego grupę i fragmentów
+		// Wątek prowadzący liczony jest tylko poza ParallelFor - czekając, wykonuje też pracę innych grup
+		AllocationCounter::Count_t IterationAllocations = 0;
+		AllocationCounter::Count_t IterationAllocationsBegin = AllocationCounter::GetThreadAllocations();
+
+		// Migrant z innej grupy - jeśli jest lepszy, zastępuje najlepsze rozwiązanie grupy i od tej iteracji przyciąga cząstki
+		// Ścieżka jest przenoszona, nie kopiowana
+		if(MigrationInbox)
 		{
-			// Referencja na aktulan czstk
-			Particle & ParticleCurrent = Particles.at(ParticleId);
+			std::unique_ptr<MigrationMailbox::Migrant_t> Migrant = MigrationInbox->Receive();
+			const std::optional<GraphPath> & ParticleBestGraphPath = GetParticleBestGraphPath();
+			if(Migrant && (!ParticleBestGraphPath || Migrant->Path.IsBetterThan(ParticleBestGraphPath.value())))
+			{
+				// Priorytety przejmowane przez zamianę buforów, poprzedni bufor migranta zostanie usunięty razem z nim
+				MigrantPriorities.swap(Migrant->Priorities);
+				MigrantGraphPath.emplace(std::move(Migrant->Path));
+				ParticleBestId = ParticleNumber;
+				BetterSolutionFound = true;
+				ParticleBestChanged = true;
+				MigrationPending = true;
+				++MigrationsAccepted;
 
-			// Uruchom przeszukiwanie i sprawd czy poprawilimy wynik
-			const bool ParticleBetterSolutionFound = ParticleCurrent.Run();
+				// Zapisz poprawę w śladzie zbieżności
+				if(Trace)
+					Trace->Push({ std::chrono::steady_clock::now(), TraceParticleGroupId, ParticleIteration, MigrantGraphPath.value().GetPathWeight() });
+			}
+		}
 
-			// Zapisujemy jeli czstka ulega poprawie
+		// Waga najlepszego rozwiązania grupy sprzed dekodowania - dekodowanie może poprawić rozwiązanie cząstki, na którą wskazuje ParticleBestId
+		GraphPath::PathWeight_t ParticleBestPathWeight = GetParticleBestGraphPath() ? GetParticleBestGraphPath().value().GetPathWeight() : std::numeric_limits<GraphPath::PathWeight_t>::max();
+
+		IterationAllocations += AllocationCounter::GetThreadAllocations() - IterationAllocationsBegin;
+
+		// Dekodowanie wszystkich cząstek - fragmentami, równolegle
+		Pool.ParallelFor(Chunks.size(), [&](const size_t & ChunkId)
+		{
+			Chunk_t & Chunk = Chunks[ChunkId];
+			const AllocationCounter::Count_t ChunkAllocationsBegin = AllocationCounter::GetThreadAllocations();
+			const std::chrono::steady_clock::time_point ChunkBegin = std::chrono::steady_clock::now();
+
+			const size_t ParticleIdEnd = std::min(ParticleNumber, (ChunkId + 1) * ChunkParticleNumber);
+			for(size_t ParticleId = ChunkId * ChunkParticleNumber; ParticleId < ParticleIdEnd; ParticleId++)
+			{
+				// Uruchom przeszukiwanie i sprawdź czy poprawiliśmy wynik
+				ParticlesBetterSolutionFound[ParticleId] = Particles[ParticleId].Run(Chunk.Scratch, Chunk.Targets, Chunk.Counters);
+			}
+
+			Chunk.Counters.DecodeNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - ChunkBegin).count();
+			Chunk.Allocations += AllocationCounter::GetThreadAllocations() - ChunkAllocationsBegin;
+		});
+
+		IterationAllocationsBegin = AllocationCounter::GetThreadAllocations();
+
+		// Zadanie wielocelowe - ścieżki do celów z fragmentów, które poprawiły którąś z nich w tej iteracji
+		if(T.IsMultiTarget())
+		{
+			for(const Chunk_t & Chunk : Chunks)
+				if(Chunk.Counters.TargetImprovements > 0)
+					Targets.Merge(Chunk.Targets);
+		}
+
+		// Wybór najlepszego rozwiązania grupy - w kolejności cząstek, niezależnie od kolejności wykonania fragmentów
+		for(size_t ParticleId = 0; ParticleId < ParticleNumber; ParticleId++)
+		{
+			// Referencja na aktulaną cząstkę
+			const Particle & ParticleCurrent = Particles[ParticleId];
+			const bool ParticleBetterSolutionFound = ParticlesBetterSolutionFound[ParticleId];
+
+			// Zapisujemy jeśli cząstka uległa poprawie
 			ParticleBetterSolutionFoundAny = ParticleBetterSolutionFoundAny || ParticleBetterSolutionFound;
 
-			// Jeli czstka znalaza lepsz ciek - sprawd, czy nie najlepsz
-			// Jeli poprawiamy wynik otoczenia - zapisujemy go
-			if(ParticleBetterSolutionFound && (!ParticleBest || ParticleCurrent.GetBestGraphPath().value().IsBetterThan(ParticleBest.value().GetBestGraphPath().value())))
+			// Jeśli cząstka znalazła lepszą ścieżkę - sprawdź, czy nie najlepszą
+			// Jeśli poprawiamy wynik otoczenia - zapisujemy go
+			if(ParticleBetterSolutionFound && ParticleCurrent.GetBestGraphPath().value().GetPathWeight() < ParticleBestPathWeight)
 			{
-				ParticleBest.emplace(ParticleCurrent);
+				// Bez kopii - zapamiętujemy tylko numer cząstki
+				ParticleBestId = ParticleId;
+				ParticleBestPathWeight = ParticleCurrent.GetBestGraphPath().value().GetPathWeight();
 				BetterSolutionFound = true;
+				ParticleBestChanged = true;
+				MigrationPending = true;
 
-				// Zapisz histori poprawy
-				HistoryEntries.push_back({
-					std::chrono::steady_clock::now(),
-					ParticleIteration,
-					ParticleBest.value().GetBestGraphPath().value().GetPathWeight()
-				});
+				// Zapisz poprawę w śladzie zbieżności
+				if(Trace)
+					Trace->Push({ std::chrono::steady_clock::now(), TraceParticleGroupId, ParticleIteration, ParticleBestPathWeight });
 			}
+		}
+
+		// Najlepsze rozwiązanie grupy po wyborze - niezmienne do następnej iteracji
+		const std::optional<GraphPath> & ParticleBestGraphPath = GetParticleBestGraphPath();
+		const Particle::Priority_t * ParticleBestPriorities = GetParticleBestPriorities();
+
+		// Poprawa widoczna dla kryteriów zakończenia wszystkich grup
+		if(ParticleBestChanged)
+			Stop.ReportPathWeight(ParticleBestGraphPath.value().GetPathWeight());
+
+		// Publikacja najlepszego rozwiązania grupy dla pozostałych grup
+		// Sprawdzane w każdej iteracji, nie tylko po poprawie - publikacja mogła się wcześniej nie udać (brak wolnej migawki)
+		if(GlobalBestShared && ParticleBestGraphPath && ParticleBestGraphPath.value().GetPathWeight() < GlobalBestShared->GetPathWeight())
+			GlobalBestShared->Publish(ParticleBestGraphPath.value().GetPathWeight(), ParticleBestPriorities);
 
-			// Krok aktualizacji czstki danymi najlepszej czstki (jeli taka istnieje)
-			if(ParticleBest)
+		// Krok aktualizacji cząstek danymi najlepszej cząstki grupy lub wszystkich grup (jeśli taka istnieje) - fragmentami, równolegle
+		if(ParticleBestGraphPath || (GlobalBestShared && GlobalBestShared->GetPathWeight() != std::numeric_limits<GraphPath::PathWeight_t>::max()))
+		{
+			IterationAllocations += AllocationCounter::GetThreadAllocations() - IterationAllocationsBegin;
+
+			Pool.ParallelFor(Chunks.size(), [&](const size_t & ChunkId)
 			{
-				ParticleCurrent.Update(
-					Fi1,
-					Fi2,
-					ParticleBest.value()
-				);
+				Chunk_t & Chunk = Chunks[ChunkId];
+				const AllocationCounter::Count_t ChunkAllocationsBegin = AllocationCounter::GetThreadAllocations();
+				const std::chrono::steady_clock::time_point ChunkBegin = std::chrono::steady_clock::now();
+
+				// Najświeższe rozwiązanie wszystkich grup - jeśli lepsze od rozwiązania grupy, przyciąga cząstki fragmentu
+				const GlobalBest::Snapshot_t * Snapshot = GlobalBestShared ? GlobalBestShared->Acquire() : nullptr;
+				const bool SnapshotBetter = Snapshot && (!ParticleBestGraphPath || Snapshot->PathWeight < ParticleBestGraphPath.value().GetPathWeight());
+				const Particle::Priority_t * AttractorPriorities = SnapshotBetter ? Snapshot->Priorities.get() : ParticleBestPriorities;
+
+				const size_t ParticleIdEnd = std::min(ParticleNumber, (ChunkId + 1) * ChunkParticleNumber);
+				for(size_t ParticleId = ChunkId * ChunkParticleNumber; ParticleId < ParticleIdEnd; ParticleId++)
+				{
+					Particles[ParticleId].Update(
+						Fi1,
+						Fi2,
+						Chi,
+						AttractorPriorities,
+						Chunk.UpdateRandomFactors.get()
+					);
+				}
+
+				if(GlobalBestShared)
+					GlobalBestShared->Release(Snapshot);
+
+				Chunk.Counters.UpdateNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - ChunkBegin).count();
+				Chunk.Allocations += AllocationCounter::GetThreadAllocations() - ChunkAllocationsBegin;
+			});
+
+			IterationAllocationsBegin = AllocationCounter::GetThreadAllocations();
+		}
+
+		// Wysyłka najlepszego rozwiązania do innych grup, co MigrationInterval iteracji
+		const bool MigrationSend = MigrationInterval > 0 && !MigrationOutboxes.empty() && MigrationPending && (ParticleIteration + 1) % MigrationInterval == 0;
+		if(MigrationSend)
+		{
+			if(MigrationOutboxRandom)
+			{
+				double OutboxRandom;
+				RandomGenerator.Uniform(&OutboxRandom, 1);
+				const size_t OutboxId = std::min(MigrationOutboxes.size() - 1, (size_t) (OutboxRandom * MigrationOutboxes.size()));
+				MigrationOutboxes[OutboxId]->Send(std::unique_ptr<MigrationMailbox::Migrant_t>(new MigrationMailbox::Migrant_t{ std::vector<Particle::Priority_t>(ParticleBestPriorities, ParticleBestPriorities + T.GetGraph().GetSize()), ParticleBestGraphPath.value() }));
+			}
+			else
+			{
+				for(MigrationMailbox * Outbox : MigrationOutboxes)
+					Outbox->Send(std::unique_ptr<MigrationMailbox::Migrant_t>(new MigrationMailbox::Migrant_t{ std::vector<Particle::Priority_t>(ParticleBestPriorities, ParticleBestPriorities + T.GetGraph().GetSize()), ParticleBestGraphPath.value() }));
 			}
+
+			MigrationPending = false;
 		}
 
-		// Czy jakakolwiek czastka ulega poprawie?
+		// Domknięcie licznika alokacji i liczników wydajności iteracji
+		IterationAllocations += AllocationCounter::GetThreadAllocations() - IterationAllocationsBegin;
+		PerformanceCounters::Values_t IterationCounters;
+		IterationCounters.Iterations = 1;
+		for(Chunk_t & Chunk : Chunks)
+		{
+			IterationAllocations += Chunk.Allocations;
+			Chunk.Allocations = 0;
+
+			IterationCounters += Chunk.Counters;
+			Chunk.Counters = PerformanceCounters::Values_t();
+		}
+
+		// Czy jakakolwiek czastka uległa poprawie?
 		if(!ParticleBetterSolutionFoundAny)
 		{
-			// adna z czstek nie ulega poprawie - zwikszamy licznik martwych iteracji
+			// Iteracja stanu ustalonego - zapisujemy ile alokacji wykonała
+			// Wysyłka migrantów i poprawa ścieżki do celu zadania wielocelowego alokują kopie ścieżek - takich iteracji nie liczymy.
+			// Przyjęcie migranta nie alokuje (przeniesienie ścieżki, zamiana buforów)
+			if(!MigrationSend && IterationCounters.TargetImprovements == 0)
+			{
+				++SteadyStateIterations;
+				SteadyStateAllocations += IterationAllocations;
+			}
+
+			// Żadna z cząstek nie uległa poprawie - zwiększamy licznik martwych iteracji
 			++ParticleBetterSolutionFoundNoCount;
 
-			// Jeli licznik osign du warto - zerujemy go i reinicjalizujemy czstki
+			// Jeśli licznik osiągnął dużą wartość - zerujemy go i reinicjalizujemy cząstki - fragmentami, równolegle (każda cząstka losuje z własnego strumienia)
 			if(ParticleBetterSolutionFoundNoCount >= ParticleBetterSolutionFoundNoCountMax)
 			{
-				for(size_t ParticleId = 0; ParticleId < ParticleNumber; ParticleId++)
-					Particles.at(ParticleId).RandomInitialize();
+				Pool.ParallelFor(Chunks.size(), [&](const size_t & ChunkId)
+				{
+					const size_t ParticleIdEnd = std::min(ParticleNumber, (ChunkId + 1) * ChunkParticleNumber);
+					for(size_t ParticleId = ChunkId * ChunkParticleNumber; ParticleId < ParticleIdEnd; ParticleId++)
+						Particles[ParticleId].RandomInitialize();
+				});
+				++IterationCounters.Reinitializations;
 
 				// Zaczynamy liczenie od 0
 				ParticleBetterSolutionFoundNoCount = 0;
@@ -105,6 +392,11 @@ bool ParticleGroup::Run()
 			// Tak - zerujemy licznik
 			ParticleBetterSolutionFoundNoCount = 0;
 		}
+
+		// Liczniki iteracji - do sumy grupy i, jednym zgłoszeniem, do liczników wszystkich grup
+		Counters += IterationCounters;
+		if(CountersShared)
+			CountersShared->Add(IterationCounters);
 	}
 
 	return BetterSolutionFound;
@@ -3,28 +3,41 @@
 #include <vector>
 #include <optional>
 #include <chrono>
-#include <random>
 
 #include "Task.hpp"
 #include "Particle.hpp"
 #include "GraphPath.hpp"
+#include "DecodeScratch.hpp"
+#include "TargetBest.hpp"
+#include "AllocationCounter.hpp"
+#include "FastRandom.hpp"
+#include "SwarmMatrix.hpp"
+#include "MigrationMailbox.hpp"
+#include "GlobalBest.hpp"
+#include "PathLocalSearch.hpp"
+#include "ThreadPool.hpp"
+#include "StopToken.hpp"
+#include "PerformanceCounters.hpp"
+#include "TraceRing.hpp"
 
 
 /*
-	Klasa kontenera roju czstek
+	Klasa kontenera roju cząstek
 
-	Lokalna grupa czstek, ktr mona uruchomi na jednym wtku. Wszystkie zmienne przyjmowane jako referencje do staych obiektw - w zaoeniu gwarantuje to wtkow bezpieczno.
+	Lokalna grupa cząstek. Wszystkie zmienne przyjmowane jako referencje do stałych obiektów - w założeniu gwarantuje to wątkową bezpieczność.
+
+	Cząstki podzielone są na fragmenty (Chunk_t) po ChunkParticleNumber cząstek, wykonywane równolegle na puli wątków.
+	Iteracja jest synchroniczna: dekodowanie wszystkich cząstek -> wybór najlepszego rozwiązania grupy (w kolejności cząstek) -> aktualizacja wszystkich cząstek.
+	Każdy fragment ma własne bufory, a każda cząstka własny strumień liczb losowych, więc wynik nie zależy od tego, który wątek wykona który fragment.
 */
 class ParticleGroup
 {
 	public:
-		struct HistoryEntry_t
-		{
-			std::chrono::steady_clock::time_point TimePoint;
-			size_t ParticleIteration;
-			GraphPath::PathWeight_t PathWeight;
-		};
-		typedef std::list<HistoryEntry_t> HistoryEntries_t;
+		// Liczba cząstek we fragmencie - jednostce pracy puli wątków
+		static const size_t ChunkParticleNumber = 4;
+
+		// Względne zaburzenie priorytetów cząstek inicjowanych przez SetSeed - cząstki startują blisko, ale nie w tym samym punkcie
+		static constexpr double SeedNoise = 0.1;
 
 	public:
 		/*
@@ -32,15 +45,15 @@ class ParticleGroup
 
 			T - Zadanie optymalizacji
 
-			ParticleNumber - Liczba czstek
+			ParticleNumber - Liczba cząstek
 			ParticleIterations - Liczba iteracji
-			ParticleBetterSolutionFoundNoCountMax - po ilu penych iteracjach bez poprawy jakiejkolwiek czstki wykona reset wag?
+			ParticleBetterSolutionFoundNoCountMax - po ilu pełnych iteracjach bez poprawy jakiejkolwiek cząstki wykonać reset wag?
 
-			Fi1, Fi2 - Parametry dostrajalne metody aktualizacji cieki pojedynczej czstki. Opisane w Particle.hpp
+			Fi1, Fi2 - Parametry dostrajalne metody aktualizacji ścieżki pojedynczej cząstki. Opisane w Particle.hpp
 
-			Seed - warto inicjujca generator liczb losowych
+			Seed - wartość inicjująca generator liczb losowych
 		*/
-		ParticleGroup(const Task & T, const size_t & ParticleNumber, const size_t & ParticleIterations, const size_t & ParticleBetterSolutionFoundNoCountMax, const double & Fi1, const double & Fi2, const std::mt19937::result_type & Seed);
+		ParticleGroup(const Task & T, const size_t & ParticleNumber, const size_t & ParticleIterations, const size_t & ParticleBetterSolutionFoundNoCountMax, const double & Fi1, const double & Fi2, const FastRandom::Seed_t & Seed);
 
 	private:
 		const Task & T;
@@ -52,38 +65,207 @@ class ParticleGroup
 		const double Fi1;
 		const double Fi2;
 
+		/*
+			Współczynnik Chi dla Fi1, Fi2 - liczony raz, w konstruktorze
+		*/
+		const double Chi;
+
 	private:
 		/*
-			Generator liczb losowych
+			Generator liczb losowych grupy (wybór adresata migracji) i źródło strumieni cząstek - kolejne strumienie po FastRandom::LongJump
 		*/
-		std::mt19937 RandomGenerator;
+		FastRandom RandomGenerator;
 
 		/*
-			Kontener czstek algorytmu, inicjowany w konstuktorze.
+			Fragment grupy - stan roboczy współdzielony przez jego cząstki
+		*/
+		struct Chunk_t
+		{
+			// Bufory robocze dekodowania
+			DecodeScratch Scratch;
+
+			// Najlepsze ścieżki fragmentu do celów zadania wielocelowego
+			TargetBest Targets;
+
+			// Bufor na czynniki losowe aktualizacji cząstki (2 * rozmiar grafu) - losuje je generator cząstki
+			std::unique_ptr<double[]> UpdateRandomFactors;
+
+			// Alokacje wykonane przez fragment w bieżącej iteracji
+			AllocationCounter::Count_t Allocations;
+
+			// Liczniki wydajności fragmentu w bieżącej iteracji - zapisywane przy każdym dekodowaniu, więc w osobnej linii pamięci podręcznej
+			alignas(64) PerformanceCounters::Values_t Counters;
+		};
+		std::vector<Chunk_t> Chunks; /* ceil(ParticleNumber / ChunkParticleNumber) */
+
+		/*
+			Stan wszystkich cząstek (położenia, prędkości, najlepsze położenia) w jednym ciągłym bloku
+		*/
+		SwarmMatrix Swarm;
+
+		/*
+			Kontener cząstek algorytmu - widoków na wiersze Swarm, inicjowany w Run().
 		*/
 		std::vector<Particle> Particles; /* ParticleNumber */
 
 		/*
-			Zatrzanita instancja aktualnie najlepszej czstki
+			Wynik dekodowania cząstek w bieżącej iteracji - czy cząstka poprawiła swoje rozwiązanie
+		*/
+		std::unique_ptr<bool[]> ParticlesBetterSolutionFound; /* ParticleNumber */
+
+		/*
+			Najlepsze rozwiązanie grupy - numer cząstki, której najlepsze rozwiązanie jest zarazem najlepszym rozwiązaniem grupy.
+			Najlepsze rozwiązanie cząstki zmienia się tylko na lepsze, więc pozostaje najlepszym rozwiązaniem grupy, dopóki nie pobije go inna cząstka.
+			Wystarczy więc zapamiętać numer cząstki - bez kopiowania priorytetów i ścieżki przy każdej poprawie.
+
+			ParticleBestId == ParticleNumber - najlepszym rozwiązaniem jest przyjęty migrant (MigrantPriorities, MigrantGraphPath) lub brak rozwiązania
+		*/
+		size_t ParticleBestId;
+
+		/*
+			Przyjęty migrant. MigrantPriorities ma sens tylko gdy (bool) MigrantGraphPath
+		*/
+		std::vector<Particle::Priority_t> MigrantPriorities; /* T.GetGraph().GetSize() */
+		std::optional<GraphPath> MigrantGraphPath;
+
+		/*
+			Liczba iteracji, w których żadna cząstka nie uległa poprawie (stan ustalony) oraz liczba alokacji wykonanych w ich trakcie.
+			Dekodowanie i aktualizacja nie alokują pamięci, więc SteadyStateAllocations powinno wynosić 0.
+			Bez liczników alokacji w programie (AllocationCounter::IsAvailable()) SteadyStateAllocations zawsze wynosi 0.
+		*/
+		size_t SteadyStateIterations;
+		AllocationCounter::Count_t SteadyStateAllocations;
+
+		/*
+			Liczniki wydajności grupy - suma liczników fragmentów ze wszystkich iteracji
+		*/
+		PerformanceCounters::Values_t Counters;
+
+		/*
+			Zadanie wielocelowe - najlepsze ścieżki grupy do celów, scalane po każdym dekodowaniu z fragmentów, które je poprawiły
+		*/
+		TargetBest Targets;
+
+	private:
+		/*
+			Migracja najlepszych rozwiązań pomiędzy grupami (SetMigration), domyślnie wyłączona
+		*/
+		MigrationMailbox * MigrationInbox;
+		std::vector<MigrationMailbox *> MigrationOutboxes;
+		size_t MigrationInterval;
+		bool MigrationOutboxRandom;
+
+		/*
+			Liczba przyjętych migrantów - lepszych od najlepszego rozwiązania grupy
 		*/
-		std::optional<const Particle> ParticleBest;
+		size_t MigrationsAccepted;
 
 		/*
-			Historia wag w czasie
+			Czy Run() zakończono (anulowanie lub kryterium zakończenia StopToken) przed wykonaniem wszystkich iteracji
 		*/
-		HistoryEntries_t HistoryEntries;
+		bool Stopped;
+
+		/*
+			Najlepsze rozwiązanie wszystkich grup (SetGlobalBest), domyślnie brak - grupa korzysta tylko z własnego najlepszego rozwiązania
+		*/
+		GlobalBest * GlobalBestShared;
+
+		/*
+			Liczniki wydajności wszystkich grup (SetCounters), domyślnie brak
+		*/
+		PerformanceCounters * CountersShared;
+
+		/*
+			Ślad zbieżności (SetTrace) - bufor, do którego trafia każda poprawa najlepszego rozwiązania grupy, i numer grupy we wpisach. Domyślnie brak
+		*/
+		TraceRing * Trace;
+		size_t TraceParticleGroupId;
+
+		/*
+			Priorytety początkowe części cząstek (SetSeed), domyślnie brak - wszystkie cząstki losowe
+		*/
+		const Particle::Priority_t * SeedPriorities;
+		size_t SeedParticleNumber;
+
+		/*
+			Przeszukiwanie lokalne ścieżek cząstek (SetLocalSearch), domyślnie wyłączone
+		*/
+		PathLocalSearch::Mode_t LocalSearch;
 
 	public:
 		const Task & GetTask() const;
-		const std::optional<const Particle> & GetParticleBest() const;
-		const HistoryEntries_t & GetHistoryEntries() const;
+		const size_t & GetParticleNumber() const;
+		const PathLocalSearch::Mode_t & GetLocalSearch() const;
+		const SwarmMatrix & GetSwarm() const;
+
+		/*
+			Najlepsze rozwiązanie grupy - priorytety (GetTask().GetGraph().GetSize() wpisów, ważne tylko gdy (bool) GetParticleBestGraphPath()) i ścieżka.
+			Wskazują na dane cząstki lub migranta - są ważne do kolejnej iteracji
+		*/
+		const Particle::Priority_t * GetParticleBestPriorities() const;
+		const std::optional<GraphPath> & GetParticleBestGraphPath() const;
+
+		const size_t & GetSteadyStateIterations() const;
+		const AllocationCounter::Count_t & GetSteadyStateAllocations() const;
+		const size_t & GetMigrationsAccepted() const;
+		const bool & IsStopped() const;
+		const PerformanceCounters::Values_t & GetCounters() const;
+		const TargetBest & GetTargets() const;
 
 	public:
 		/*
-			Gwna ptla programu.
+			Włącza migrację (model wyspowy). Wywoływane przed Run()
+
+			Inbox - skrzynka tej grupy. Przed każdą iteracją migrant lepszy od najlepszego rozwiązania grupy zastępuje je
+			Outboxes - skrzynki grup docelowych
+			Interval - co ile iteracji wysyłać najlepsze rozwiązanie (tylko jeśli zmieniło się od ostatniej wysyłki)
+			OutboxRandom - false: wysyłka do wszystkich Outboxes, true: do jednej, losowej
+		*/
+		void SetMigration(MigrationMailbox * Inbox, std::vector<MigrationMailbox *> && Outboxes, const size_t & Interval, const bool & OutboxRandom);
+
+		/*
+			Włącza asynchroniczny wariant PSO. Wywoływane przed Run()
+
+			Best - najlepsze rozwiązanie wszystkich grup. Grupa publikuje w nim swoje najlepsze rozwiązanie, jeśli jest lepsze,
+			a każdy fragment przy aktualizacji cząstek sprawdza, czy nie przyciągać ich do niego zamiast do najlepszego rozwiązania grupy.
+			Wynik zależy wtedy od tempa pracy pozostałych grup.
+		*/
+		void SetGlobalBest(GlobalBest * Best);
+
+		/*
+			Inicjuje pierwsze ParticleNumber cząstek priorytetami Priorities (zaburzonymi o SeedNoise) zamiast losowymi. Wywoływane przed Run()
+			Priorities muszą żyć do końca Run()
+		*/
+		void SetSeed(const Particle::Priority_t * Priorities, const size_t & ParticleNumber);
+
+		/*
+			Włącza przeszukiwanie lokalne (PathLocalSearch) każdej ścieżki zdekodowanej przez cząstkę. Wywoływane przed Run()
+			Mode_t::PathAndPriorities - ścieżka poprawiająca wynik cząstki jest dodatkowo zapisywana w jej priorytetach
+		*/
+		void SetLocalSearch(const PathLocalSearch::Mode_t & Mode);
+
+		/*
+			Włącza zgłaszanie liczników wydajności grupy do Shared - po każdej iteracji. Wywoływane przed Run()
+			Shared musi żyć do końca Run()
+		*/
+		void SetCounters(PerformanceCounters * Shared);
+
+		/*
+			Włącza zapis śladu zbieżności - poprawy najlepszego rozwiązania grupy (czas, iteracja, waga) trafiają do Ring, wpisy oznaczone numerem ParticleGroupId.
+			Zapis nie alokuje i nie czeka - przy pełnym buforze wpis jest odrzucany. Wywoływane przed Run(), Ring musi żyć do końca Run()
+		*/
+		void SetTrace(TraceRing * Ring, const size_t & ParticleGroupId);
+
+	public:
+		/*
+			Główna pętla programu.
+
+			Pool - pula wątków, na której wykonywane są fragmenty grupy. Wątek wywołujący również wykonuje fragmenty
+			Stop - żądanie przerwania i kryteria zakończenia, sprawdzane przed każdą iteracją. Grupa zgłasza do niego poprawy swojego najlepszego rozwiązania.
+			Przerwana grupa zachowuje najlepsze dotychczasowe rozwiązanie
 
-			Zwraca czy znaleziono cho jedno rozwizanie problemu
+			Zwraca czy znaleziono choć jedno rozwiązanie problemu
 		*/
-		bool Run();
+		bool Run(ThreadPool & Pool, StopToken & Stop);
 };
 
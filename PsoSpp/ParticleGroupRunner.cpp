@@ -1,99 +1,346 @@
 #include "ParticleGroupRunner.hpp"
 
+#include <cmath>
+#include <limits>
 #include <random>
+#include <stdexcept>
 
-ParticleGroupRunner::ParticleGroupRunner(const Task & T, const size_t & ParticleGroupNumber, const size_t & ParticleNumberTotal, const size_t & ParticleIterations, const size_t & ParticleBetterSolutionFoundNoCountMax, const double & Fi1, const double & Fi2):
-	T(T), 
+#include "ShortestPathSolver.hpp"
+#include "TargetBest.hpp"
+
+const uint32_t ParticleGroupRunner::RandomSeedDefault;
+
+ParticleGroupRunner::ParticleGroupRunner(ThreadPool & Pool, const Task & T, const size_t & ParticleGroupNumber, const size_t & ParticleNumberTotal, const size_t & ParticleIterations, const size_t & ParticleBetterSolutionFoundNoCountMax, const double & Fi1, const double & Fi2, const size_t & MigrationInterval, const MigrationTopology_t & MigrationTopology, const bool & GlobalBestAsync, const double & SeedFraction, const PathLocalSearch::Mode_t & LocalSearch):
+	Pool(Pool), T(T),
 	ParticleGroupNumber(ParticleGroupNumber), ParticleNumberTotal(ParticleNumberTotal), ParticleIterations(ParticleIterations), ParticleBetterSolutionFoundNoCountMax(ParticleBetterSolutionFoundNoCountMax),
-	Fi1(Fi1), Fi2(Fi2)
+	Fi1(Fi1), Fi2(Fi2),
+	MigrationInterval(MigrationInterval), MigrationTopology(MigrationTopology),
+	GlobalBestAsync(GlobalBestAsync),
+	SeedFraction(SeedFraction),
+	LocalSearch(LocalSearch),
+	Trace(nullptr),
+	RandomSeed(RandomSeedDefault),
+	GlobalBestExternal(nullptr),
+	ProcessInbox(nullptr), ProcessOutbox(nullptr),
+	Placement(nullptr)
+{
+
+}
+
+void ParticleGroupRunner::SetTrace(TraceWriter * Trace)
 {
+	this->Trace = Trace;
+}
+
+void ParticleGroupRunner::SetRandomSeed(const uint32_t & Seed)
+{
+	RandomSeed = Seed;
+}
 
+void ParticleGroupRunner::SetGlobalBest(GlobalBest * Best)
+{
+	GlobalBestExternal = Best;
+}
+
+void ParticleGroupRunner::SetProcessMigration(MigrationMailbox * Inbox, MigrationMailbox * Outbox)
+{
+	ProcessInbox = Inbox;
+	ProcessOutbox = Outbox;
+}
+
+void ParticleGroupRunner::SetPlacement(NumaPlacement * Placement)
+{
+	// Kopie grafu węzłów muszą odpowiadać grafowi zadania
+	if(Placement && &Placement->GetGraphSource() != &T.GetGraph())
+		throw std::invalid_argument("&Placement->GetGraphSource() != &T.GetGraph()");
+
+	this->Placement = Placement;
 }
 
 ParticleGroupRunner::RunResult_t ParticleGroupRunner::Run()
 {
-	// Jeli uytkownik nie poda liczby wtkw - dobieramy automatycznie
-	const size_t ParticleGroupNumberReal = ParticleGroupNumber ? ParticleGroupNumber : std::thread::hardware_concurrency();
+	// Bez kryteriów zakończenia - żądania nikt nie zgłosi
+	StopToken Stop;
+	return Run(Stop);
+}
+
+ParticleGroupRunner::RunResult_t ParticleGroupRunner::Run(StopToken & Stop)
+{
+	// Liczniki tylko do wyniku - nikt ich nie odczytuje w trakcie
+	PerformanceCounters Counters;
+	return Run(Stop, Counters);
+}
+
+ParticleGroupRunner::RunResult_t ParticleGroupRunner::Run(StopToken & Stop, PerformanceCounters & Counters)
+{
+	// Wątki wykonujące grupy - pula z konstruktora lub pule węzłów NUMA
+	const size_t ThreadNumber = Placement ? Placement->GetThreadNumber() : Pool.GetThreadNumber();
+	const size_t NodeNumber = Placement ? Placement->GetNodeNumber() : 1;
+
+	// Jeśli użytkownik nie podał liczby grup - po jednej na wątek puli. Nie więcej grup niż cząstek
+	const size_t ParticleGroupNumberReal = std::max<size_t>(1, std::min(ParticleGroupNumber ? ParticleGroupNumber : ThreadNumber, ParticleNumberTotal));
+
+	// Kontener na grupy cząstek
+	std::vector<ParticleGroup> ParticleGroups;
+	ParticleGroups.reserve(ParticleGroupNumberReal);
 
-	// Liczba czstek na grup
-	const size_t ParticleNumber = ParticleNumberTotal / ParticleGroupNumberReal;
+	std::mt19937 RandomGenerator(RandomSeed);
 
-	// Struktura pojedynczej grupy czstek
-	struct ParticleGroup_t
+	// Bufory śladu zbieżności grup - należą do Trace
+	std::vector<TraceRing *> TraceRings;
+
+	// Zamknięcie buforów przy każdym wyjściu z Run, również przez wyjątek z tworzenia lub obliczeń grup - inaczej Trace opróżniałby je aż do swojego zniszczenia
+	struct TraceRingsCloser_t
 	{
-		// Instancja grupy czstek
-		ParticleGroup Instance;
-		
-		// Wtek
-		std::thread Thread;
-	};
+		std::vector<TraceRing *> & TraceRings;
 
-	// Kontener na grupy czstek przypisane do wtkw
-	std::list<ParticleGroup_t> ParticleGroups;
+		~TraceRingsCloser_t()
+		{
+			for(TraceRing * Ring : TraceRings)
+				Ring->Close();
+			TraceRings.clear();
+		}
+	} TraceRingsCloser{ TraceRings };
 
-	std::mt19937 RandomGenerator;
+	// Zadanie na grafie każdego węzła NUMA - grupy czytają kopię grafu swojego węzła
+	std::vector<Task> NodeTasks;
+	if(Placement)
+	{
+		NodeTasks.reserve(NodeNumber);
+		for(size_t Node = 0; Node < NodeNumber; Node++)
+			NodeTasks.emplace_back(Placement->GetGraph(Node), T.GetVertexIndexStart(), T.GetVertexIndexEnds());
+	}
 
-	// Tworzymy czstki
+	// Tworzymy cząstki - reszta z dzielenia rozdzielana po jednej cząstce na pierwsze grupy
 	for(size_t I = 0; I < ParticleGroupNumberReal; I++)
 	{
-		ParticleGroups.emplace_back(ParticleGroup_t {
-			// Stwrz grup czstek
-			ParticleGroup
-			{
-				T,
+		const size_t ParticleNumber = ParticleNumberTotal / ParticleGroupNumberReal + (I < ParticleNumberTotal % ParticleGroupNumberReal ? 1 : 0);
+
+		const FastRandom::Seed_t ParticleGroupSeed = RandomGenerator();
+
+		/*
+			Grupa węzła NUMA tworzona jest przez wątek węzła - macierz roju i bufory dekodowania trafiają do jego pamięci.
+			Bez rozmieszczenia - na wątku wywołującym, jak dotychczas
+		*/
+		const auto CreateParticleGroup = [&](const Task & ParticleGroupTask)
+		{
+			ParticleGroups.emplace_back(
+				ParticleGroupTask,
 				ParticleNumber,
 				ParticleIterations,
 				ParticleBetterSolutionFoundNoCountMax,
 				Fi1,
 				Fi2,
-				RandomGenerator()
-			},
+				ParticleGroupSeed
+			);
+		};
 
-			// Stwrz pusty wtek
-			std::thread()
-		});
+		if(Placement)
+			Placement->RunOnNode(I % NodeNumber, [&]() { CreateParticleGroup(NodeTasks[I % NodeNumber]); });
+		else
+			CreateParticleGroup(T);
+
+		ParticleGroups.back().SetLocalSearch(LocalSearch);
+		ParticleGroups.back().SetCounters(&Counters);
+		if(Trace)
+		{
+			TraceRings.push_back(&Trace->CreateRing());
+			ParticleGroups.back().SetTrace(TraceRings.back(), I);
+		}
 	}
 
-	// Uruchom wtki
-	for(ParticleGroup_t & PG : ParticleGroups)
-		PG.Thread = std::thread(&ParticleGroup::Run, &(PG.Instance));
+	// Skrzynki migracji - po jednej na grupę, żyją dłużej niż wątki. Skrzynką pierwszej grupy może być skrzynka od innych procesów
+	std::unique_ptr<MigrationMailbox[]> MigrationMailboxes(new MigrationMailbox[ParticleGroupNumberReal]);
+	const bool MigrationProcess = ProcessInbox && ProcessOutbox;
 
-	// Poczekaj na zakoczenie
-	for(ParticleGroup_t & PG : ParticleGroups)
-		PG.Thread.join();
+	std::vector<MigrationMailbox *> Inboxes(ParticleGroupNumberReal);
+	for(size_t ParticleGroupId = 0; ParticleGroupId < ParticleGroupNumberReal; ParticleGroupId++)
+		Inboxes[ParticleGroupId] = &MigrationMailboxes[ParticleGroupId];
+	if(MigrationProcess)
+		Inboxes.front() = ProcessInbox;
 
-	// Aktualnie najlepszy wynik
-	std::optional<const Particle> ParticleBest;
+	if(MigrationInterval > 0 && MigrationTopology != MigrationTopology_t::None && (ParticleGroupNumberReal > 1 || MigrationProcess))
+	{
+		size_t ParticleGroupId = 0;
+		for(ParticleGroup & PG : ParticleGroups)
+		{
+			std::vector<MigrationMailbox *> Outboxes;
+			if(MigrationTopology == MigrationTopology_t::Ring)
+			{
+				if(ParticleGroupNumberReal > 1)
+					Outboxes.push_back(Inboxes[(ParticleGroupId + 1) % ParticleGroupNumberReal]);
+			}
+			else
+			{
+				for(size_t ParticleGroupTargetId = 0; ParticleGroupTargetId < ParticleGroupNumberReal; ParticleGroupTargetId++)
+					if(ParticleGroupTargetId != ParticleGroupId)
+						Outboxes.push_back(Inboxes[ParticleGroupTargetId]);
+			}
 
-	// Historia wynikw poszczeglnych czstek
-	std::vector<ParticleGroup::HistoryEntries_t> HistoryEntries;
-	HistoryEntries.reserve(ParticleGroups.size());
+			// Pierścień procesów - do następnego procesu wysyła ostatnia grupa
+			if(MigrationProcess && (MigrationTopology != MigrationTopology_t::Ring || ParticleGroupId + 1 == ParticleGroupNumberReal))
+				Outboxes.push_back(ProcessOutbox);
 
-	// Przejd przez wszystkie czstki i pobierz wyniki
-	for(ParticleGroup_t & PG : ParticleGroups)
+			PG.SetMigration(Inboxes[ParticleGroupId], std::move(Outboxes), MigrationInterval, MigrationTopology == MigrationTopology_t::Random);
+			++ParticleGroupId;
+		}
+	}
+
+	// Wspólne najlepsze rozwiązanie - migawek o dwie więcej niż wątków, które mogą jednocześnie aktualizować cząstki (wątki puli + wątek wywołujący)
+	std::unique_ptr<GlobalBest> GlobalBestShared;
+	if(GlobalBestAsync && !GlobalBestExternal)
+		GlobalBestShared.reset(new GlobalBest(T.GetGraph().GetSize(), ThreadNumber + 3));
+
+	if(GlobalBest * Best = GlobalBestExternal ? GlobalBestExternal : GlobalBestShared.get())
+		for(ParticleGroup & PG : ParticleGroups)
+			PG.SetGlobalBest(Best);
+
+	// Priorytety początkowe z odległości do końca zadania - wspólne dla wszystkich grup
+	std::vector<Particle::Priority_t> SeedPriorities;
+	if(SeedFraction > 0)
 	{
-		const std::optional<const Particle> & PGParticleBest = PG.Instance.GetParticleBest();
+		SeedPriorities = CalculateSeedPriorities(T);
+		for(ParticleGroup & PG : ParticleGroups)
+			PG.SetSeed(SeedPriorities.data(), (size_t) std::ceil(SeedFraction * PG.GetParticleNumber()));
+	}
 
-		// Jeli czstka nic nie znalaza - pomi
-		if(!PGParticleBest)
+	// Uruchom grupy na puli i poczekaj na zakończenie. Przy rozmieszczeniu NUMA - grupy węzła (co NodeNumber-ta) na puli węzła
+	if(Placement)
+	{
+		Placement->RunOnNodes([&](const size_t & Node)
+		{
+			ThreadPool & NodePool = Placement->GetPool(Node);
+			NodePool.ParallelFor((ParticleGroups.size() + NodeNumber - 1 - Node) / NodeNumber, [&](const size_t & NodeParticleGroupId)
+			{
+				ParticleGroups[Node + NodeParticleGroupId * NodeNumber].Run(NodePool, Stop);
+			});
+		});
+	}
+	else
+	{
+		Pool.ParallelFor(ParticleGroups.size(), [&](const size_t & ParticleGroupId)
+		{
+			ParticleGroups[ParticleGroupId].Run(Pool, Stop);
+		});
+	}
+
+	// Grupy zakończone - Trace dopisze pozostałe wpisy i zwolni bufory, bez czekania na wyniki
+	for(TraceRing * Ring : TraceRings)
+		Ring->Close();
+	TraceRings.clear();
+
+	// Aktualnie najlepszy wynik - wskaźnik na ścieżkę grupy, kopiowaną raz, na końcu
+	const GraphPath * GraphPathBest = nullptr;
+	const Particle::Priority_t * PrioritiesBest = nullptr;
+
+	// Liczniki alokacji
+	size_t SteadyStateIterations = 0;
+	AllocationCounter::Count_t SteadyStateAllocations = 0;
+	size_t MigrationsAccepted = 0;
+	bool Stopped = false;
+	PerformanceCounters::Values_t CountersTotal;
+
+	// Przejdź przez wszystkie cząstki i pobierz wyniki
+	for(ParticleGroup & PG : ParticleGroups)
+	{
+		SteadyStateIterations += PG.GetSteadyStateIterations();
+		SteadyStateAllocations += PG.GetSteadyStateAllocations();
+		MigrationsAccepted += PG.GetMigrationsAccepted();
+		Stopped = Stopped || PG.IsStopped();
+		CountersTotal += PG.GetCounters();
+
+		const std::optional<GraphPath> & PGGraphPathBest = PG.GetParticleBestGraphPath();
+
+		// Jeśli cząstka nic nie znalazła - pomiń
+		if(!PGGraphPathBest)
 			continue;
 
-		// Jeli ma lepszy wynik - zaktualizuj
-		if(!ParticleBest || PGParticleBest.value().GetBestGraphPath().value().IsBetterThan(ParticleBest.value().GetBestGraphPath().value()))
+		// Jeśli ma lepszy wynik - zaktualizuj
+		if(!GraphPathBest || PGGraphPathBest.value().IsBetterThan(*GraphPathBest))
 		{
-			ParticleBest.emplace(
-				PGParticleBest.value()
-			);
+			GraphPathBest = &PGGraphPathBest.value();
+			PrioritiesBest = PG.GetParticleBestPriorities();
 		}
+	}
 
-		// Dodaj histori wynikw
-		HistoryEntries.push_back(
-			PG.Instance.GetHistoryEntries()
-		);
+	// Położenie stron: macierze roju grup i kopie grafu względem węzła, który z nich korzysta
+	if(Placement)
+	{
+		NumaPlacement::Pages_t Pages;
+		for(size_t ParticleGroupId = 0; ParticleGroupId < ParticleGroups.size(); ParticleGroupId++)
+		{
+			const SwarmMatrix & Swarm = ParticleGroups[ParticleGroupId].GetSwarm();
+			NumaPlacement::CountPages(Swarm.GetPriorities(0), Swarm.GetFootprint(), Placement->GetNode(ParticleGroupId % NodeNumber).Id, Pages);
+		}
+		for(size_t Node = 0; Node < NodeNumber; Node++)
+		{
+			Pages.Local += Placement->GetGraphPages(Node).Local;
+			Pages.Remote += Placement->GetGraphPages(Node).Remote;
+		}
+
+		PerformanceCounters::Values_t CountersPlacement;
+		CountersPlacement.NumaPagesLocal = Pages.Local;
+		CountersPlacement.NumaPagesRemote = Pages.Remote;
+
+		CountersTotal += CountersPlacement;
+		Counters.Add(CountersPlacement);
+	}
+
+	// Ścieżki do celów - z dekodowań wszystkich grup. Do pierwszego celu prowadzi też najlepsze rozwiązanie roju (po przeszukiwaniu lokalnym może być lepsze)
+	std::vector<std::optional<GraphPath>> TargetGraphPaths;
+	if(T.IsMultiTarget())
+	{
+		TargetBest Targets(T);
+		for(const ParticleGroup & PG : ParticleGroups)
+			Targets.Merge(PG.GetTargets());
+
+		TargetGraphPaths.reserve(T.GetVertexIndexEnds().size());
+		for(size_t TargetId = 0; TargetId < T.GetVertexIndexEnds().size(); TargetId++)
+			TargetGraphPaths.push_back(Targets.GetGraphPath((Task::TargetId_t) TargetId));
 	}
+	else
+	{
+		TargetGraphPaths.emplace_back();
+	}
+
+	/*
+		Wynik na grafie zadania. Grupy rozmieszczone na węzłach NUMA dekodują na kopiach grafu należących do Placement -
+		ścieżka związana z kopią byłaby nieważna po zniszczeniu Placement. Ścieżki celów (TargetBest(T)) są już na grafie zadania
+	*/
+	std::optional<const GraphPath> GraphPathResult;
+	if(GraphPathBest)
+		GraphPathResult.emplace(T.GetGraph(), GraphPath::VertexIndexes_t(GraphPathBest->GetVertexIndexes()), GraphPathBest->GetPathWeight());
+
+	if(GraphPathResult && (!TargetGraphPaths.front() || GraphPathResult->IsBetterThan(TargetGraphPaths.front().value())))
+		TargetGraphPaths.front().emplace(*GraphPathResult);
 
 	return {
-		ParticleBest,
-		HistoryEntries
+		GraphPathResult,
+		SteadyStateIterations,
+		SteadyStateAllocations,
+		MigrationsAccepted,
+		Stopped,
+		CountersTotal,
+		std::move(TargetGraphPaths),
+		PrioritiesBest ? std::vector<Particle::Priority_t>(PrioritiesBest, PrioritiesBest + T.GetGraph().GetSize()) : std::vector<Particle::Priority_t>()
 	};
-}
\ No newline at end of file
+}
+
+std::vector<Particle::Priority_t> ParticleGroupRunner::CalculateSeedPriorities(const Task & T)
+{
+	const Graph & G = T.GetGraph();
+
+	/*
+		Oszacowanie odległości - odległość w siatce (jak heurystyka ShortestPathSolver::GetHeuristic, bez stałych), O(V) bez przechodzenia krawędzi.
+		Dokładne odległości (CalculateDistances) rozwiązałyby zadanie przed startem roju - ShortestPathSolver służy tylko jako wynik wzorcowy
+	*/
+	Graph::VertexId_t DistanceMax = 0;
+	for(Graph::VertexIndex_t VertexIndex = 0; VertexIndex < G.GetSize(); VertexIndex++)
+		DistanceMax = std::max(DistanceMax, ShortestPathSolver::GetGridDistance(G, VertexIndex, T.GetVertexIndexEnd()));
+
+	std::vector<Particle::Priority_t> SeedPriorities(G.GetSize());
+	for(Graph::VertexIndex_t VertexIndex = 0; VertexIndex < G.GetSize(); VertexIndex++)
+		SeedPriorities[VertexIndex] = (ShortestPathSolver::GetGridDistance(G, VertexIndex, T.GetVertexIndexEnd()) + 1.0) / (DistanceMax + 1.0);
+
+	return SeedPriorities;
+}
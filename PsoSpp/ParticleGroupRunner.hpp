@@ -1,34 +1,66 @@
 #pragma once
 
 #include <vector>
-#include <thread>
 
 #include "Task.hpp"
 #include "ParticleGroup.hpp"
+#include "ThreadPool.hpp"
+#include "StopToken.hpp"
+#include "PerformanceCounters.hpp"
+#include "TraceWriter.hpp"
+#include "NumaPlacement.hpp"
 
 /*
-	Klasa odpowiedzialna za uruchamianie algorytmu w okrelonej iloci wtkw
+	Klasa odpowiedzialna za uruchamianie algorytmu na puli wątków
 
-	Dla kadego wtku (liczba okrelona przez ParticleGroupNumber) tworzona jest grupa zawierajca ParticleNumberTotal / ParticleGroupNumber czstek
-	Kady wtek wykonuje ParticleIterations iteracji
+	Tworzone jest ParticleGroupNumber grup, cząstki dzielone są pomiędzy nie możliwie równo (pierwsze ParticleNumberTotal % ParticleGroupNumber grup ma o jedną cząstkę więcej)
+	Każda grupa wykonuje ParticleIterations iteracji. Grupy i ich fragmenty wykonywane są na wspólnej puli wątków - liczba grup nie musi odpowiadać liczbie wątków
+	Grupy mogą co MigrationInterval iteracji wymieniać najlepsze rozwiązania (model wyspowy) - grupa utknięta w słabym rozwiązaniu przejmuje lepsze od innych
+	W wariancie asynchronicznym (GlobalBestAsync) grupy publikują najlepsze rozwiązania na bieżąco we wspólnym GlobalBest, z którego korzystają wszystkie cząstki
 */
 class ParticleGroupRunner
 {
+	public:
+		// Topologia migracji - do których grup wysyła swoje najlepsze rozwiązanie grupa I
+		enum class MigrationTopology_t
+		{
+			None, // brak migracji - grupy niezależne
+			Ring, // do grupy (I + 1) % ParticleGroupNumber
+			Full, // do wszystkich pozostałych grup
+			Random, // do jednej, losowej grupy (innej niż I)
+		};
+
+		// Domyślne ziarno generatora ziaren grup (std::mt19937::default_seed)
+		static const uint32_t RandomSeedDefault = 5489u;
+
 	public:
 		/*
 			Konstruktor.
 
+			Pool - pula wątków, na której wykonywane są grupy
 			T - Zadanie optymalizacji
 
-			ParticleGroupNumber - liczba niezalenych grup czstek (wtkw). Podanie 0 spowoduje automatyczne ustalenie wartoci na podstawie hardware concurency
-			ParticleNumberTotal - liczba czstek we wszystkich grupach. Kada stworzona grupa zostanie podzielona.
-			ParticleIterations - liczba iteracji kadej z grup
+			ParticleGroupNumber - liczba niezależnych grup cząstek. Podanie 0 spowoduje ustalenie wartości na liczbę wątków puli
+			ParticleNumberTotal - liczba cząstek we wszystkich grupach. Każda stworzona grupa zostanie podzielona.
+			ParticleIterations - liczba iteracji każdej z grup
+
+			ParticleBetterSolutionFoundNoCountMax, Fi1, Fi2 - parametry przekazywane bezpośrednio do ParticleGroup
+
+			MigrationInterval - co ile iteracji grupa wysyła swoje najlepsze rozwiązanie. 0 - brak migracji
+			MigrationTopology - do których grup
+
+			GlobalBestAsync - asynchroniczny wariant PSO: cząstki przyciągane są do najlepszego rozwiązania wszystkich grup, gdy tylko zostanie znalezione.
+				Wynik zależy wtedy od kolejności wykonania grup na puli
 
-			ParticleBetterSolutionFoundNoCountMax, Fi1, Fi2 - parametry przekazywane bezporednio do ParticleGroup
+			SeedFraction - część cząstek każdej grupy (0.0 - 1.0) inicjowana priorytetami z oszacowania odległości do końca zadania zamiast losowo.
+				Oszacowanie (odległość w siatce, ShortestPathSolver::GetGridDistance) liczone jest raz na Run(), w O(V). 0.0 - wszystkie cząstki losowe
+
+			LocalSearch - przeszukiwanie lokalne ścieżek cząstek (PathLocalSearch)
 		*/
-		ParticleGroupRunner(const Task & T, const size_t & ParticleGroupNumber, const size_t & ParticleNumberTotal, const size_t & ParticleIterations, const size_t & ParticleBetterSolutionFoundNoCountMax, const double & Fi1, const double & Fi2);
+		ParticleGroupRunner(ThreadPool & Pool, const Task & T, const size_t & ParticleGroupNumber, const size_t & ParticleNumberTotal, const size_t & ParticleIterations, const size_t & ParticleBetterSolutionFoundNoCountMax, const double & Fi1, const double & Fi2, const size_t & MigrationInterval, const MigrationTopology_t & MigrationTopology, const bool & GlobalBestAsync, const double & SeedFraction, const PathLocalSearch::Mode_t & LocalSearch);
 
 	private:
+		ThreadPool & Pool;
 		const Task & T;
 
 		const size_t ParticleGroupNumber;
@@ -39,15 +71,119 @@ class ParticleGroupRunner
 		const double Fi1;
 		const double Fi2;
 
+		const size_t MigrationInterval;
+		const MigrationTopology_t MigrationTopology;
+
+		const bool GlobalBestAsync;
+
+		const double SeedFraction;
+
+		const PathLocalSearch::Mode_t LocalSearch;
+
+		/*
+			Ślad zbieżności (SetTrace), domyślnie brak
+		*/
+		TraceWriter * Trace;
+
+		/*
+			Ziarno generatora ziaren grup (SetRandomSeed), domyślnie RandomSeedDefault
+		*/
+		uint32_t RandomSeed;
+
+		/*
+			Zewnętrzne najlepsze rozwiązanie (SetGlobalBest), domyślnie brak - przy GlobalBestAsync Run() tworzy własne
+		*/
+		GlobalBest * GlobalBestExternal;
+
+		/*
+			Skrzynki migracji do i od innych procesów (SetProcessMigration), domyślnie brak
+		*/
+		MigrationMailbox * ProcessInbox;
+		MigrationMailbox * ProcessOutbox;
+
+		/*
+			Rozmieszczenie grup na węzłach NUMA (SetPlacement), domyślnie brak
+		*/
+		NumaPlacement * Placement;
+
+	public:
+		/*
+			Włącza strumieniowy zapis śladu zbieżności - każda grupa dostaje w Run() własny bufor Trace, zamykany po zakończeniu grup.
+			Trace musi żyć do końca Run()
+		*/
+		void SetTrace(TraceWriter * Trace);
+
+		/*
+			Ziarno, z którego losowane są ziarna grup. Równoległe roje tego samego zadania (np. w kilku procesach) muszą mieć różne ziarna
+		*/
+		void SetRandomSeed(const uint32_t & Seed);
+
+		/*
+			Grupy publikują najlepsze rozwiązania w Best i są do niego przyciągane (jak przy GlobalBestAsync), a Run() nie tworzy własnego GlobalBest.
+			Pozwala wymieniać rozwiązania z innymi rojami - np. z innych procesów (ProcessRunner). Best musi żyć do końca Run()
+		*/
+		void SetGlobalBest(GlobalBest * Best);
+
+		/*
+			Włącza roje jako jedną wyspę większego modelu wyspowego (ProcessRunner). Działa tylko z włączoną migracją (MigrationInterval, MigrationTopology)
+
+			Inbox - zastępuje skrzynkę pierwszej grupy - migranci od innych procesów trafiają do niej
+			Outbox - dodatkowy adresat migracji: ostatniej grupy przy MigrationTopology_t::Ring, każdej grupy w pozostałych topologiach
+			Obie skrzynki muszą żyć do końca Run()
+		*/
+		void SetProcessMigration(MigrationMailbox * Inbox, MigrationMailbox * Outbox);
+
+		/*
+			Rozmieszcza grupy na węzłach NUMA: grupa I należy do węzła I % Placement->GetNodeNumber(), jest tworzona przez wątek węzła (stan roju w pamięci węzła),
+			czyta kopię grafu węzła i wykonywana jest wyłącznie na puli węzła - Pool z konstruktora nie wykonuje wtedy grup.
+			Placement musi być utworzony dla grafu zadania (inaczej std::invalid_argument) i żyć do końca Run() - wyniki Run() odnoszą się do grafu zadania, nie do kopii.
+			Położenie stron trafia do liczników (NumaPagesLocal, NumaPagesRemote)
+		*/
+		void SetPlacement(NumaPlacement * Placement);
+
 	public:
 		struct RunResult_t
 		{
-			// Najlepsza znaleziona czstka przez wszystkie iteracje
-			std::optional<const Particle> ParticleBest;
+			// Najlepsza znaleziona ścieżka przez wszystkie iteracje
+			std::optional<const GraphPath> GraphPathBest;
 
-			// Historia iteracji
-			std::vector<ParticleGroup::HistoryEntries_t> HistoryEntries;
+			// Suma iteracji stanu ustalonego i wykonanych w nich alokacji ze wszystkich grup
+			size_t SteadyStateIterations;
+			AllocationCounter::Count_t SteadyStateAllocations;
+
+			// Suma przyjętych migrantów ze wszystkich grup
+			size_t MigrationsAccepted;
+
+			// Czy obliczenia przerwano (anulowanie lub kryterium zakończenia StopToken) przed wykonaniem wszystkich iteracji
+			bool Stopped;
+
+			// Suma liczników wydajności wszystkich grup
+			PerformanceCounters::Values_t Counters;
+
+			// Najlepsza znaleziona ścieżka do każdego celu zadania (T.GetVertexIndexEnds()). Dla zadania z jednym celem - GraphPathBest
+			std::vector<std::optional<GraphPath>> TargetGraphPaths;
+
+			// Priorytety odpowiadające GraphPathBest (puste, jeśli brak ścieżki)
+			std::vector<Particle::Priority_t> PrioritiesBest;
 		};
 		RunResult_t Run();
+
+		/*
+			Jak Run(), ale grupy kończą pracę przed kolejną iteracją, gdy Stop zgłosi żądanie przerwania lub spełnione zostanie jego kryterium zakończenia
+		*/
+		RunResult_t Run(StopToken & Stop);
+
+		/*
+			Jak Run(Stop), a grupy zgłaszają dodatkowo liczniki wydajności do Counters po każdej iteracji - można je odczytywać w trakcie obliczeń
+		*/
+		RunResult_t Run(StopToken & Stop, PerformanceCounters & Counters);
+
+	public:
+		/*
+			Priorytety początkowe dla zadania T: rosnące z odległością wierzchołka od końca zadania w siatce grafu, z zakresu (0.0; 1.0].
+			Dekodowanie wybiera sąsiada o najmniejszym iloczynie wagi krawędzi i priorytetu, więc cząstka z tymi priorytetami idzie w stronę końca tanimi krawędziami.
+			Do odległości dodawane jest 1, żeby sam koniec nie zerował iloczynu
+		*/
+		static std::vector<Particle::Priority_t> CalculateSeedPriorities(const Task & T);
 };
 
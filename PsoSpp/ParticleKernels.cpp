@@ -0,0 +1,545 @@
+#include "ParticleKernels.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define PSOSPP_KERNELS_X86
+
+	#include <immintrin.h>
+
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+	#endif
+#endif
+
+// MSVC pozwala używać intrinsics niezależnie od /arch, GCC / Clang wymagają oznaczenia funkcji docelowym zestawem instrukcji
+#if defined(PSOSPP_KERNELS_X86) && (defined(__GNUC__) || defined(__clang__))
+	#define PSOSPP_KERNELS_TARGET(InstructionSet) __attribute__((target(InstructionSet)))
+#else
+	#define PSOSPP_KERNELS_TARGET(InstructionSet)
+#endif
+
+namespace
+{
+	typedef size_t (*NeighborArgMin_t)(const Graph::Neighbors_t & Neighbors, const double * Priorities, const uint32_t * VisitedMarks, const uint32_t & VisitedMark);
+	typedef void (*RandomUniformBlocks_t)(uint64_t * State, double * Output, const size_t & Blocks);
+	typedef void (*UpdateVelocities_t)(const size_t & Size, const double & Chi, const double & Fi1, const double & Fi2, const double * R1, const double * R2, const double * BestPriorities, const double * ParticleBestPriorities, double * Velocities, double * Priorities);
+
+	const size_t RandomLanes = ParticleKernels::RandomLanes;
+
+	// Bity wykładnika liczby 1.0 - (Wynik >> 12) | RandomUniformOne daje liczbę z zakresu [1.0; 2.0)
+	const uint64_t RandomUniformOne = 0x3FF0000000000000ull;
+
+	/*
+		Implementacje skalarne
+	*/
+	size_t NeighborArgMinScalarRange(const Graph::Neighbors_t & Neighbors, const double * Priorities, const uint32_t * VisitedMarks, const uint32_t & VisitedMark, const size_t & NeighborIdBegin, size_t BestNeighborId, double BestWeight)
+	{
+		for(size_t NeighborId = NeighborIdBegin; NeighborId < Neighbors.Size; NeighborId++)
+		{
+			const Graph::VertexIndex_t NextVertexIndex = Neighbors.VertexIndexes[NeighborId];
+
+			// Pomijamy odwiedzone węzły
+			if(VisitedMarks[NextVertexIndex] == VisitedMark)
+				continue;
+
+			// Węzeł nie został odwiedzony, krawędź istnieje - obliczamy priotytet
+			const double Weight = Priorities[NextVertexIndex] * Neighbors.EdgeWeights[NeighborId];
+
+			// Sprawdzamy czy to lepsze rozwiązanie
+			if(BestNeighborId == Neighbors.Size || Weight < BestWeight)
+			{
+				BestNeighborId = NeighborId;
+				BestWeight = Weight;
+			}
+		}
+
+		return BestNeighborId;
+	}
+
+	size_t NeighborArgMinScalar(const Graph::Neighbors_t & Neighbors, const double * Priorities, const uint32_t * VisitedMarks, const uint32_t & VisitedMark)
+	{
+		return NeighborArgMinScalarRange(Neighbors, Priorities, VisitedMarks, VisitedMark, 0, Neighbors.Size, 0.0);
+	}
+
+	void RandomUniformBlocksScalar(uint64_t * State, double * Output, const size_t & Blocks)
+	{
+		uint64_t * S0 = State + 0 * RandomLanes;
+		uint64_t * S1 = State + 1 * RandomLanes;
+		uint64_t * S2 = State + 2 * RandomLanes;
+		uint64_t * S3 = State + 3 * RandomLanes;
+
+		for(size_t Block = 0; Block < Blocks; Block++)
+		{
+			for(size_t Lane = 0; Lane < RandomLanes; Lane++)
+			{
+				// xoshiro256+
+				const uint64_t Result = S0[Lane] + S3[Lane];
+				const uint64_t T = S1[Lane] << 17;
+
+				S2[Lane] ^= S0[Lane];
+				S3[Lane] ^= S1[Lane];
+				S1[Lane] ^= S2[Lane];
+				S0[Lane] ^= S3[Lane];
+				S2[Lane] ^= T;
+				S3[Lane] = (S3[Lane] << 45) | (S3[Lane] >> 19);
+
+				// Górne 52 bity jako mantysa liczby z zakresu [1.0; 2.0)
+				const uint64_t ResultBits = (Result >> 12) | RandomUniformOne;
+				double ResultDouble;
+				std::memcpy(&ResultDouble, &ResultBits, sizeof(ResultDouble));
+
+				Output[Block * RandomLanes + Lane] = ResultDouble - 1.0;
+			}
+		}
+	}
+
+	void UpdateVelocitiesScalar(const size_t & Size, const double & Chi, const double & Fi1, const double & Fi2, const double * R1, const double * R2, const double * BestPriorities, const double * ParticleBestPriorities, double * Velocities, double * Priorities)
+	{
+		for(size_t Index = 0; Index < Size; Index++)
+		{
+			// 2.3
+			Velocities[Index] = Chi * (Velocities[Index] + Fi1 * R1[Index] * (BestPriorities[Index] - Priorities[Index]) + Fi2 * R2[Index] * (ParticleBestPriorities[Index] - Priorities[Index]));
+
+			// 2.2
+			Priorities[Index] += Velocities[Index];
+		}
+	}
+
+	/*
+		Wspólne zakończenie implementacji wektorowych.
+
+		Lanes - liczba torów, LaneWeights / LaneNeighborIds - najlepsze wartości i pozycje w poszczególnych torach (+inf jeśli brak)
+		NeighborIdTail - pierwsza pozycja nieprzetworzona wektorowo
+	*/
+	size_t NeighborArgMinReduce(const Graph::Neighbors_t & Neighbors, const double * Priorities, const uint32_t * VisitedMarks, const uint32_t & VisitedMark, const size_t & Lanes, const double * LaneWeights, const double * LaneNeighborIds, const size_t & NeighborIdTail)
+	{
+		// Minimum po torach, przy równych wartościach - wcześniejsza pozycja
+		size_t BestNeighborId = Neighbors.Size;
+		double BestWeight = std::numeric_limits<double>::infinity();
+
+		for(size_t Lane = 0; Lane < Lanes; Lane++)
+		{
+			if(LaneWeights[Lane] < BestWeight || (LaneWeights[Lane] == BestWeight && BestNeighborId != Neighbors.Size && (size_t) LaneNeighborIds[Lane] < BestNeighborId))
+			{
+				BestNeighborId = (size_t) LaneNeighborIds[Lane];
+				BestWeight = LaneWeights[Lane];
+			}
+		}
+
+		// Nieodwiedzeni sąsiedzi o nieskończonej wadze (nie występuje przy skończonych priorytetach) - zachowanie identyczne z wersją skalarną zapewnia tylko ona
+		if(BestNeighborId == Neighbors.Size)
+			return NeighborArgMinScalar(Neighbors, Priorities, VisitedMarks, VisitedMark);
+
+		// Resztę listy dokańczamy skalarnie
+		return NeighborArgMinScalarRange(Neighbors, Priorities, VisitedMarks, VisitedMark, NeighborIdTail, BestNeighborId, BestWeight);
+	}
+
+#if defined(PSOSPP_KERNELS_X86)
+	/*
+		SSE2 - 2 tory double, brak instrukcji gather - ładowanie skalarne
+	*/
+	PSOSPP_KERNELS_TARGET("sse2")
+	size_t NeighborArgMinSSE2(const Graph::Neighbors_t & Neighbors, const double * Priorities, const uint32_t * VisitedMarks, const uint32_t & VisitedMark)
+	{
+		const __m128d Infinity = _mm_set1_pd(std::numeric_limits<double>::infinity());
+
+		__m128d BestWeights = Infinity;
+		__m128d BestNeighborIds = _mm_setzero_pd();
+		__m128d NeighborIds = _mm_set_pd(1.0, 0.0);
+		const __m128d NeighborIdsStep = _mm_set1_pd(2.0);
+
+		size_t NeighborId = 0;
+		for(; NeighborId + 2 <= Neighbors.Size; NeighborId += 2)
+		{
+			const Graph::NeighborVertexIndex_t NextVertexIndex0 = Neighbors.VertexIndexes[NeighborId + 0];
+			const Graph::NeighborVertexIndex_t NextVertexIndex1 = Neighbors.VertexIndexes[NeighborId + 1];
+
+			// Priorytet * waga
+			const __m128d Weights = _mm_mul_pd(
+				_mm_set_pd(Priorities[NextVertexIndex1], Priorities[NextVertexIndex0]),
+				_mm_set_pd(Neighbors.EdgeWeights[NeighborId + 1], Neighbors.EdgeWeights[NeighborId + 0])
+			);
+
+			// Odwiedzone węzły - +inf
+			const __m128d Visited = _mm_castsi128_pd(_mm_set_epi64x(
+				VisitedMarks[NextVertexIndex1] == VisitedMark ? -1 : 0,
+				VisitedMarks[NextVertexIndex0] == VisitedMark ? -1 : 0
+			));
+			const __m128d WeightsMasked = _mm_or_pd(_mm_and_pd(Visited, Infinity), _mm_andnot_pd(Visited, Weights));
+
+			// Ściśle mniejsze - zachowuje pierwsze wystąpienie w torze
+			const __m128d Better = _mm_cmplt_pd(WeightsMasked, BestWeights);
+			BestWeights = _mm_or_pd(_mm_and_pd(Better, WeightsMasked), _mm_andnot_pd(Better, BestWeights));
+			BestNeighborIds = _mm_or_pd(_mm_and_pd(Better, NeighborIds), _mm_andnot_pd(Better, BestNeighborIds));
+
+			NeighborIds = _mm_add_pd(NeighborIds, NeighborIdsStep);
+		}
+
+		double LaneWeights[2];
+		double LaneNeighborIds[2];
+		_mm_storeu_pd(LaneWeights, BestWeights);
+		_mm_storeu_pd(LaneNeighborIds, BestNeighborIds);
+
+		return NeighborArgMinReduce(Neighbors, Priorities, VisitedMarks, VisitedMark, 2, LaneWeights, LaneNeighborIds, NeighborId);
+	}
+
+	PSOSPP_KERNELS_TARGET("sse2")
+	void UpdateVelocitiesSSE2(const size_t & Size, const double & Chi, const double & Fi1, const double & Fi2, const double * R1, const double * R2, const double * BestPriorities, const double * ParticleBestPriorities, double * Velocities, double * Priorities)
+	{
+		const __m128d ChiVector = _mm_set1_pd(Chi);
+		const __m128d Fi1Vector = _mm_set1_pd(Fi1);
+		const __m128d Fi2Vector = _mm_set1_pd(Fi2);
+
+		size_t Index = 0;
+		for(; Index + 2 <= Size; Index += 2)
+		{
+			const __m128d P = _mm_loadu_pd(Priorities + Index);
+
+			// Ta sama kolejność działań co w wersji skalarnej - identyczny wynik
+			const __m128d Local = _mm_mul_pd(_mm_mul_pd(Fi1Vector, _mm_loadu_pd(R1 + Index)), _mm_sub_pd(_mm_loadu_pd(BestPriorities + Index), P));
+			const __m128d Social = _mm_mul_pd(_mm_mul_pd(Fi2Vector, _mm_loadu_pd(R2 + Index)), _mm_sub_pd(_mm_loadu_pd(ParticleBestPriorities + Index), P));
+			const __m128d V = _mm_mul_pd(ChiVector, _mm_add_pd(_mm_add_pd(_mm_loadu_pd(Velocities + Index), Local), Social));
+
+			_mm_storeu_pd(Velocities + Index, V);
+			_mm_storeu_pd(Priorities + Index, _mm_add_pd(P, V));
+		}
+
+		UpdateVelocitiesScalar(Size - Index, Chi, Fi1, Fi2, R1 + Index, R2 + Index, BestPriorities + Index, ParticleBestPriorities + Index, Velocities + Index, Priorities + Index);
+	}
+
+	/*
+		AVX2 - 4 tory double, priorytety i znaczniki odwiedzin pobierane instrukcją gather
+	*/
+	PSOSPP_KERNELS_TARGET("avx2")
+	size_t NeighborArgMinAVX2(const Graph::Neighbors_t & Neighbors, const double * Priorities, const uint32_t * VisitedMarks, const uint32_t & VisitedMark)
+	{
+		const __m256d Infinity = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+		const __m128i VisitedMarkVector = _mm_set1_epi32((int) VisitedMark);
+		const __m256d GatherMask = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+
+		__m256d BestWeights = Infinity;
+		__m256d BestNeighborIds = _mm256_setzero_pd();
+		__m256d NeighborIds = _mm256_set_pd(3.0, 2.0, 1.0, 0.0);
+		const __m256d NeighborIdsStep = _mm256_set1_pd(4.0);
+
+		size_t NeighborId = 0;
+		for(; NeighborId + 4 <= Neighbors.Size; NeighborId += 4)
+		{
+			// Indeksy sąsiadów (NeighborVertexIndex_t jest 32-bitowy, liczba wierzchołków < 2^31)
+			const __m128i NextVertexIndexes = _mm_loadu_si128((const __m128i *) (Neighbors.VertexIndexes + NeighborId));
+
+			// Wagi krawędzi uint8 -> double
+			int32_t EdgeWeightsPacked;
+			std::memcpy(&EdgeWeightsPacked, Neighbors.EdgeWeights + NeighborId, sizeof(EdgeWeightsPacked));
+			const __m256d EdgeWeights = _mm256_cvtepi32_pd(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(EdgeWeightsPacked)));
+
+			// Priorytet * waga
+			const __m256d Weights = _mm256_mul_pd(_mm256_mask_i32gather_pd(_mm256_setzero_pd(), Priorities, NextVertexIndexes, GatherMask, 8), EdgeWeights);
+
+			// Odwiedzone węzły - +inf
+			const __m128i Visited32 = _mm_cmpeq_epi32(_mm_i32gather_epi32((const int *) VisitedMarks, NextVertexIndexes, 4), VisitedMarkVector);
+			const __m256d Visited = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(Visited32));
+			const __m256d WeightsMasked = _mm256_blendv_pd(Weights, Infinity, Visited);
+
+			// Ściśle mniejsze - zachowuje pierwsze wystąpienie w torze
+			const __m256d Better = _mm256_cmp_pd(WeightsMasked, BestWeights, _CMP_LT_OQ);
+			BestWeights = _mm256_blendv_pd(BestWeights, WeightsMasked, Better);
+			BestNeighborIds = _mm256_blendv_pd(BestNeighborIds, NeighborIds, Better);
+
+			NeighborIds = _mm256_add_pd(NeighborIds, NeighborIdsStep);
+		}
+
+		double LaneWeights[4];
+		double LaneNeighborIds[4];
+		_mm256_storeu_pd(LaneWeights, BestWeights);
+		_mm256_storeu_pd(LaneNeighborIds, BestNeighborIds);
+
+		return NeighborArgMinReduce(Neighbors, Priorities, VisitedMarks, VisitedMark, 4, LaneWeights, LaneNeighborIds, NeighborId);
+	}
+
+	PSOSPP_KERNELS_TARGET("avx2")
+	void RandomUniformBlocksAVX2(uint64_t * State, double * Output, const size_t & Blocks)
+	{
+		// 8 torów = 2 rejestry na słowo stanu
+		__m256i S0[2], S1[2], S2[2], S3[2];
+		for(size_t Half = 0; Half < 2; Half++)
+		{
+			S0[Half] = _mm256_loadu_si256((const __m256i *) (State + 0 * RandomLanes + 4 * Half));
+			S1[Half] = _mm256_loadu_si256((const __m256i *) (State + 1 * RandomLanes + 4 * Half));
+			S2[Half] = _mm256_loadu_si256((const __m256i *) (State + 2 * RandomLanes + 4 * Half));
+			S3[Half] = _mm256_loadu_si256((const __m256i *) (State + 3 * RandomLanes + 4 * Half));
+		}
+
+		const __m256i One = _mm256_set1_epi64x((long long) RandomUniformOne);
+		const __m256d OneDouble = _mm256_set1_pd(1.0);
+
+		for(size_t Block = 0; Block < Blocks; Block++)
+		{
+			for(size_t Half = 0; Half < 2; Half++)
+			{
+				const __m256i Result = _mm256_add_epi64(S0[Half], S3[Half]);
+				const __m256i T = _mm256_slli_epi64(S1[Half], 17);
+
+				S2[Half] = _mm256_xor_si256(S2[Half], S0[Half]);
+				S3[Half] = _mm256_xor_si256(S3[Half], S1[Half]);
+				S1[Half] = _mm256_xor_si256(S1[Half], S2[Half]);
+				S0[Half] = _mm256_xor_si256(S0[Half], S3[Half]);
+				S2[Half] = _mm256_xor_si256(S2[Half], T);
+				S3[Half] = _mm256_or_si256(_mm256_slli_epi64(S3[Half], 45), _mm256_srli_epi64(S3[Half], 19));
+
+				const __m256d ResultDouble = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(Result, 12), One)), OneDouble);
+				_mm256_storeu_pd(Output + Block * RandomLanes + 4 * Half, ResultDouble);
+			}
+		}
+
+		for(size_t Half = 0; Half < 2; Half++)
+		{
+			_mm256_storeu_si256((__m256i *) (State + 0 * RandomLanes + 4 * Half), S0[Half]);
+			_mm256_storeu_si256((__m256i *) (State + 1 * RandomLanes + 4 * Half), S1[Half]);
+			_mm256_storeu_si256((__m256i *) (State + 2 * RandomLanes + 4 * Half), S2[Half]);
+			_mm256_storeu_si256((__m256i *) (State + 3 * RandomLanes + 4 * Half), S3[Half]);
+		}
+	}
+
+	PSOSPP_KERNELS_TARGET("avx2")
+	void UpdateVelocitiesAVX2(const size_t & Size, const double & Chi, const double & Fi1, const double & Fi2, const double * R1, const double * R2, const double * BestPriorities, const double * ParticleBestPriorities, double * Velocities, double * Priorities)
+	{
+		const __m256d ChiVector = _mm256_set1_pd(Chi);
+		const __m256d Fi1Vector = _mm256_set1_pd(Fi1);
+		const __m256d Fi2Vector = _mm256_set1_pd(Fi2);
+
+		size_t Index = 0;
+		for(; Index + 4 <= Size; Index += 4)
+		{
+			const __m256d P = _mm256_loadu_pd(Priorities + Index);
+
+			// Bez FMA - ta sama kolejność działań co w wersji skalarnej
+			const __m256d Local = _mm256_mul_pd(_mm256_mul_pd(Fi1Vector, _mm256_loadu_pd(R1 + Index)), _mm256_sub_pd(_mm256_loadu_pd(BestPriorities + Index), P));
+			const __m256d Social = _mm256_mul_pd(_mm256_mul_pd(Fi2Vector, _mm256_loadu_pd(R2 + Index)), _mm256_sub_pd(_mm256_loadu_pd(ParticleBestPriorities + Index), P));
+			const __m256d V = _mm256_mul_pd(ChiVector, _mm256_add_pd(_mm256_add_pd(_mm256_loadu_pd(Velocities + Index), Local), Social));
+
+			_mm256_storeu_pd(Velocities + Index, V);
+			_mm256_storeu_pd(Priorities + Index, _mm256_add_pd(P, V));
+		}
+
+		UpdateVelocitiesScalar(Size - Index, Chi, Fi1, Fi2, R1 + Index, R2 + Index, BestPriorities + Index, ParticleBestPriorities + Index, Velocities + Index, Priorities + Index);
+	}
+
+	// GCC zgłasza fałszywe ostrzeżenie wewnątrz nagłówka intrinsics (_mm512_undefined_epi32 w przesunięciach i rotacji) - zmiennej nie da się zainicjować z zewnątrz
+#if defined(__GNUC__) && !defined(__clang__)
+	#pragma GCC diagnostic push
+	#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+	/*
+		AVX-512 - 8 torów double. Dekodowanie korzysta z implementacji AVX2
+	*/
+	PSOSPP_KERNELS_TARGET("avx512f")
+	void RandomUniformBlocksAVX512(uint64_t * State, double * Output, const size_t & Blocks)
+	{
+		__m512i S0 = _mm512_loadu_si512(State + 0 * RandomLanes);
+		__m512i S1 = _mm512_loadu_si512(State + 1 * RandomLanes);
+		__m512i S2 = _mm512_loadu_si512(State + 2 * RandomLanes);
+		__m512i S3 = _mm512_loadu_si512(State + 3 * RandomLanes);
+
+		const __m512i One = _mm512_set1_epi64((long long) RandomUniformOne);
+		const __m512d OneDouble = _mm512_set1_pd(1.0);
+
+		for(size_t Block = 0; Block < Blocks; Block++)
+		{
+			const __m512i Result = _mm512_add_epi64(S0, S3);
+			const __m512i T = _mm512_slli_epi64(S1, 17);
+
+			S2 = _mm512_xor_si512(S2, S0);
+			S3 = _mm512_xor_si512(S3, S1);
+			S1 = _mm512_xor_si512(S1, S2);
+			S0 = _mm512_xor_si512(S0, S3);
+			S2 = _mm512_xor_si512(S2, T);
+			S3 = _mm512_rol_epi64(S3, 45);
+
+			const __m512d ResultDouble = _mm512_sub_pd(_mm512_castsi512_pd(_mm512_or_si512(_mm512_srli_epi64(Result, 12), One)), OneDouble);
+			_mm512_storeu_pd(Output + Block * RandomLanes, ResultDouble);
+		}
+
+		_mm512_storeu_si512(State + 0 * RandomLanes, S0);
+		_mm512_storeu_si512(State + 1 * RandomLanes, S1);
+		_mm512_storeu_si512(State + 2 * RandomLanes, S2);
+		_mm512_storeu_si512(State + 3 * RandomLanes, S3);
+	}
+#if defined(__GNUC__) && !defined(__clang__)
+	#pragma GCC diagnostic pop
+#endif
+
+	PSOSPP_KERNELS_TARGET("avx512f")
+	void UpdateVelocitiesAVX512(const size_t & Size, const double & Chi, const double & Fi1, const double & Fi2, const double * R1, const double * R2, const double * BestPriorities, const double * ParticleBestPriorities, double * Velocities, double * Priorities)
+	{
+		const __m512d ChiVector = _mm512_set1_pd(Chi);
+		const __m512d Fi1Vector = _mm512_set1_pd(Fi1);
+		const __m512d Fi2Vector = _mm512_set1_pd(Fi2);
+
+		size_t Index = 0;
+		for(; Index + 8 <= Size; Index += 8)
+		{
+			const __m512d P = _mm512_loadu_pd(Priorities + Index);
+
+			const __m512d Local = _mm512_mul_pd(_mm512_mul_pd(Fi1Vector, _mm512_loadu_pd(R1 + Index)), _mm512_sub_pd(_mm512_loadu_pd(BestPriorities + Index), P));
+			const __m512d Social = _mm512_mul_pd(_mm512_mul_pd(Fi2Vector, _mm512_loadu_pd(R2 + Index)), _mm512_sub_pd(_mm512_loadu_pd(ParticleBestPriorities + Index), P));
+			const __m512d V = _mm512_mul_pd(ChiVector, _mm512_add_pd(_mm512_add_pd(_mm512_loadu_pd(Velocities + Index), Local), Social));
+
+			_mm512_storeu_pd(Velocities + Index, V);
+			_mm512_storeu_pd(Priorities + Index, _mm512_add_pd(P, V));
+		}
+
+		UpdateVelocitiesScalar(Size - Index, Chi, Fi1, Fi2, R1 + Index, R2 + Index, BestPriorities + Index, ParticleBestPriorities + Index, Velocities + Index, Priorities + Index);
+	}
+#endif
+
+	/*
+		Wykrywanie możliwości procesora
+	*/
+	ParticleKernels::InstructionSet_t DetectInstructionSet()
+	{
+#if defined(PSOSPP_KERNELS_X86)
+	#if defined(_MSC_VER)
+		int CpuInfo[4];
+
+		__cpuid(CpuInfo, 0);
+		const int FunctionIdMax = CpuInfo[0];
+
+		__cpuid(CpuInfo, 1);
+		const bool SSE2 = (CpuInfo[3] & (1 << 26)) != 0;
+		const bool OSXSAVE = (CpuInfo[2] & (1 << 27)) != 0;
+		const bool AVX = (CpuInfo[2] & (1 << 28)) != 0;
+
+		bool AVX2 = false;
+		bool AVX512 = false;
+		if(FunctionIdMax >= 7 && OSXSAVE && AVX && (_xgetbv(0) & 0x6) == 0x6)
+		{
+			__cpuidex(CpuInfo, 7, 0);
+			AVX2 = (CpuInfo[1] & (1 << 5)) != 0;
+
+			// AVX-512F + zapis rejestrów opmask / ZMM przez system
+			AVX512 = (CpuInfo[1] & (1 << 16)) != 0 && (_xgetbv(0) & 0xE6) == 0xE6;
+		}
+	#else
+		__builtin_cpu_init();
+		const bool SSE2 = __builtin_cpu_supports("sse2");
+		const bool AVX2 = __builtin_cpu_supports("avx2");
+		const bool AVX512 = __builtin_cpu_supports("avx512f");
+	#endif
+
+		if(AVX2 && AVX512)
+			return ParticleKernels::InstructionSet_t::AVX512;
+
+		if(AVX2)
+			return ParticleKernels::InstructionSet_t::AVX2;
+
+		if(SSE2)
+			return ParticleKernels::InstructionSet_t::SSE2;
+#endif
+
+		return ParticleKernels::InstructionSet_t::Scalar;
+	}
+
+	/*
+		Implementacje jąder dla jednego zestawu instrukcji
+	*/
+	struct Implementations_t
+	{
+		ParticleKernels::InstructionSet_t InstructionSet;
+		NeighborArgMin_t NeighborArgMin;
+		RandomUniformBlocks_t RandomUniformBlocks;
+		UpdateVelocities_t UpdateVelocities;
+	};
+
+	// Stałe tablice inicjowane statycznie - wskaźnik na nie można publikować bez synchronizacji danych
+	const Implementations_t ImplementationsScalar = { ParticleKernels::InstructionSet_t::Scalar, &NeighborArgMinScalar, &RandomUniformBlocksScalar, &UpdateVelocitiesScalar };
+#if defined(PSOSPP_KERNELS_X86)
+	const Implementations_t ImplementationsSSE2 = { ParticleKernels::InstructionSet_t::SSE2, &NeighborArgMinSSE2, &RandomUniformBlocksScalar, &UpdateVelocitiesSSE2 };
+	const Implementations_t ImplementationsAVX2 = { ParticleKernels::InstructionSet_t::AVX2, &NeighborArgMinAVX2, &RandomUniformBlocksAVX2, &UpdateVelocitiesAVX2 };
+	const Implementations_t ImplementationsAVX512 = { ParticleKernels::InstructionSet_t::AVX512, &NeighborArgMinAVX2, &RandomUniformBlocksAVX512, &UpdateVelocitiesAVX512 };
+#endif
+
+	const Implementations_t * SelectImplementations(const ParticleKernels::InstructionSet_t & InstructionSet)
+	{
+		switch(InstructionSet)
+		{
+#if defined(PSOSPP_KERNELS_X86)
+			case ParticleKernels::InstructionSet_t::AVX512:
+				return &ImplementationsAVX512;
+
+			case ParticleKernels::InstructionSet_t::AVX2:
+				return &ImplementationsAVX2;
+
+			case ParticleKernels::InstructionSet_t::SSE2:
+				return &ImplementationsSSE2;
+#endif
+
+			default:
+				return &ImplementationsScalar;
+		}
+	}
+
+	const ParticleKernels::InstructionSet_t InstructionSetSupported = DetectInstructionSet();
+
+	/*
+		Aktualnie wybrane implementacje. SetInstructionSet może być wywołane w trakcie obliczeń na innych wątkach -
+		każde wywołanie jądra odczytuje wskaźnik raz i wykonuje w całości jedną implementację (wszystkie dają identyczne wyniki)
+	*/
+	std::atomic<const Implementations_t *> Implementations(SelectImplementations(InstructionSetSupported));
+}
+
+ParticleKernels::InstructionSet_t ParticleKernels::GetInstructionSetSupported()
+{
+	return InstructionSetSupported;
+}
+
+ParticleKernels::InstructionSet_t ParticleKernels::GetInstructionSet()
+{
+	return Implementations.load(std::memory_order_relaxed)->InstructionSet;
+}
+
+void ParticleKernels::SetInstructionSet(const InstructionSet_t & InstructionSet)
+{
+	if(InstructionSet > InstructionSetSupported)
+		throw std::invalid_argument("InstructionSet > InstructionSetSupported");
+
+	Implementations.store(SelectImplementations(InstructionSet), std::memory_order_relaxed);
+}
+
+const char * ParticleKernels::GetInstructionSetName(const InstructionSet_t & InstructionSet)
+{
+	switch(InstructionSet)
+	{
+		case InstructionSet_t::AVX512:
+			return "AVX-512";
+
+		case InstructionSet_t::AVX2:
+			return "AVX2";
+
+		case InstructionSet_t::SSE2:
+			return "SSE2";
+
+		default:
+			return "Scalar";
+	}
+}
+
+size_t ParticleKernels::NeighborArgMin(const Graph::Neighbors_t & Neighbors, const double * Priorities, const uint32_t * VisitedMarks, const uint32_t & VisitedMark)
+{
+	return Implementations.load(std::memory_order_relaxed)->NeighborArgMin(Neighbors, Priorities, VisitedMarks, VisitedMark);
+}
+
+void ParticleKernels::RandomUniformBlocks(uint64_t * State, double * Output, const size_t & Blocks)
+{
+	Implementations.load(std::memory_order_relaxed)->RandomUniformBlocks(State, Output, Blocks);
+}
+
+void ParticleKernels::UpdateVelocities(const size_t & Size, const double & Chi, const double & Fi1, const double & Fi2, const double * R1, const double * R2, const double * BestPriorities, const double * ParticleBestPriorities, double * Velocities, double * Priorities)
+{
+	Implementations.load(std::memory_order_relaxed)->UpdateVelocities(Size, Chi, Fi1, Fi2, R1, R2, BestPriorities, ParticleBestPriorities, Velocities, Priorities);
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Graph.hpp"
+
+/*
+	Wektoryzowane (SIMD) jądra obliczeniowe gorących pętli cząstki.
+
+	Każde jądro ma implementację skalarną oraz implementacje SSE2 / AVX2 / AVX-512 (lub korzysta z implementacji niższego poziomu).
+	Wybór implementacji następuje raz, przy starcie programu, na podstawie możliwości procesora (runtime dispatch).
+	Wszystkie implementacje dają identyczne wyniki.
+*/
+class ParticleKernels
+{
+	public:
+		// Zestaw instrukcji wykorzystywany przez jądra
+		enum class InstructionSet_t
+		{
+			Scalar,
+			SSE2,
+			AVX2,
+			AVX512,
+		};
+
+		// Liczba niezależnych torów generatora liczb losowych (RandomUniformBlocks)
+		static const size_t RandomLanes = 8;
+
+	public:
+		/*
+			Najlepszy zestaw instrukcji obsługiwany przez procesor
+		*/
+		static InstructionSet_t GetInstructionSetSupported();
+
+		/*
+			Aktualnie używany zestaw instrukcji
+		*/
+		static InstructionSet_t GetInstructionSet();
+
+		/*
+			Wymusza zestaw instrukcji (np. w celu porównania wydajności). Bezpieczne z dowolnego wątku, również w trakcie obliczeń.
+			Zestaw nieobsługiwany przez procesor powoduje wyjątek std::invalid_argument
+		*/
+		static void SetInstructionSet(const InstructionSet_t & InstructionSet);
+
+		/*
+			Nazwa zestawu instrukcji
+		*/
+		static const char * GetInstructionSetName(const InstructionSet_t & InstructionSet);
+
+	public:
+		/*
+			Krok dekodowania cząstki - wybór następnego wierzchołka.
+
+			Spośród sąsiadów (Neighbors) nieodwiedzonych (VisitedMarks[Sąsiad] != VisitedMark) wybiera tego, dla którego Priorities[Sąsiad] * Waga krawędzi jest najmniejsze.
+			Przy równych wartościach wybierany jest sąsiad występujący wcześniej na liście.
+
+			Zwraca pozycję sąsiada na liście Neighbors lub Neighbors.Size jeśli wszyscy sąsiedzi zostali odwiedzeni.
+		*/
+		static size_t NeighborArgMin(const Graph::Neighbors_t & Neighbors, const double * Priorities, const uint32_t * VisitedMarks, const uint32_t & VisitedMark);
+
+		/*
+			Generator xoshiro256+ w RandomLanes niezależnych torach.
+
+			State - stan generatora, 4 słowa po RandomLanes torów (State[Słowo * RandomLanes + Tor])
+			Output - Blocks * RandomLanes liczb z zakresu [0.0; 1.0), kolejne bloki zawierają po jednej liczbie z każdego toru
+		*/
+		static void RandomUniformBlocks(uint64_t * State, double * Output, const size_t & Blocks);
+
+		/*
+			Krok aktualizacji prędkości i położenia cząstki (wzory 2.3 i 2.2):
+				Velocities = Chi * (Velocities + Fi1 * R1 * (BestPriorities - Priorities) + Fi2 * R2 * (ParticleBestPriorities - Priorities))
+				Priorities += Velocities
+
+			Size - rozmiar wszystkich tablic
+			R1, R2 - czynniki losowe z zakresu [0.0; 1.0)
+		*/
+		static void UpdateVelocities(const size_t & Size, const double & Chi, const double & Fi1, const double & Fi2, const double * R1, const double * R2, const double * BestPriorities, const double * ParticleBestPriorities, double * Velocities, double * Priorities);
+};
+
@@ -0,0 +1,151 @@
+#include "PathLocalSearch.hpp"
+
+#include <cmath>
+#include <limits>
+
+bool PathLocalSearch::Improve(const Graph & G, DecodeScratch & Scratch)
+{
+	const std::vector<Graph::VertexIndex_t> & VertexIndexes = Scratch.GetVertexIndexes();
+
+	bool Improved = false;
+	Scratch.IndexPath();
+
+	size_t PositionBegin = 0;
+	while(PositionBegin + 1 < VertexIndexes.size())
+	{
+		// Najlepsze zastąpienie fragmentu zaczynającego się w PositionBegin
+		GraphPath::PathWeight_t SavingBest = 0;
+		size_t PositionEndBest = 0;
+		bool HasVertexBest = false;
+		Graph::VertexIndex_t VertexIndexBest = 0;
+		Graph::EdgeWeight_t EdgeWeightInBest = 0;
+		Graph::EdgeWeight_t EdgeWeightOutBest = 0;
+
+		const Graph::VertexIndex_t VertexIndexBegin = VertexIndexes[PositionBegin];
+		const Graph::Neighbors_t NeighborsBegin = G.GetNeighbors(VertexIndexBegin, Scratch.GetNeighborsBuffer());
+		const GraphPath::PathWeight_t PathWeightPrefixBegin = Scratch.GetPathWeightPrefix(PositionBegin);
+
+		// Czy zastąpienie o zysku Saving kończące się w PositionEnd jest lepsze od dotychczasowego. Przy remisie - wcześniejszy koniec fragmentu
+		const auto IsBetter = [&](const GraphPath::PathWeight_t & Saving, const size_t & PositionEnd)
+		{
+			return Saving > SavingBest || (Saving > 0 && Saving == SavingBest && PositionEnd < PositionEndBest);
+		};
+
+		/*
+			Skrót - bezpośrednia krawędź do dalszego wierzchołka ścieżki. Zamiast pytać graf o krawędź do każdej pozycji (O(L) na początek fragmentu)
+			przeglądamy sąsiadów początku - pozycję sąsiada na ścieżce i wagę fragmentu dają IndexPath i sumy prefiksowe, razem O(stopień wierzchołka)
+		*/
+		for(size_t NeighborId = 0; NeighborId < NeighborsBegin.Size; NeighborId++)
+		{
+			const Graph::VertexIndex_t NeighborVertexIndex = NeighborsBegin.VertexIndexes[NeighborId];
+			if(!Scratch.IsOnPath(NeighborVertexIndex))
+				continue;
+
+			const size_t PositionEnd = Scratch.GetPathPosition(NeighborVertexIndex);
+			if(PositionEnd < PositionBegin + 2)
+				continue;
+
+			const GraphPath::PathWeight_t SegmentWeight = Scratch.GetPathWeightPrefix(PositionEnd) - PathWeightPrefixBegin;
+			const Graph::EdgeWeight_t EdgeWeight = NeighborsBegin.EdgeWeights[NeighborId];
+			if(EdgeWeight < SegmentWeight && IsBetter(SegmentWeight - EdgeWeight, PositionEnd))
+			{
+				SavingBest = SegmentWeight - EdgeWeight;
+				PositionEndBest = PositionEnd;
+				HasVertexBest = false;
+				EdgeWeightInBest = EdgeWeight;
+			}
+		}
+
+		for(size_t PositionEnd = PositionBegin + 1; PositionEnd < VertexIndexes.size() && PositionEnd <= PositionBegin + SegmentEdgesMax; PositionEnd++)
+		{
+			const Graph::VertexIndex_t VertexIndexEnd = VertexIndexes[PositionEnd];
+			const GraphPath::PathWeight_t SegmentWeight = Scratch.GetPathWeightPrefix(PositionEnd) - PathWeightPrefixBegin;
+
+			// Droga przez jeden wierzchołek - wspólni sąsiedzi końców fragmentu. Obie listy posortowane rosnąco - scalanie
+			const Graph::Neighbors_t NeighborsEnd = G.GetNeighbors(VertexIndexEnd, Scratch.GetNeighborsBufferSecond());
+
+			size_t NeighborBeginId = 0;
+			size_t NeighborEndId = 0;
+			while(NeighborBeginId < NeighborsBegin.Size && NeighborEndId < NeighborsEnd.Size)
+			{
+				const Graph::VertexIndex_t NeighborBegin = NeighborsBegin.VertexIndexes[NeighborBeginId];
+				const Graph::VertexIndex_t NeighborEnd = NeighborsEnd.VertexIndexes[NeighborEndId];
+
+				if(NeighborBegin < NeighborEnd)
+				{
+					++NeighborBeginId;
+					continue;
+				}
+				if(NeighborEnd < NeighborBegin)
+				{
+					++NeighborEndId;
+					continue;
+				}
+
+				// Wierzchołek ze ścieżki utworzyłby cykl
+				const GraphPath::PathWeight_t Weight = (GraphPath::PathWeight_t) NeighborsBegin.EdgeWeights[NeighborBeginId] + NeighborsEnd.EdgeWeights[NeighborEndId];
+				if(!Scratch.IsOnPath(NeighborBegin) && Weight < SegmentWeight && IsBetter(SegmentWeight - Weight, PositionEnd))
+				{
+					SavingBest = SegmentWeight - Weight;
+					PositionEndBest = PositionEnd;
+					HasVertexBest = true;
+					VertexIndexBest = NeighborBegin;
+					EdgeWeightInBest = NeighborsBegin.EdgeWeights[NeighborBeginId];
+					EdgeWeightOutBest = NeighborsEnd.EdgeWeights[NeighborEndId];
+				}
+
+				++NeighborBeginId;
+				++NeighborEndId;
+			}
+		}
+
+		// Brak poprawy - następny początek fragmentu
+		if(SavingBest == 0)
+		{
+			++PositionBegin;
+			continue;
+		}
+
+		// Poprawa - ten sam początek może dać się poprawić ponownie
+		Scratch.ReplaceSegment(PositionBegin, PositionEndBest, HasVertexBest, VertexIndexBest, EdgeWeightInBest, EdgeWeightOutBest);
+		Scratch.IndexPath();
+		Improved = true;
+	}
+
+	return Improved;
+}
+
+void PathLocalSearch::WriteBack(const Graph & G, DecodeScratch & Scratch, Particle::Priority_t * Priorities)
+{
+	const std::vector<Graph::VertexIndex_t> & VertexIndexes = Scratch.GetVertexIndexes();
+	const std::vector<Graph::EdgeWeight_t> & EdgeWeights = Scratch.GetEdgeWeights();
+
+	Scratch.IndexPath();
+
+	for(size_t Position = VertexIndexes.size() - 1; Position > 0; Position--)
+	{
+		// Krok dekodowania z wierzchołka Position - 1, oczekiwany wybór: Position
+		const Graph::VertexIndex_t VertexIndexNext = VertexIndexes[Position];
+		const Graph::Neighbors_t Neighbors = G.GetNeighbors(VertexIndexes[Position - 1], Scratch.GetNeighborsBuffer());
+
+		// Najmniejszy iloczyn waga * priorytet pozostałych kandydatów - sąsiadów nieodwiedzonych w tym kroku
+		double ValueOtherMin = std::numeric_limits<double>::infinity();
+		for(size_t NeighborId = 0; NeighborId < Neighbors.Size; NeighborId++)
+		{
+			const Graph::VertexIndex_t NeighborVertexIndex = Neighbors.VertexIndexes[NeighborId];
+			if(NeighborVertexIndex == VertexIndexNext || (Scratch.IsOnPath(NeighborVertexIndex) && Scratch.GetPathPosition(NeighborVertexIndex) < Position))
+				continue;
+
+			ValueOtherMin = std::min(ValueOtherMin, Neighbors.EdgeWeights[NeighborId] * Priorities[NeighborVertexIndex]);
+		}
+
+		// Kolejny wierzchołek ścieżki musi mieć ściśle mniejszą wartość - przy remisie dekoder wybiera wcześniejszego sąsiada.
+		// Krawędź o wadze 0 ma wartość 0 niezależnie od priorytetu - zmiana priorytetu nic nie da (a dzielenie dałoby -inf lub NaN)
+		const double EdgeWeight = EdgeWeights[Position];
+		if(EdgeWeight == 0)
+			continue;
+
+		if(ValueOtherMin != std::numeric_limits<double>::infinity() && EdgeWeight * Priorities[VertexIndexNext] >= ValueOtherMin)
+			Priorities[VertexIndexNext] = (ValueOtherMin - std::max(std::abs(ValueOtherMin) * 1e-6, 1e-9)) / EdgeWeight;
+	}
+}
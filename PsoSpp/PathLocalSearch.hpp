@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Graph.hpp"
+#include "DecodeScratch.hpp"
+#include "Particle.hpp"
+
+/*
+	Przeszukiwanie lokalne ścieżki zdekodowanej przez cząstkę.
+
+	Zachłanny dekoder często omija krawędź łączącą dwa niesąsiednie wierzchołki ścieżki albo wybiera drogę przez droższy wierzchołek.
+	Improve poprawia ścieżkę w buforze DecodeScratch, zastępując fragment P[I] .. P[J]:
+		- bezpośrednią krawędzią P[I] - P[J] (skrót), dla dowolnego J > I + 1
+		- drogą przez jeden wierzchołek spoza ścieżki (najkrótsza ścieżka o dwóch krawędziach), dla J <= I + SegmentEdgesMax
+	jeśli zastąpienie zmniejsza wagę ścieżki. Dla każdego I wybierane jest zastąpienie o największym zysku, aż do braku poprawy.
+
+	WriteBack dopasowuje priorytety cząstki tak, by dekodowanie odtworzyło poprawioną ścieżkę.
+	Operacje nie alokują pamięci - korzystają wyłącznie z buforów DecodeScratch.
+*/
+class PathLocalSearch
+{
+	public:
+		enum class Mode_t
+		{
+			None, // bez przeszukiwania lokalnego
+			Path, // poprawa ścieżki
+			PathAndPriorities, // poprawa ścieżki i zapis do priorytetów cząstki (WriteBack)
+		};
+
+		// Najdłuższy fragment (w krawędziach) zastępowany drogą przez jeden wierzchołek
+		static const size_t SegmentEdgesMax = 3;
+
+	public:
+		/*
+			Poprawia ścieżkę zapisaną w Scratch (po zakończonym dekodowaniu). Zwraca, czy ścieżka uległa zmianie
+		*/
+		static bool Improve(const Graph & G, DecodeScratch & Scratch);
+
+		/*
+			Obniża priorytety wierzchołków ścieżki ze Scratch tak, by dekoder w każdym kroku wybrał kolejny wierzchołek ścieżki.
+
+			Kroki przetwarzane są od końca: obniżenie priorytetu P[K + 1] wpływa tylko na kroki 0 .. K (w późniejszych P[K + 1] jest już odwiedzony),
+			a te są przetwarzane później i uwzględniają nową wartość. Priorytety wierzchołków spoza ścieżki nie są zmieniane.
+			Krok po krawędzi o wadze 0 jest pomijany - wartości waga * priorytet nie da się zmienić priorytetem.
+		*/
+		static void WriteBack(const Graph & G, DecodeScratch & Scratch, Particle::Priority_t * Priorities);
+};
+
@@ -0,0 +1,108 @@
+#include "PerformanceCounters.hpp"
+
+#include <iomanip>
+
+PerformanceCounters::Values_t & PerformanceCounters::Values_t::operator+=(const Values_t & Other)
+{
+	Iterations += Other.Iterations;
+	Decodes += Other.Decodes;
+	DecodeSteps += Other.DecodeSteps;
+	DecodeDeadEnds += Other.DecodeDeadEnds;
+	Improvements += Other.Improvements;
+	TargetImprovements += Other.TargetImprovements;
+	Reinitializations += Other.Reinitializations;
+	DecodeNanoseconds += Other.DecodeNanoseconds;
+	UpdateNanoseconds += Other.UpdateNanoseconds;
+	NumaPagesLocal += Other.NumaPagesLocal;
+	NumaPagesRemote += Other.NumaPagesRemote;
+	return *this;
+}
+
+PerformanceCounters::PerformanceCounters():
+	Iterations(0), Decodes(0), DecodeSteps(0), DecodeDeadEnds(0), Improvements(0), TargetImprovements(0), Reinitializations(0), DecodeNanoseconds(0), UpdateNanoseconds(0), NumaPagesLocal(0), NumaPagesRemote(0)
+{
+
+}
+
+void PerformanceCounters::Add(const Values_t & Values)
+{
+	Iterations.fetch_add(Values.Iterations, std::memory_order_relaxed);
+	Decodes.fetch_add(Values.Decodes, std::memory_order_relaxed);
+	DecodeSteps.fetch_add(Values.DecodeSteps, std::memory_order_relaxed);
+	DecodeDeadEnds.fetch_add(Values.DecodeDeadEnds, std::memory_order_relaxed);
+	Improvements.fetch_add(Values.Improvements, std::memory_order_relaxed);
+	TargetImprovements.fetch_add(Values.TargetImprovements, std::memory_order_relaxed);
+	Reinitializations.fetch_add(Values.Reinitializations, std::memory_order_relaxed);
+	DecodeNanoseconds.fetch_add(Values.DecodeNanoseconds, std::memory_order_relaxed);
+	UpdateNanoseconds.fetch_add(Values.UpdateNanoseconds, std::memory_order_relaxed);
+	NumaPagesLocal.fetch_add(Values.NumaPagesLocal, std::memory_order_relaxed);
+	NumaPagesRemote.fetch_add(Values.NumaPagesRemote, std::memory_order_relaxed);
+}
+
+PerformanceCounters::Values_t PerformanceCounters::GetValues() const
+{
+	Values_t Values;
+	Values.Iterations = Iterations.load(std::memory_order_relaxed);
+	Values.Decodes = Decodes.load(std::memory_order_relaxed);
+	Values.DecodeSteps = DecodeSteps.load(std::memory_order_relaxed);
+	Values.DecodeDeadEnds = DecodeDeadEnds.load(std::memory_order_relaxed);
+	Values.Improvements = Improvements.load(std::memory_order_relaxed);
+	Values.TargetImprovements = TargetImprovements.load(std::memory_order_relaxed);
+	Values.Reinitializations = Reinitializations.load(std::memory_order_relaxed);
+	Values.DecodeNanoseconds = DecodeNanoseconds.load(std::memory_order_relaxed);
+	Values.UpdateNanoseconds = UpdateNanoseconds.load(std::memory_order_relaxed);
+	Values.NumaPagesLocal = NumaPagesLocal.load(std::memory_order_relaxed);
+	Values.NumaPagesRemote = NumaPagesRemote.load(std::memory_order_relaxed);
+	return Values;
+}
+
+void PerformanceCounters::WriteJson(const Values_t & Values, std::ostream & Stream)
+{
+	Stream << "{";
+	Stream << "\"iterations\":" << Values.Iterations << ",";
+	Stream << "\"decodes\":" << Values.Decodes << ",";
+	Stream << "\"decode_steps\":" << Values.DecodeSteps << ",";
+	Stream << "\"decode_dead_ends\":" << Values.DecodeDeadEnds << ",";
+	Stream << "\"improvements\":" << Values.Improvements << ",";
+	Stream << "\"target_improvements\":" << Values.TargetImprovements << ",";
+	Stream << "\"reinitializations\":" << Values.Reinitializations << ",";
+	Stream << "\"decode_nanoseconds\":" << Values.DecodeNanoseconds << ",";
+	Stream << "\"update_nanoseconds\":" << Values.UpdateNanoseconds << ",";
+	Stream << "\"numa_pages_local\":" << Values.NumaPagesLocal << ",";
+	Stream << "\"numa_pages_remote\":" << Values.NumaPagesRemote;
+	Stream << "}";
+}
+
+void PerformanceCounters::WritePrometheus(const Values_t & Values, std::ostream & Stream, const std::string & Prefix)
+{
+	const auto WriteHeader = [&](const char * Name, const char * Help)
+	{
+		Stream << "# HELP " << Prefix << "_" << Name << " " << Help << "\n";
+		Stream << "# TYPE " << Prefix << "_" << Name << " counter\n";
+	};
+
+	const auto WriteCounter = [&](const char * Name, const char * Help, const Count_t & Value)
+	{
+		WriteHeader(Name, Help);
+		Stream << Prefix << "_" << Name << " " << Value << "\n";
+	};
+
+	// Czas w sekundach - konwencja Prometheus
+	const auto WriteSeconds = [&](const char * Name, const char * Help, const Count_t & Nanoseconds)
+	{
+		WriteHeader(Name, Help);
+		Stream << Prefix << "_" << Name << " " << Nanoseconds / 1000000000 << "." << std::setw(9) << std::setfill('0') << Nanoseconds % 1000000000 << std::setfill(' ') << "\n";
+	};
+
+	WriteCounter("iterations_total", "Particle group iterations.", Values.Iterations);
+	WriteCounter("decodes_total", "Particle decodes (Particle::Run).", Values.Decodes);
+	WriteCounter("decode_steps_total", "Vertices visited while decoding.", Values.DecodeSteps);
+	WriteCounter("decode_dead_ends_total", "Decodes that ended without reaching the end vertex.", Values.DecodeDeadEnds);
+	WriteCounter("improvements_total", "Decodes that improved the particle best solution.", Values.Improvements);
+	WriteCounter("target_improvements_total", "Improvements of a chunk best path to one of the targets of a multi-target task.", Values.TargetImprovements);
+	WriteCounter("reinitializations_total", "Random reinitializations of all particles of a group after stagnation.", Values.Reinitializations);
+	WriteSeconds("decode_seconds_total", "Thread time spent decoding particles.", Values.DecodeNanoseconds);
+	WriteSeconds("update_seconds_total", "Thread time spent updating particles.", Values.UpdateNanoseconds);
+	WriteCounter("numa_pages_local_total", "Pages of group swarm state and graph copies placed on the NUMA node of the group.", Values.NumaPagesLocal);
+	WriteCounter("numa_pages_remote_total", "Pages of group swarm state and graph copies placed on another NUMA node than the group.", Values.NumaPagesRemote);
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+/*
+	Liczniki wydajności gorących pętli roju - współdzielone przez wszystkie grupy jednego zapytania.
+
+	Zliczanie odbywa się bez blokad w dwóch stopniach:
+		- fragment grupy (ParticleGroup::Chunk_t), wykonywany w danej chwili przez jeden wątek, zlicza do własnych, zwykłych pól Values_t
+		- grupa po każdej iteracji sumuje swoje fragmenty i dodaje wynik do PerformanceCounters - kilka relaksowanych operacji atomowych na iterację grupy
+	Dzięki temu GetValues() można wołać z dowolnego wątku w trakcie obliczeń (np. monitorowanie zapytania Solver), a koszt w pętli dekodowania to kilka inkrementacji.
+	Odczyt nie jest migawką spójną pomiędzy licznikami - każdy licznik odczytywany jest osobno.
+*/
+class PerformanceCounters
+{
+	public:
+		typedef uint64_t Count_t;
+
+		struct Values_t
+		{
+			// Wykonane iteracje grup
+			Count_t Iterations = 0;
+
+			// Dekodowania (Particle::Run), kroki dekodowania (odwiedzone wierzchołki) i dekodowania zakończone w ślepym zaułku
+			Count_t Decodes = 0;
+			Count_t DecodeSteps = 0;
+			Count_t DecodeDeadEnds = 0;
+
+			// Dekodowania, które poprawiły najlepsze rozwiązanie cząstki
+			Count_t Improvements = 0;
+
+			// Zadanie wielocelowe - poprawy najlepszej ścieżki fragmentu do któregoś z celów (TargetBest::Offer)
+			Count_t TargetImprovements = 0;
+
+			// Reinicjalizacje wszystkich cząstek grupy po ParticleBetterSolutionFoundNoCountMax iteracjach bez poprawy
+			Count_t Reinitializations = 0;
+
+			// Czas (zegar rzeczywisty) dekodowania i aktualizacji cząstek - suma po fragmentach. Przy większej liczbie wątków niż rdzeni obejmuje też wywłaszczenia
+			Count_t DecodeNanoseconds = 0;
+			Count_t UpdateNanoseconds = 0;
+
+			// Rozmieszczenie NUMA (ParticleGroupRunner::SetPlacement) - strony stanu roju grup i kopii grafu na węźle grupy oraz na innych węzłach
+			Count_t NumaPagesLocal = 0;
+			Count_t NumaPagesRemote = 0;
+
+			Values_t & operator+=(const Values_t & Other);
+		};
+
+	public:
+		PerformanceCounters();
+		PerformanceCounters(const PerformanceCounters &) = delete;
+		PerformanceCounters & operator=(const PerformanceCounters &) = delete;
+
+	private:
+		std::atomic<Count_t> Iterations;
+		std::atomic<Count_t> Decodes;
+		std::atomic<Count_t> DecodeSteps;
+		std::atomic<Count_t> DecodeDeadEnds;
+		std::atomic<Count_t> Improvements;
+		std::atomic<Count_t> TargetImprovements;
+		std::atomic<Count_t> Reinitializations;
+		std::atomic<Count_t> DecodeNanoseconds;
+		std::atomic<Count_t> UpdateNanoseconds;
+		std::atomic<Count_t> NumaPagesLocal;
+		std::atomic<Count_t> NumaPagesRemote;
+
+	public:
+		/*
+			Dodaje wartości zebrane przez grupę
+		*/
+		void Add(const Values_t & Values);
+
+		/*
+			Bieżące wartości liczników
+		*/
+		Values_t GetValues() const;
+
+	public:
+		/*
+			Zapis wartości jako obiekt JSON (jedna linia)
+		*/
+		static void WriteJson(const Values_t & Values, std::ostream & Stream);
+
+		/*
+			Zapis wartości w formacie tekstowym Prometheus - liczniki (counter) z przedrostkiem Prefix, np. Prefix = "psospp" -> psospp_decodes_total.
+			Czasy zapisywane są w sekundach (psospp_decode_seconds_total)
+		*/
+		static void WritePrometheus(const Values_t & Values, std::ostream & Stream, const std::string & Prefix);
+};
@@ -0,0 +1,421 @@
+#include "ProcessRunner.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+#include "GlobalBest.hpp"
+#include "MigrationMailbox.hpp"
+#include "SharedRegion.hpp"
+#include "ThreadPool.hpp"
+
+#if !defined(_WIN32)
+	#include <spawn.h>
+	#include <sys/wait.h>
+	#include <unistd.h>
+
+	extern char ** environ;
+#endif
+
+namespace
+{
+	// Kolejny numer obszaru w procesie - nazwy obszarów kolejnych ProcessRunner się nie powtarzają
+	std::atomic<uint64_t> RegionNumber(0);
+
+	std::string CreateRegionName()
+	{
+	#if defined(_WIN32)
+		const long ProcessId = 0;
+	#else
+		const long ProcessId = (long) getpid();
+	#endif
+		return "/PsoSpp." + std::to_string(ProcessId) + "." + std::to_string(RegionNumber.fetch_add(1));
+	}
+
+	/*
+		Wątek pośredniczący procesu roboczego - wymiana rozwiązań pomiędzy rojem procesu a obszarem współdzielonym, do ustawienia Finished
+	*/
+	void RunBridge(SharedRegion & Region, const size_t & WorkerId, const Task & T, GlobalBest & Best, MigrationMailbox & Inbox, MigrationMailbox & Outbox, StopToken & Stop, const std::atomic<bool> & Finished)
+	{
+		const size_t WorkerNumber = Region.GetDescription().WorkerNumber;
+		const int32_t OwnerProcessId = Region.GetHeader().OwnerProcessId;
+
+		// Bufory odczytu - alokowane raz
+		std::vector<Particle::Priority_t> Priorities(T.GetGraph().GetSize());
+		GraphPath::VertexIndexes_t VertexIndexes;
+		VertexIndexes.reserve(T.GetGraph().GetSize());
+		GraphPath::PathWeight_t PathWeight;
+
+		uint64_t GenerationBest = 0;
+		uint64_t GenerationMigration = 0;
+
+		while(!Finished.load())
+		{
+			// Przerwanie przez właściciela obszaru lub jego awaria
+			if(Region.IsStopRequested() || !SharedRegion::IsProcessAlive(OwnerProcessId))
+				Stop.RequestStop();
+
+			// Najlepsze rozwiązanie procesu lepsze od wspólnego - publikacja (bez ścieżki, GlobalBest jej nie przechowuje)
+			if(Best.GetPathWeight() < Region.GetPathWeight(SharedRegion::SlotBest))
+			{
+				const GlobalBest::Snapshot_t * Snapshot = Best.Acquire();
+				if(Snapshot)
+					Region.Publish(SharedRegion::SlotBest, Snapshot->PathWeight, Snapshot->Priorities.get(), nullptr, 0, true);
+				Best.Release(Snapshot);
+			}
+
+			// Wspólne rozwiązanie lepsze od najlepszego rozwiązania procesu - przyciąga grupy procesu. Brak wolnej migawki - ponowny odczyt w następnym okresie
+			if(Region.Read(SharedRegion::SlotBest, GenerationBest, PathWeight, Priorities.data(), VertexIndexes) && PathWeight < Best.GetPathWeight())
+			{
+				if(!Best.Publish(PathWeight, Priorities.data()))
+					GenerationBest = 0;
+
+				// Poprawa w innym procesie zeruje licznik stagnacji i może spełnić PathWeightTarget
+				Stop.ReportPathWeight(PathWeight);
+			}
+
+			// Migracja - pierścień procesów
+			std::unique_ptr<MigrationMailbox::Migrant_t> Migrant = Outbox.Receive();
+			if(Migrant && WorkerNumber > 1)
+				Region.Publish(SharedRegion::SlotMigration((WorkerId + 1) % WorkerNumber), Migrant->Path.GetPathWeight(), Migrant->Priorities.data(), Migrant->Path.GetVertexIndexes().data(), Migrant->Path.GetVertexIndexes().size(), false);
+
+			if(Region.Read(SharedRegion::SlotMigration(WorkerId), GenerationMigration, PathWeight, Priorities.data(), VertexIndexes) && !VertexIndexes.empty())
+				Inbox.Send(std::unique_ptr<MigrationMailbox::Migrant_t>(new MigrationMailbox::Migrant_t{ Priorities, GraphPath(T.GetGraph(), GraphPath::VertexIndexes_t(VertexIndexes), PathWeight) }));
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(ProcessRunner::BridgeIntervalMilliseconds));
+		}
+	}
+}
+
+const char * const ProcessRunner::WorkerArgument = "--psospp-worker";
+
+ProcessRunner::ProcessRunner(const Task & T, const std::string & GraphFilePath, const size_t & WorkerNumber, const size_t & ThreadNumber, const Solver::Parameters_t & Parameters):
+	T(T), GraphFilePath(GraphFilePath),
+	WorkerNumber(WorkerNumber), ThreadNumber(ThreadNumber), Parameters(Parameters),
+	RegionName(CreateRegionName()),
+	WorkerExecutable("/proc/self/exe"),
+	RandomSeed(ParticleGroupRunner::RandomSeedDefault)
+{
+	if(T.IsMultiTarget())
+		throw std::invalid_argument("T.IsMultiTarget()");
+
+	if(WorkerNumber == 0)
+		throw std::invalid_argument("WorkerNumber == 0");
+
+	if(GraphFilePath.size() >= SharedRegion::GraphFilePathSizeMax)
+		throw std::invalid_argument("GraphFilePath.size() >= SharedRegion::GraphFilePathSizeMax");
+}
+
+const std::string & ProcessRunner::GetRegionName() const
+{
+	return RegionName;
+}
+
+void ProcessRunner::SetWorkerExecutable(const std::string & Path)
+{
+	WorkerExecutable = Path;
+}
+
+void ProcessRunner::SetRandomSeed(const uint32_t & Seed)
+{
+	RandomSeed = Seed;
+}
+
+void ProcessRunner::SetWorkerCpus(const std::vector<std::vector<size_t>> & Cpus)
+{
+	if(!Cpus.empty() && WorkerNumber > SharedRegion::WorkerCpusNumberMax)
+		throw std::invalid_argument("WorkerNumber > SharedRegion::WorkerCpusNumberMax");
+
+	for(const std::vector<size_t> & WorkerCpusItem : Cpus)
+		for(const size_t & Cpu : WorkerCpusItem)
+			if(Cpu >= SharedRegion::CpuNumberMax)
+				throw std::invalid_argument("Cpu >= SharedRegion::CpuNumberMax");
+
+	WorkerCpus = Cpus;
+}
+
+ProcessRunner::RunResult_t ProcessRunner::Run(StopToken & Stop)
+{
+	const StopToken::Criteria_t & Criteria = Stop.GetCriteria();
+
+	SharedRegion::Description_t Description = {};
+	std::strncpy(Description.GraphFilePath, GraphFilePath.c_str(), SharedRegion::GraphFilePathSizeMax - 1);
+	Description.VertexNumber = T.GetGraph().GetSize();
+	Description.VertexIndexStart = T.GetVertexIndexStart();
+	Description.VertexIndexEnd = T.GetVertexIndexEnd();
+	Description.WorkerNumber = (uint32_t) WorkerNumber;
+	Description.ThreadNumber = (uint32_t) ThreadNumber;
+	Description.RandomSeed = RandomSeed;
+	Description.Parameters = Parameters;
+	Description.DeadlineNanoseconds = Criteria.Deadline == std::chrono::steady_clock::time_point::max() ? std::numeric_limits<int64_t>::max() : (int64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(Criteria.Deadline.time_since_epoch()).count();
+	Description.PathWeightTarget = Criteria.PathWeightTarget;
+	Description.StagnationIterationsMax = Criteria.StagnationIterationsMax;
+	if(!WorkerCpus.empty())
+		for(size_t WorkerId = 0; WorkerId < WorkerNumber; WorkerId++)
+			SharedRegion::SetWorkerCpus(Description, WorkerId, WorkerCpus[WorkerId % WorkerCpus.size()]);
+
+	SharedRegion Region(RegionName, Description);
+
+#if !defined(_WIN32)
+	// Uruchomione procesy - 0 po odebraniu stanu zakończenia
+	std::vector<pid_t> ProcessIds;
+	if(!WorkerExecutable.empty())
+	{
+		for(size_t WorkerId = 0; WorkerId < WorkerNumber; WorkerId++)
+		{
+			char * Arguments[] = { const_cast<char *>(WorkerExecutable.c_str()), const_cast<char *>(WorkerArgument), const_cast<char *>(RegionName.c_str()), nullptr };
+
+			// Proces, którego nie udało się uruchomić, nie zajmie miejsca - zostanie policzony jako awaria
+			pid_t ProcessId;
+			if(posix_spawn(&ProcessId, WorkerExecutable.c_str(), nullptr, nullptr, Arguments, environ) == 0)
+				ProcessIds.push_back(ProcessId);
+		}
+	}
+#endif
+
+	while(true)
+	{
+		if(Stop.IsStopRequested() || Stop.IsDeadlineReached())
+		{
+			Region.RequestStop();
+
+			// Procesy dołączające, które się jeszcze nie pojawiły, nie są już potrzebne
+			if(WorkerExecutable.empty())
+			{
+				for(size_t WorkerId = 0; WorkerId < WorkerNumber; WorkerId++)
+				{
+					uint32_t State = (uint32_t) SharedRegion::WorkerState_t::Free;
+					Region.GetWorker(WorkerId).State.compare_exchange_strong(State, (uint32_t) SharedRegion::WorkerState_t::Failed);
+				}
+			}
+		}
+
+		// Najlepsza waga wszystkich procesów - widoczna dla właściciela Stop w trakcie obliczeń
+		if(Region.GetPathWeight(SharedRegion::SlotBest) != std::numeric_limits<GraphPath::PathWeight_t>::max())
+			Stop.ReportPathWeight(Region.GetPathWeight(SharedRegion::SlotBest));
+
+	#if !defined(_WIN32)
+		// Odebranie stanu zakończonych procesów - dopiero wtedy przestają istnieć dla IsProcessAlive
+		bool ProcessesRunning = false;
+		for(pid_t & ProcessId : ProcessIds)
+		{
+			if(ProcessId == 0)
+				continue;
+
+			int Status;
+			if(waitpid(ProcessId, &Status, WNOHANG) == ProcessId)
+				ProcessId = 0;
+			else
+				ProcessesRunning = true;
+		}
+	#else
+		const bool ProcessesRunning = false;
+	#endif
+
+		// Proces, który zniknął bez zgłoszenia wyniku, uległ awarii
+		bool WorkersRunning = false;
+		for(size_t WorkerId = 0; WorkerId < WorkerNumber; WorkerId++)
+		{
+			SharedRegion::Worker_t & Worker = Region.GetWorker(WorkerId);
+
+			uint32_t State = Worker.State.load(std::memory_order_acquire);
+			const int32_t ProcessId = Worker.ProcessId.load();
+			if(State == (uint32_t) SharedRegion::WorkerState_t::Attached && ProcessId != 0 && !SharedRegion::IsProcessAlive(ProcessId))
+				Worker.State.compare_exchange_strong(State, (uint32_t) SharedRegion::WorkerState_t::Failed);
+
+			State = Worker.State.load(std::memory_order_acquire);
+			if(State == (uint32_t) SharedRegion::WorkerState_t::Free || State == (uint32_t) SharedRegion::WorkerState_t::Attached)
+				WorkersRunning = true;
+		}
+
+		// Uruchamiane procesy - koniec, gdy wszystkie się zakończą (również te, które nie zdążyły dołączyć). Dołączające - gdy wszystkie miejsca mają wynik
+		if(WorkerExecutable.empty() ? !WorkersRunning : !ProcessesRunning)
+			break;
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(BridgeIntervalMilliseconds));
+	}
+
+	// Zebranie wyników procesów
+	size_t WorkersDone = 0;
+	size_t SteadyStateIterations = 0;
+	AllocationCounter::Count_t SteadyStateAllocations = 0;
+	size_t MigrationsAccepted = 0;
+	bool Stopped = false;
+	PerformanceCounters::Values_t Counters;
+
+	for(size_t WorkerId = 0; WorkerId < WorkerNumber; WorkerId++)
+	{
+		const SharedRegion::Worker_t & Worker = Region.GetWorker(WorkerId);
+		if(Worker.State.load(std::memory_order_acquire) != (uint32_t) SharedRegion::WorkerState_t::Done)
+			continue;
+
+		++WorkersDone;
+		SteadyStateIterations += (size_t) Worker.SteadyStateIterations;
+		SteadyStateAllocations += Worker.SteadyStateAllocations;
+		MigrationsAccepted += (size_t) Worker.MigrationsAccepted;
+		Stopped = Stopped || Worker.Stopped;
+		Counters += Worker.Counters;
+	}
+
+	// Proces bez wyniku przy przerwanym zapytaniu nie wykonał swoich iteracji
+	if(WorkersDone < WorkerNumber && (Stop.IsStopRequested() || Stop.IsDeadlineReached()))
+		Stopped = true;
+
+	// Najlepszy wynik końcowy wszystkich procesów - razem ze ścieżką
+	std::vector<Particle::Priority_t> PrioritiesBest(T.GetGraph().GetSize());
+	GraphPath::VertexIndexes_t VertexIndexes;
+	GraphPath::PathWeight_t PathWeight;
+	uint64_t Generation = 0;
+
+	std::optional<GraphPath> GraphPathBest;
+	if(Region.Read(SharedRegion::SlotResult, Generation, PathWeight, PrioritiesBest.data(), VertexIndexes) && !VertexIndexes.empty())
+		GraphPathBest.emplace(T.GetGraph(), std::move(VertexIndexes), PathWeight);
+	else
+		PrioritiesBest.clear();
+
+	return {
+		{
+			GraphPathBest ? std::optional<const GraphPath>(GraphPathBest.value()) : std::nullopt,
+			SteadyStateIterations,
+			SteadyStateAllocations,
+			MigrationsAccepted,
+			Stopped,
+			Counters,
+			std::vector<std::optional<GraphPath>>(1, GraphPathBest),
+			std::move(PrioritiesBest)
+		},
+		WorkersDone,
+		WorkerNumber - WorkersDone
+	};
+}
+
+bool ProcessRunner::IsWorkerCommandLine(const int & argc, char ** argv)
+{
+	return argc == 3 && std::strcmp(argv[1], WorkerArgument) == 0;
+}
+
+int ProcessRunner::WorkerMain(const int & argc, char ** argv)
+{
+	if(!IsWorkerCommandLine(argc, argv))
+	{
+		std::cerr << "Usage: " << (argc ? argv[0] : "PsoSpp") << " " << WorkerArgument << " REGION" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	try
+	{
+		RunWorker(argv[2]);
+		return EXIT_SUCCESS;
+	}
+	catch(const std::exception & Exception)
+	{
+		std::cerr << "Worker failed: " << Exception.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+}
+
+void ProcessRunner::RunWorker(const std::string & RegionName)
+{
+	SharedRegion Region(RegionName);
+	const SharedRegion::Description_t & Description = Region.GetDescription();
+
+	const size_t WorkerId = Region.AttachWorker();
+	SharedRegion::Worker_t & Worker = Region.GetWorker(WorkerId);
+
+	try
+	{
+		// Proces przypisany do procesorów - ograniczenie przed utworzeniem wątków (pośredniczący, puli) i przed pierwszym zapisem do pamięci roju
+		const std::vector<size_t> Cpus = Region.GetWorkerCpus(WorkerId);
+		if(!Cpus.empty())
+			ThreadPool::BindCurrentThread(Cpus);
+
+		// Ten sam plik co u pozostałych procesów - mapowanie bez kopiowania
+		const Graph G = Graph::Load(Description.GraphFilePath, false, false);
+		if(G.GetSize() != Description.VertexNumber)
+			throw std::runtime_error("Graph file does not match shared memory region: " + std::string(Description.GraphFilePath));
+
+		const Task TWorker(G, Description.VertexIndexStart, Description.VertexIndexEnd);
+
+		StopToken::Criteria_t Criteria;
+		if(Description.DeadlineNanoseconds != std::numeric_limits<int64_t>::max())
+			Criteria.Deadline = std::chrono::steady_clock::time_point(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(Description.DeadlineNanoseconds)));
+		Criteria.PathWeightTarget = Description.PathWeightTarget;
+		Criteria.StagnationIterationsMax = (size_t) Description.StagnationIterationsMax;
+		StopToken Stop(Criteria);
+
+		// Wątki puli przypięte do kolejnych procesorów procesu
+		ThreadPool Pool(Description.ThreadNumber ? Description.ThreadNumber : Cpus.size(), Cpus);
+
+		const Solver::Parameters_t & Parameters = Description.Parameters;
+		ParticleGroupRunner PGR(
+			Pool,
+			TWorker,
+			Parameters.ParticleGroupNumber,
+			Parameters.ParticleNumberTotal,
+			Parameters.ParticleIterations,
+			Parameters.ParticleBetterSolutionFoundNoCountMax,
+			Parameters.Fi1,
+			Parameters.Fi2,
+			Parameters.MigrationInterval,
+			Parameters.MigrationTopology,
+			Parameters.GlobalBestAsync,
+			Parameters.SeedFraction,
+			Parameters.LocalSearch
+		);
+
+		// Każdy proces przeszukuje inną część przestrzeni - ziarno właściciela przesunięte o numer procesu
+		PGR.SetRandomSeed(Description.RandomSeed + (uint32_t) WorkerId);
+
+		// Najlepsze rozwiązanie i skrzynki procesu - łączone z obszarem przez wątek pośredniczący
+		GlobalBest Best(G.GetSize(), Pool.GetThreadNumber() + 3);
+		MigrationMailbox Inbox;
+		MigrationMailbox Outbox;
+		PGR.SetGlobalBest(&Best);
+		PGR.SetProcessMigration(&Inbox, &Outbox);
+
+		std::atomic<bool> Finished(false);
+		std::thread Bridge([&]()
+		{
+			RunBridge(Region, WorkerId, TWorker, Best, Inbox, Outbox, Stop, Finished);
+		});
+
+		std::unique_ptr<ParticleGroupRunner::RunResult_t> Result;
+		try
+		{
+			Result.reset(new ParticleGroupRunner::RunResult_t(PGR.Run(Stop)));
+		}
+		catch(...)
+		{
+			Finished.store(true);
+			Bridge.join();
+			throw;
+		}
+
+		Finished.store(true);
+		Bridge.join();
+
+		// Wynik końcowy - ze ścieżką. Do SlotBest również, jeśli przeszukiwanie lokalne poprawiło rozwiązanie po ostatniej wymianie
+		if(Result->GraphPathBest)
+		{
+			const GraphPath & Path = Result->GraphPathBest.value();
+			Region.Publish(SharedRegion::SlotBest, Path.GetPathWeight(), Result->PrioritiesBest.data(), Path.GetVertexIndexes().data(), Path.GetVertexIndexes().size(), true);
+			Region.Publish(SharedRegion::SlotResult, Path.GetPathWeight(), Result->PrioritiesBest.data(), Path.GetVertexIndexes().data(), Path.GetVertexIndexes().size(), true);
+		}
+
+		Worker.SteadyStateIterations = Result->SteadyStateIterations;
+		Worker.SteadyStateAllocations = Result->SteadyStateAllocations;
+		Worker.MigrationsAccepted = Result->MigrationsAccepted;
+		Worker.Stopped = Result->Stopped ? 1 : 0;
+		Worker.Counters = Result->Counters;
+		Worker.State.store((uint32_t) SharedRegion::WorkerState_t::Done, std::memory_order_release);
+	}
+	catch(...)
+	{
+		Worker.State.store((uint32_t) SharedRegion::WorkerState_t::Failed, std::memory_order_release);
+		throw;
+	}
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Task.hpp"
+#include "Solver.hpp"
+#include "ParticleGroupRunner.hpp"
+#include "StopToken.hpp"
+
+/*
+	Klasa odpowiedzialna za uruchamianie jednego zapytania w kilku procesach roboczych - skalowanie poza jeden proces, izolacja awarii, przypisanie procesów do gniazd procesora
+
+	Run tworzy obszar pamięci współdzielonej (SharedRegion) z opisem zapytania i uruchamia WorkerNumber procesów roboczych: program WorkerExecutable z argumentami
+	WorkerArgument <nazwa obszaru>, które program przekazuje do WorkerMain. Zamiast tego procesy mogą dołączyć same (RunWorker) - np. uruchomione przez numactl na wybranym węźle.
+	Procesy można przypisać do gniazd (SetWorkerCpus) - proces roboczy ogranicza się do procesorów swojego miejsca, a wątki jego puli przypięte są do kolejnych z nich.
+	Każdy proces mapuje ten sam plik grafu (Graph::Load - strony pamięci podręcznej pliku są wspólne) i rozwiązuje zadanie własnym ParticleGroupRunner na własnej puli wątków.
+
+	Procesy wymieniają rozwiązania przez wątek pośredniczący, co BridgeIntervalMilliseconds:
+		- najlepsze rozwiązanie: lokalne GlobalBest <-> SharedRegion::SlotBest - grupy wszystkich procesów przyciągane są do najlepszego rozwiązania (wariant asynchroniczny)
+		- migracja: procesy tworzą pierścień - migranci wysyłani przez ParticleGroupRunner::SetProcessMigration trafiają do skrzynki następnego procesu
+	Awaria procesu nie przerywa pozostałych - wynik pochodzi z procesów, które zakończyły pracę (RunResult_t::WorkersFailed).
+
+	Tylko Linux (POSIX shm, posix_spawn). Zadania z kilkoma celami nie są obsługiwane.
+*/
+class ProcessRunner
+{
+	public:
+		// Pierwszy argument procesu roboczego
+		static const char * const WorkerArgument;
+
+		// Okres wymiany rozwiązań pomiędzy procesem a obszarem współdzielonym i sprawdzania stanu procesów
+		static const unsigned BridgeIntervalMilliseconds = 1;
+
+	public:
+		/*
+			Konstruktor.
+
+			T - Zadanie optymalizacji. Graf zadania musi pochodzić z pliku GraphFilePath
+			GraphFilePath - plik grafu (Graph::Write), mapowany przez każdy proces roboczy
+
+			WorkerNumber - liczba procesów roboczych
+			ThreadNumber - liczba wątków puli każdego procesu. 0 - hardware concurrency lub, przy przypisanych procesorach (SetWorkerCpus), po jednym na procesor
+			Parameters - parametry roju każdego procesu, opisane w ParticleGroupRunner.hpp. GlobalBestAsync jest ignorowane - procesy zawsze dzielą najlepsze rozwiązanie
+		*/
+		ProcessRunner(const Task & T, const std::string & GraphFilePath, const size_t & WorkerNumber, const size_t & ThreadNumber, const Solver::Parameters_t & Parameters);
+
+	private:
+		const Task & T;
+		const std::string GraphFilePath;
+
+		const size_t WorkerNumber;
+		const size_t ThreadNumber;
+		const Solver::Parameters_t Parameters;
+
+		/*
+			Nazwa obszaru pamięci współdzielonej - ustalana w konstruktorze, żeby procesy dołączające mogły ją poznać przed Run()
+		*/
+		const std::string RegionName;
+
+		/*
+			Program uruchamiany jako proces roboczy (SetWorkerExecutable), domyślnie bieżący program
+		*/
+		std::string WorkerExecutable;
+
+		/*
+			Ziarno roju (SetRandomSeed), domyślnie ParticleGroupRunner::RandomSeedDefault
+		*/
+		uint32_t RandomSeed;
+
+		/*
+			Procesory procesów roboczych (SetWorkerCpus), domyślnie puste - bez przypinania
+		*/
+		std::vector<std::vector<size_t>> WorkerCpus;
+
+	public:
+		const std::string & GetRegionName() const;
+
+		/*
+			Program uruchamiany jako proces roboczy. Pusty - Run() nie uruchamia procesów, tylko czeka na WorkerNumber procesów dołączających przez RunWorker(GetRegionName())
+		*/
+		void SetWorkerExecutable(const std::string & Path);
+
+		/*
+			Ziarno roju. Proces roboczy WorkerId dostaje ziarno RandomSeed + WorkerId (ParticleGroupRunner::SetRandomSeed) - każdy przeszukuje inną część przestrzeni
+		*/
+		void SetRandomSeed(const uint32_t & Seed);
+
+		/*
+			Procesory procesów roboczych - proces WorkerId dostaje Cpus[WorkerId % Cpus.size()], np. procesory kolejnych węzłów z NumaPlacement::DetectTopology().
+			Dotyczy procesów uruchamianych i dołączających. Pusta lista - bez przypinania.
+			Więcej niż SharedRegion::WorkerCpusNumberMax procesów lub procesor >= SharedRegion::CpuNumberMax - std::invalid_argument
+		*/
+		void SetWorkerCpus(const std::vector<std::vector<size_t>> & Cpus);
+
+	public:
+		struct RunResult_t
+		{
+			// Wynik wszystkich procesów - jak ParticleGroupRunner::Run, liczniki zsumowane z procesów, które zakończyły pracę
+			ParticleGroupRunner::RunResult_t Swarm;
+
+			// Liczba procesów, które zakończyły pracę, i tych, które uległy awarii lub nie dołączyły
+			size_t WorkersDone;
+			size_t WorkersFailed;
+		};
+
+		/*
+			Uruchamia procesy i czeka na ich zakończenie. Stop - żądanie przerwania i kryteria zakończenia, przekazywane wszystkim procesom.
+			Procesy dołączające (pusty WorkerExecutable), które nie dołączyły przed przerwaniem, liczone są jako WorkersFailed
+		*/
+		RunResult_t Run(StopToken & Stop);
+
+	public:
+		/*
+			Czy argumenty programu opisują proces roboczy (WorkerArgument <nazwa obszaru>)
+		*/
+		static bool IsWorkerCommandLine(const int & argc, char ** argv);
+
+		/*
+			Główna funkcja procesu roboczego - wywoływana z main() programu, gdy IsWorkerCommandLine. Zwraca kod wyjścia procesu
+		*/
+		static int WorkerMain(const int & argc, char ** argv);
+
+		/*
+			Dołącza do obszaru RegionName jako proces roboczy i rozwiązuje zapytanie. Błąd - wyjątek, a miejsce procesu oznaczone jest jako awaria
+		*/
+		static void RunWorker(const std::string & RegionName);
+};
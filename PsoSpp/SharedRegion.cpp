@@ -0,0 +1,377 @@
+#include "SharedRegion.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+
+#if !defined(_WIN32)
+	#include <cerrno>
+	#include <fcntl.h>
+	#include <signal.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace
+{
+	const char Magic[8] = { 'P', 's', 'o', 'S', 'p', 'p', 'S', '\0' };
+
+	// Wyrównanie części obszaru - linia pamięci podręcznej
+	const uint64_t Alignment = 64;
+
+	uint64_t Align(const uint64_t & Offset)
+	{
+		return (Offset + Alignment - 1) / Alignment * Alignment;
+	}
+
+	uint64_t GetWorkerSize()
+	{
+		return Align(sizeof(SharedRegion::Worker_t));
+	}
+
+	// Rozmiar jednej kopii danych slotu - priorytety i wierzchołki ścieżki, każde od granicy Alignment
+	uint64_t GetSlotCopySize(const uint32_t & VertexNumber)
+	{
+		return Align(VertexNumber * sizeof(Particle::Priority_t)) + Align(VertexNumber * sizeof(Graph::VertexIndex_t));
+	}
+}
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<int32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free, "SharedRegion requires lock-free atomics - they must work between processes");
+static_assert(std::is_trivially_copyable<SharedRegion::Description_t>::value, "SharedRegion::Description_t must be trivially copyable");
+
+const size_t SharedRegion::SlotBest;
+const size_t SharedRegion::SlotResult;
+
+size_t SharedRegion::SlotMigration(const size_t & WorkerId)
+{
+	return 2 + WorkerId;
+}
+
+SharedRegion::SharedRegion(const std::string & Name, const Description_t & Description):
+	Name(Name), Owner(true), Data(nullptr), Size(0)
+{
+	if(Description.WorkerNumber == 0 || Description.VertexNumber == 0)
+		throw std::invalid_argument("Description.WorkerNumber == 0 || Description.VertexNumber == 0");
+
+	const uint64_t WorkersOffset = Align(sizeof(Header_t));
+	const uint64_t SlotsOffset = WorkersOffset + Description.WorkerNumber * GetWorkerSize();
+	const uint64_t SlotSize = Align(sizeof(SlotHeader_t)) + 2 * GetSlotCopySize(Description.VertexNumber);
+	const uint64_t SlotNumber = SlotMigration(Description.WorkerNumber);
+	Size = (size_t) (SlotsOffset + SlotNumber * SlotSize);
+
+#if defined(_WIN32)
+	throw std::runtime_error("Shared memory regions are not supported on Windows: " + Name);
+#else
+	const int FileDescriptor = shm_open(Name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+	if(FileDescriptor < 0)
+		throw std::runtime_error("Cannot create shared memory region: " + Name);
+
+	// Nowy obszar jest wypełniony zerami - liczniki i stany startują od 0
+	if(ftruncate(FileDescriptor, (off_t) Size) != 0)
+	{
+		close(FileDescriptor);
+		shm_unlink(Name.c_str());
+		throw std::runtime_error("Cannot resize shared memory region: " + Name);
+	}
+
+	void * Mapping = mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_SHARED, FileDescriptor, 0);
+	close(FileDescriptor);
+	if(Mapping == MAP_FAILED)
+	{
+		shm_unlink(Name.c_str());
+		throw std::runtime_error("Cannot map shared memory region: " + Name);
+	}
+
+	Data = static_cast<uint8_t *>(Mapping);
+#endif
+
+	Header_t & Header = *reinterpret_cast<Header_t *>(Data);
+	Header.Version = Version;
+	Header.Size = Size;
+#if !defined(_WIN32)
+	Header.OwnerProcessId = (int32_t) getpid();
+#endif
+	Header.Description = Description;
+	Header.Description.GraphFilePath[GraphFilePathSizeMax - 1] = '\0';
+	Header.WorkersOffset = WorkersOffset;
+	Header.SlotsOffset = SlotsOffset;
+	Header.SlotSize = SlotSize;
+	Header.SlotNumber = SlotNumber;
+
+	for(size_t SlotId = 0; SlotId < SlotNumber; SlotId++)
+		GetSlotHeader(SlotId).PathWeight.store(std::numeric_limits<GraphPath::PathWeight_t>::max(), std::memory_order_relaxed);
+
+	// Znacznik na końcu - proces dołączający w trakcie tworzenia obszaru go nie zobaczy
+	std::atomic_thread_fence(std::memory_order_release);
+	std::memcpy(Header.Magic, Magic, sizeof(Magic));
+}
+
+SharedRegion::SharedRegion(const std::string & Name):
+	Name(Name), Owner(false), Data(nullptr), Size(0)
+{
+#if defined(_WIN32)
+	throw std::runtime_error("Shared memory regions are not supported on Windows: " + Name);
+#else
+	const int FileDescriptor = shm_open(Name.c_str(), O_RDWR, 0);
+	if(FileDescriptor < 0)
+		throw std::runtime_error("Cannot open shared memory region: " + Name);
+
+	struct stat FileStat;
+	if(fstat(FileDescriptor, &FileStat) != 0 || (size_t) FileStat.st_size < sizeof(Header_t))
+	{
+		close(FileDescriptor);
+		throw std::runtime_error("Shared memory region too small: " + Name);
+	}
+	Size = (size_t) FileStat.st_size;
+
+	void * Mapping = mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_SHARED, FileDescriptor, 0);
+	close(FileDescriptor);
+	if(Mapping == MAP_FAILED)
+		throw std::runtime_error("Cannot map shared memory region: " + Name);
+
+	Data = static_cast<uint8_t *>(Mapping);
+#endif
+
+	const Header_t & Header = GetHeader();
+	if(std::memcmp(Header.Magic, Magic, sizeof(Magic)) != 0 || Header.Version != Version || Header.Size != Size)
+	{
+		Unmap();
+		throw std::runtime_error("Not a shared memory region of this build (or not initialized yet): " + Name);
+	}
+	std::atomic_thread_fence(std::memory_order_acquire);
+}
+
+SharedRegion::~SharedRegion()
+{
+	Unmap();
+
+#if !defined(_WIN32)
+	if(Owner)
+		shm_unlink(Name.c_str());
+#endif
+}
+
+void SharedRegion::Unmap()
+{
+	if(Data == nullptr)
+		return;
+
+#if !defined(_WIN32)
+	munmap(Data, Size);
+#endif
+
+	Data = nullptr;
+}
+
+SharedRegion::SlotHeader_t & SharedRegion::GetSlotHeader(const size_t & SlotId) const
+{
+	return *reinterpret_cast<SlotHeader_t *>(Data + GetHeader().SlotsOffset + SlotId * GetHeader().SlotSize);
+}
+
+Particle::Priority_t * SharedRegion::GetSlotPriorities(const size_t & SlotId, const uint32_t & CopyId) const
+{
+	const uint8_t * Slot = reinterpret_cast<const uint8_t *>(&GetSlotHeader(SlotId));
+	return reinterpret_cast<Particle::Priority_t *>(const_cast<uint8_t *>(Slot) + Align(sizeof(SlotHeader_t)) + CopyId * GetSlotCopySize(GetDescription().VertexNumber));
+}
+
+Graph::VertexIndex_t * SharedRegion::GetSlotVertexIndexes(const size_t & SlotId, const uint32_t & CopyId) const
+{
+	const uint8_t * Priorities = reinterpret_cast<const uint8_t *>(GetSlotPriorities(SlotId, CopyId));
+	return reinterpret_cast<Graph::VertexIndex_t *>(const_cast<uint8_t *>(Priorities) + Align(GetDescription().VertexNumber * sizeof(Particle::Priority_t)));
+}
+
+const std::string & SharedRegion::GetName() const
+{
+	return Name;
+}
+
+const SharedRegion::Header_t & SharedRegion::GetHeader() const
+{
+	return *reinterpret_cast<const Header_t *>(Data);
+}
+
+const SharedRegion::Description_t & SharedRegion::GetDescription() const
+{
+	return GetHeader().Description;
+}
+
+SharedRegion::Worker_t & SharedRegion::GetWorker(const size_t & WorkerId) const
+{
+	return *reinterpret_cast<Worker_t *>(Data + GetHeader().WorkersOffset + WorkerId * GetWorkerSize());
+}
+
+std::vector<size_t> SharedRegion::GetWorkerCpus(const size_t & WorkerId) const
+{
+	std::vector<size_t> Cpus;
+	if(WorkerId >= WorkerCpusNumberMax)
+		return Cpus;
+
+	for(size_t Cpu = 0; Cpu < CpuNumberMax; Cpu++)
+		if(GetDescription().WorkerCpus[WorkerId][Cpu / 64] & ((uint64_t) 1 << (Cpu % 64)))
+			Cpus.push_back(Cpu);
+
+	return Cpus;
+}
+
+void SharedRegion::RequestStop()
+{
+	reinterpret_cast<Header_t *>(Data)->StopRequested.store(1, std::memory_order_relaxed);
+}
+
+bool SharedRegion::IsStopRequested() const
+{
+	return GetHeader().StopRequested.load(std::memory_order_relaxed) != 0;
+}
+
+size_t SharedRegion::AttachWorker()
+{
+	for(size_t WorkerId = 0; WorkerId < GetDescription().WorkerNumber; WorkerId++)
+	{
+		Worker_t & Worker = GetWorker(WorkerId);
+
+		uint32_t State = (uint32_t) WorkerState_t::Free;
+		if(!Worker.State.compare_exchange_strong(State, (uint32_t) WorkerState_t::Attached))
+			continue;
+
+	#if !defined(_WIN32)
+		Worker.ProcessId.store((int32_t) getpid());
+	#endif
+		return WorkerId;
+	}
+
+	throw std::runtime_error("No free worker place in shared memory region: " + Name);
+}
+
+GraphPath::PathWeight_t SharedRegion::GetPathWeight(const size_t & SlotId) const
+{
+	return GetSlotHeader(SlotId).PathWeight.load(std::memory_order_relaxed);
+}
+
+bool SharedRegion::Publish(const size_t & SlotId, const GraphPath::PathWeight_t & PathWeight, const Particle::Priority_t * Priorities, const Graph::VertexIndex_t * VertexIndexes, const size_t & PathLength, const bool & OnlyBetter)
+{
+	const uint32_t VertexNumber = GetDescription().VertexNumber;
+	if(PathLength > VertexNumber)
+		throw std::invalid_argument("PathLength > VertexNumber");
+
+	SlotHeader_t & Slot = GetSlotHeader(SlotId);
+
+	// Szybkie odrzucenie bez blokady
+	if(OnlyBetter && PathWeight >= Slot.PathWeight.load(std::memory_order_relaxed))
+		return false;
+
+#if defined(_WIN32)
+	const int32_t ProcessId = 1;
+#else
+	const int32_t ProcessId = (int32_t) getpid();
+#endif
+
+	// Blokada pisarzy - blokadę procesu, który przestał istnieć, przejmujemy (jego zapis mógł dotyczyć tylko nieaktywnej kopii)
+	int32_t WriterProcessId = 0;
+	while(!Slot.WriterProcessId.compare_exchange_weak(WriterProcessId, ProcessId, std::memory_order_acquire))
+	{
+		if(WriterProcessId != 0 && !IsProcessAlive(WriterProcessId))
+			continue;
+
+		WriterProcessId = 0;
+		std::this_thread::yield();
+	}
+
+	// Inny pisarz mógł w międzyczasie opublikować lepsze rozwiązanie
+	if(OnlyBetter && PathWeight >= Slot.PathWeight.load(std::memory_order_relaxed))
+	{
+		Slot.WriterProcessId.store(0, std::memory_order_release);
+		return false;
+	}
+
+	// Zapis do nieaktywnej kopii. Nieparzysty licznik zostaje nieparzysty - zapis przerwany przez poprzedniego pisarza
+	const uint32_t CopyId = 1 - Slot.Active.load(std::memory_order_relaxed);
+	SlotCopy_t & Copy = Slot.Copies[CopyId];
+	const uint64_t Sequence = Copy.Sequence.load(std::memory_order_relaxed) | 1;
+
+	Copy.Sequence.store(Sequence, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	std::memcpy(GetSlotPriorities(SlotId, CopyId), Priorities, VertexNumber * sizeof(Particle::Priority_t));
+	if(PathLength)
+		std::memcpy(GetSlotVertexIndexes(SlotId, CopyId), VertexIndexes, PathLength * sizeof(Graph::VertexIndex_t));
+	Copy.PathWeight = PathWeight;
+	Copy.PathLength = PathLength;
+
+	Copy.Sequence.store(Sequence + 1, std::memory_order_release);
+
+	Slot.Active.store(CopyId, std::memory_order_release);
+	Slot.PathWeight.store(PathWeight, std::memory_order_relaxed);
+	Slot.Generation.fetch_add(1, std::memory_order_release);
+
+	Slot.WriterProcessId.store(0, std::memory_order_release);
+	return true;
+}
+
+bool SharedRegion::Read(const size_t & SlotId, uint64_t & GenerationSeen, GraphPath::PathWeight_t & PathWeight, Particle::Priority_t * Priorities, GraphPath::VertexIndexes_t & VertexIndexes) const
+{
+	const uint32_t VertexNumber = GetDescription().VertexNumber;
+	const SlotHeader_t & Slot = GetSlotHeader(SlotId);
+
+	while(true)
+	{
+		const uint64_t Generation = Slot.Generation.load(std::memory_order_acquire);
+		if(Generation == GenerationSeen)
+			return false;
+
+		const uint32_t CopyId = Slot.Active.load(std::memory_order_acquire);
+		const SlotCopy_t & Copy = Slot.Copies[CopyId];
+
+		const uint64_t Sequence = Copy.Sequence.load(std::memory_order_acquire);
+		if(Sequence & 1)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		// Długość z kopii nadpisywanej w trakcie odczytu może być dowolna - odczyt i tak zostanie powtórzony
+		const GraphPath::PathWeight_t CopyPathWeight = Copy.PathWeight;
+		const size_t PathLength = (size_t) std::min<uint64_t>(Copy.PathLength, VertexNumber);
+
+		std::memcpy(Priorities, GetSlotPriorities(SlotId, CopyId), VertexNumber * sizeof(Particle::Priority_t));
+		const Graph::VertexIndex_t * CopyVertexIndexes = GetSlotVertexIndexes(SlotId, CopyId);
+		VertexIndexes.assign(CopyVertexIndexes, CopyVertexIndexes + PathLength);
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if(Copy.Sequence.load(std::memory_order_relaxed) != Sequence)
+			continue;
+
+		GenerationSeen = Generation;
+		PathWeight = CopyPathWeight;
+		return true;
+	}
+}
+
+void SharedRegion::SetWorkerCpus(Description_t & Description, const size_t & WorkerId, const std::vector<size_t> & Cpus)
+{
+	if(WorkerId >= WorkerCpusNumberMax)
+		throw std::invalid_argument("WorkerId >= WorkerCpusNumberMax");
+
+	std::fill(std::begin(Description.WorkerCpus[WorkerId]), std::end(Description.WorkerCpus[WorkerId]), 0);
+	for(const size_t & Cpu : Cpus)
+	{
+		if(Cpu >= CpuNumberMax)
+			throw std::invalid_argument("Cpu >= CpuNumberMax");
+
+		Description.WorkerCpus[WorkerId][Cpu / 64] |= (uint64_t) 1 << (Cpu % 64);
+	}
+}
+
+bool SharedRegion::IsProcessAlive(const int32_t & ProcessId)
+{
+#if defined(_WIN32)
+	(void) ProcessId;
+	return true;
+#else
+	// Sygnał 0 - tylko sprawdzenie istnienia. EPERM - proces istnieje, ale należy do innego użytkownika
+	return kill(ProcessId, 0) == 0 || errno != ESRCH;
+#endif
+}
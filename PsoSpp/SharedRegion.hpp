@@ -0,0 +1,225 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Graph.hpp"
+#include "GraphPath.hpp"
+#include "Particle.hpp"
+#include "Solver.hpp"
+#include "PerformanceCounters.hpp"
+
+/*
+	Obszar pamięci współdzielonej (POSIX shm) jednego zapytania rozwiązywanego przez kilka procesów (ProcessRunner).
+
+	Układ obszaru:
+		- nagłówek Header_t - opis zapytania (plik grafu, zadanie, parametry roju, kryteria zakończenia) i flaga przerwania
+		- Workers - stan i wynik każdego procesu roboczego (Worker_t)
+		- sloty rozwiązań (priorytety i ścieżka): SlotBest - najlepsze rozwiązanie wszystkich procesów w trakcie obliczeń,
+		  SlotResult - najlepszy wynik końcowy procesu, SlotMigration(I) - skrzynka migracji procesu I
+
+	Slot ma dwie kopie danych. Pisarz wypełnia nieaktywną kopię i przełącza na nią Active, więc proces przerwany w trakcie zapisu nie psuje opublikowanego rozwiązania.
+	Czytelnik nie blokuje - sprawdza licznik sekwencji kopii przed i po odczycie (seqlock) i powtarza odczyt, jeśli kopia zmieniła się w międzyczasie.
+	Pisarze slotu wykluczają się przez numer procesu w WriterProcessId - blokadę procesu, który przestał istnieć, przejmuje następny pisarz.
+
+	Wszystkie liczby zapisane są w natywnym porządku bajtów - obszar dzielą tylko procesy jednej maszyny, zbudowane z tych samych źródeł (Version).
+*/
+class SharedRegion
+{
+	public:
+		// Wersja układu obszaru - zmiana układu wymaga jej podbicia
+		static const uint32_t Version = 3;
+
+		// Maksymalna długość ścieżki pliku grafu (razem z kończącym zerem)
+		static const size_t GraphFilePathSizeMax = 1024;
+
+		// Liczba procesów roboczych, którym można przypisać procesory, i górna granica numeru procesora (Description_t::WorkerCpus)
+		static const size_t WorkerCpusNumberMax = 64;
+		static const size_t CpuNumberMax = 1024;
+
+		// Numery slotów
+		static const size_t SlotBest = 0;
+		static const size_t SlotResult = 1;
+		static size_t SlotMigration(const size_t & WorkerId);
+
+		/*
+			Opis zapytania - ustalany przez właściciela obszaru, tylko do odczytu dla procesów roboczych
+		*/
+		struct Description_t
+		{
+			char GraphFilePath[GraphFilePathSizeMax];
+			uint32_t VertexNumber;
+			Graph::VertexIndex_t VertexIndexStart;
+			Graph::VertexIndex_t VertexIndexEnd;
+
+			uint32_t WorkerNumber;
+			uint32_t ThreadNumber; /* wątków puli każdego procesu, 0 - hardware concurrency */
+
+			// Ziarno roju (ProcessRunner::SetRandomSeed) - proces WorkerId używa RandomSeed + WorkerId
+			uint32_t RandomSeed;
+
+			// Parametry roju każdego procesu
+			Solver::Parameters_t Parameters;
+
+			// StopToken::Criteria_t. Deadline w nanosekundach std::chrono::steady_clock (zegar wspólny dla procesów maszyny), INT64_MAX - bez limitu
+			int64_t DeadlineNanoseconds;
+			GraphPath::PathWeight_t PathWeightTarget;
+			uint64_t StagnationIterationsMax;
+
+			// Procesory procesu WorkerId (< WorkerCpusNumberMax) - maska bitowa, bit Cpu % 64 słowa Cpu / 64 (SetWorkerCpus). Pusta - proces bez przypinania
+			uint64_t WorkerCpus[WorkerCpusNumberMax][CpuNumberMax / 64];
+		};
+
+		enum class WorkerState_t : uint32_t
+		{
+			Free, // nikt nie zajął miejsca
+			Attached, // proces roboczy pracuje
+			Done, // zakończony, wynik w Worker_t i SlotResult
+			Failed, // proces zgłosił błąd lub przestał istnieć
+		};
+
+		struct Worker_t
+		{
+			std::atomic<uint32_t> State; /* WorkerState_t */
+			std::atomic<int32_t> ProcessId;
+
+			// Wynik procesu - ważny po State == Done
+			uint64_t SteadyStateIterations;
+			uint64_t SteadyStateAllocations;
+			uint64_t MigrationsAccepted;
+			uint32_t Stopped;
+			PerformanceCounters::Values_t Counters;
+		};
+
+		struct Header_t
+		{
+			char Magic[8]; /* "PsoSppS" */
+			uint32_t Version;
+			uint32_t Reserved;
+			uint64_t Size;
+
+			int32_t OwnerProcessId;
+			std::atomic<uint32_t> StopRequested;
+
+			Description_t Description;
+
+			// Położenie części obszaru (w bajtach od początku)
+			uint64_t WorkersOffset;
+			uint64_t SlotsOffset;
+			uint64_t SlotSize;
+			uint64_t SlotNumber;
+		};
+
+	private:
+		/*
+			Kopia danych slotu. Sequence nieparzyste - zapis w toku
+		*/
+		struct SlotCopy_t
+		{
+			std::atomic<uint64_t> Sequence;
+			uint64_t PathWeight;
+			uint64_t PathLength;
+		};
+
+		/*
+			Nagłówek slotu, za nim dane obu kopii: priorytety (VertexNumber wpisów), wierzchołki ścieżki (do VertexNumber wpisów)
+		*/
+		struct SlotHeader_t
+		{
+			std::atomic<int32_t> WriterProcessId; /* 0 - wolny */
+			std::atomic<uint32_t> Active;
+
+			// Liczba publikacji - czytelnik rozpoznaje po niej nowe rozwiązanie
+			std::atomic<uint64_t> Generation;
+
+			// Waga aktywnej kopii. std::numeric_limits<GraphPath::PathWeight_t>::max() - brak rozwiązania
+			std::atomic<uint64_t> PathWeight;
+
+			SlotCopy_t Copies[2];
+		};
+
+	public:
+		/*
+			Tworzy obszar o nazwie Name (np. "/PsoSpp.1234.0") dla zapytania Description. Obszar o tej nazwie nie może istnieć.
+			Obiekt jest właścicielem obszaru - destruktor usuwa nazwę (procesy, które go zmapowały, zachowują mapowanie)
+		*/
+		SharedRegion(const std::string & Name, const Description_t & Description);
+
+		/*
+			Dołącza do istniejącego obszaru Name i sprawdza jego nagłówek
+		*/
+		SharedRegion(const std::string & Name);
+
+		SharedRegion(const SharedRegion &) = delete;
+		SharedRegion & operator=(const SharedRegion &) = delete;
+		~SharedRegion();
+
+	private:
+		const std::string Name;
+		const bool Owner;
+
+		uint8_t * Data;
+		size_t Size;
+
+		void Unmap();
+
+		SlotHeader_t & GetSlotHeader(const size_t & SlotId) const;
+		Particle::Priority_t * GetSlotPriorities(const size_t & SlotId, const uint32_t & CopyId) const;
+		Graph::VertexIndex_t * GetSlotVertexIndexes(const size_t & SlotId, const uint32_t & CopyId) const;
+
+	public:
+		const std::string & GetName() const;
+		const Header_t & GetHeader() const;
+		const Description_t & GetDescription() const;
+		Worker_t & GetWorker(const size_t & WorkerId) const;
+
+		/*
+			Procesory przypisane procesowi roboczemu WorkerId (Description_t::WorkerCpus). Pusta lista - proces bez przypinania
+		*/
+		std::vector<size_t> GetWorkerCpus(const size_t & WorkerId) const;
+
+	public:
+		/*
+			Flaga przerwania wszystkich procesów roboczych
+		*/
+		void RequestStop();
+		bool IsStopRequested() const;
+
+		/*
+			Zajmuje pierwsze wolne miejsce procesu roboczego (stan Attached) i zwraca jego numer. Brak wolnego miejsca - std::runtime_error
+		*/
+		size_t AttachWorker();
+
+	public:
+		/*
+			Waga rozwiązania slotu. std::numeric_limits<GraphPath::PathWeight_t>::max() - brak rozwiązania
+		*/
+		GraphPath::PathWeight_t GetPathWeight(const size_t & SlotId) const;
+
+		/*
+			Publikuje rozwiązanie w slocie: priorytety (VertexNumber wpisów) i ścieżkę (PathLength wierzchołków, może być pusta).
+			OnlyBetter - publikacja tylko rozwiązania lepszego od bieżącego (zwraca false, jeśli nie jest lepsze). W przeciwnym razie rozwiązanie zastępuje bieżące (skrzynka migracji)
+		*/
+		bool Publish(const size_t & SlotId, const GraphPath::PathWeight_t & PathWeight, const Particle::Priority_t * Priorities, const Graph::VertexIndex_t * VertexIndexes, const size_t & PathLength, const bool & OnlyBetter);
+
+		/*
+			Odczytuje rozwiązanie slotu, jeśli opublikowano je po odczycie o numerze GenerationSeen (0 - przed pierwszym odczytem). Zwraca false, jeśli nie ma nowego rozwiązania
+
+			Priorities - bufor na VertexNumber wpisów
+			VertexIndexes - wierzchołki ścieżki (pusty, jeśli rozwiązanie opublikowano bez ścieżki)
+		*/
+		bool Read(const size_t & SlotId, uint64_t & GenerationSeen, GraphPath::PathWeight_t & PathWeight, Particle::Priority_t * Priorities, GraphPath::VertexIndexes_t & VertexIndexes) const;
+
+	public:
+		/*
+			Przypisuje procesowi roboczemu WorkerId procesory Cpus w opisie zapytania. WorkerId >= WorkerCpusNumberMax lub procesor >= CpuNumberMax - std::invalid_argument
+		*/
+		static void SetWorkerCpus(Description_t & Description, const size_t & WorkerId, const std::vector<size_t> & Cpus);
+
+		/*
+			Czy proces o numerze ProcessId nadal istnieje
+		*/
+		static bool IsProcessAlive(const int32_t & ProcessId);
+};
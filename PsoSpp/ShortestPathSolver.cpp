@@ -0,0 +1,172 @@
+#include "ShortestPathSolver.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+
+namespace
+{
+	// Wpis kolejki priorytetowej - (klucz, wierzchołek). Wpisy nieaktualne pomijane przy zdejmowaniu
+	typedef std::pair<GraphPath::PathWeight_t, Graph::VertexIndex_t> QueueEntry_t;
+	typedef std::priority_queue<QueueEntry_t, std::vector<QueueEntry_t>, std::greater<QueueEntry_t>> Queue_t;
+
+	const GraphPath::PathWeight_t DistanceInfinite = std::numeric_limits<GraphPath::PathWeight_t>::max();
+}
+
+ShortestPathSolver::ShortestPathSolver(const Graph & G):
+	G(G), EdgeWeightMin(std::numeric_limits<Graph::EdgeWeight_t>::max()), HopRadius(0)
+{
+	Graph::NeighborsBuffer_t NeighborsBuffer = G.CreateNeighborsBuffer();
+
+	for(Graph::VertexIndex_t VertexIndex = 0; VertexIndex < G.GetSize(); VertexIndex++)
+	{
+		const Graph::VertexId_t VertexX = (Graph::VertexId_t) (VertexIndex % G.GetSideSize());
+		const Graph::VertexId_t VertexY = (Graph::VertexId_t) (VertexIndex / G.GetSideSize());
+
+		const Graph::Neighbors_t Neighbors = G.GetNeighbors(VertexIndex, NeighborsBuffer);
+		for(size_t NeighborId = 0; NeighborId < Neighbors.Size; NeighborId++)
+		{
+			const Graph::VertexId_t NeighborX = (Graph::VertexId_t) (Neighbors.VertexIndexes[NeighborId] % G.GetSideSize());
+			const Graph::VertexId_t NeighborY = (Graph::VertexId_t) (Neighbors.VertexIndexes[NeighborId] / G.GetSideSize());
+
+			const Graph::VertexId_t DistanceX = VertexX > NeighborX ? VertexX - NeighborX : NeighborX - VertexX;
+			const Graph::VertexId_t DistanceY = VertexY > NeighborY ? VertexY - NeighborY : NeighborY - VertexY;
+
+			EdgeWeightMin = std::min(EdgeWeightMin, Neighbors.EdgeWeights[NeighborId]);
+			HopRadius = std::max(HopRadius, std::max(DistanceX, DistanceY));
+		}
+	}
+}
+
+const Graph::EdgeWeight_t & ShortestPathSolver::GetEdgeWeightMin() const
+{
+	return EdgeWeightMin;
+}
+
+const Graph::VertexId_t & ShortestPathSolver::GetHopRadius() const
+{
+	return HopRadius;
+}
+
+GraphPath::PathWeight_t ShortestPathSolver::GetHeuristic(const Graph::VertexIndex_t & VertexIndex, const Graph::VertexIndex_t & VertexIndexTarget) const
+{
+	// Graf bez krawędzi
+	if(HopRadius == 0)
+		return 0;
+
+	const Graph::VertexId_t Distance = GetGridDistance(G, VertexIndex, VertexIndexTarget);
+
+	// Co najmniej ceil(Distance / HopRadius) krawędzi
+	return (GraphPath::PathWeight_t) EdgeWeightMin * ((Distance + HopRadius - 1) / HopRadius);
+}
+
+ShortestPathSolver::Result_t ShortestPathSolver::Solve(const Task & T, const bool & Heuristic) const
+{
+	const Graph::VertexIndex_t VertexIndexStart = T.GetVertexIndexStart();
+	const Graph::VertexIndex_t VertexIndexEnd = T.GetVertexIndexEnd();
+
+	// Odległości od początku i poprzednicy na najkrótszych ścieżkach
+	std::vector<GraphPath::PathWeight_t> Distances(G.GetSize(), DistanceInfinite);
+	std::vector<Graph::VertexIndex_t> Predecessors(G.GetSize(), G.GetSize());
+	std::vector<bool> Settled(G.GetSize(), false);
+
+	Graph::NeighborsBuffer_t NeighborsBuffer = G.CreateNeighborsBuffer();
+
+	// Kluczem jest odległość + heurystyka (A*) lub sama odległość (Dijkstra)
+	Queue_t Queue;
+	Distances[VertexIndexStart] = 0;
+	Queue.push({ Heuristic ? GetHeuristic(VertexIndexStart, VertexIndexEnd) : 0, VertexIndexStart });
+
+	size_t VerticesSettled = 0;
+	while(!Queue.empty())
+	{
+		const Graph::VertexIndex_t VertexIndex = Queue.top().second;
+		Queue.pop();
+
+		// Wpis nieaktualny - wierzchołek zdjęty już wcześniej z mniejszym kluczem
+		if(Settled[VertexIndex])
+			continue;
+
+		Settled[VertexIndex] = true;
+		++VerticesSettled;
+
+		// Heurystyka jest spójna (spełnia nierówność trójkąta), więc zdjęty koniec ma ostateczną odległość
+		if(VertexIndex == VertexIndexEnd)
+			break;
+
+		const Graph::Neighbors_t Neighbors = G.GetNeighbors(VertexIndex, NeighborsBuffer);
+		for(size_t NeighborId = 0; NeighborId < Neighbors.Size; NeighborId++)
+		{
+			const Graph::VertexIndex_t NeighborVertexIndex = Neighbors.VertexIndexes[NeighborId];
+			const GraphPath::PathWeight_t Distance = Distances[VertexIndex] + Neighbors.EdgeWeights[NeighborId];
+
+			if(Settled[NeighborVertexIndex] || Distance >= Distances[NeighborVertexIndex])
+				continue;
+
+			Distances[NeighborVertexIndex] = Distance;
+			Predecessors[NeighborVertexIndex] = VertexIndex;
+			Queue.push({ Distance + (Heuristic ? GetHeuristic(NeighborVertexIndex, VertexIndexEnd) : 0), NeighborVertexIndex });
+		}
+	}
+
+	// Koniec nieosiągalny
+	if(Distances[VertexIndexEnd] == DistanceInfinite)
+		return { std::nullopt, VerticesSettled };
+
+	// Odtworzenie ścieżki od końca
+	GraphPath::VertexIndexes_t VertexIndexes;
+	for(Graph::VertexIndex_t VertexIndex = VertexIndexEnd; VertexIndex != G.GetSize(); VertexIndex = Predecessors[VertexIndex])
+		VertexIndexes.push_back(VertexIndex);
+	std::reverse(VertexIndexes.begin(), VertexIndexes.end());
+
+	return { GraphPath(G, std::move(VertexIndexes), Distances[VertexIndexEnd]), VerticesSettled };
+}
+
+std::vector<GraphPath::PathWeight_t> ShortestPathSolver::CalculateDistances(const Graph & G, const Graph::VertexIndex_t & VertexIndexSource)
+{
+	std::vector<GraphPath::PathWeight_t> Distances(G.GetSize(), DistanceInfinite);
+	std::vector<bool> Settled(G.GetSize(), false);
+
+	Graph::NeighborsBuffer_t NeighborsBuffer = G.CreateNeighborsBuffer();
+
+	Queue_t Queue;
+	Distances[VertexIndexSource] = 0;
+	Queue.push({ 0, VertexIndexSource });
+
+	while(!Queue.empty())
+	{
+		const Graph::VertexIndex_t VertexIndex = Queue.top().second;
+		Queue.pop();
+
+		if(Settled[VertexIndex])
+			continue;
+
+		Settled[VertexIndex] = true;
+
+		const Graph::Neighbors_t Neighbors = G.GetNeighbors(VertexIndex, NeighborsBuffer);
+		for(size_t NeighborId = 0; NeighborId < Neighbors.Size; NeighborId++)
+		{
+			const Graph::VertexIndex_t NeighborVertexIndex = Neighbors.VertexIndexes[NeighborId];
+			const GraphPath::PathWeight_t Distance = Distances[VertexIndex] + Neighbors.EdgeWeights[NeighborId];
+
+			if(!Settled[NeighborVertexIndex] && Distance < Distances[NeighborVertexIndex])
+			{
+				Distances[NeighborVertexIndex] = Distance;
+				Queue.push({ Distance, NeighborVertexIndex });
+			}
+		}
+	}
+
+	return Distances;
+}
+
+Graph::VertexId_t ShortestPathSolver::GetGridDistance(const Graph & G, const Graph::VertexIndex_t & Vertex1Index, const Graph::VertexIndex_t & Vertex2Index)
+{
+	const Graph::VertexId_t Vertex1X = (Graph::VertexId_t) (Vertex1Index % G.GetSideSize());
+	const Graph::VertexId_t Vertex1Y = (Graph::VertexId_t) (Vertex1Index / G.GetSideSize());
+	const Graph::VertexId_t Vertex2X = (Graph::VertexId_t) (Vertex2Index % G.GetSideSize());
+	const Graph::VertexId_t Vertex2Y = (Graph::VertexId_t) (Vertex2Index / G.GetSideSize());
+
+	return std::max(Vertex1X > Vertex2X ? Vertex1X - Vertex2X : Vertex2X - Vertex1X, Vertex1Y > Vertex2Y ? Vertex1Y - Vertex2Y : Vertex2Y - Vertex1Y);
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "Graph.hpp"
+#include "GraphPath.hpp"
+#include "Task.hpp"
+
+/*
+	Dokładny solver najkrótszej ścieżki - punkt odniesienia dla wyników roju.
+
+	Solve - algorytm A* z heurystyką opartą na położeniu wierzchołków w siatce (lub Dijkstra, bez heurystyki).
+	Krawędź łączy wierzchołki odległe o co najwyżej HopRadius w metryce Czebyszewa i waży co najmniej EdgeWeightMin,
+	więc do wierzchołka odległego o D potrzeba co najmniej ceil(D / HopRadius) krawędzi, czyli wagi EdgeWeightMin * ceil(D / HopRadius).
+	Heurystyka nigdy nie przeszacowuje - wynik jest optymalny.
+
+	Oba ograniczenia (EdgeWeightMin, HopRadius) wyznaczane są w konstruktorze, jednym przejściem po wszystkich krawędziach grafu.
+	CalculateDistances i GetGridDistance ich nie potrzebują, więc nie wymagają obiektu.
+*/
+class ShortestPathSolver
+{
+	public:
+		struct Result_t
+		{
+			// Najkrótsza ścieżka, brak - koniec nieosiągalny z początku
+			std::optional<GraphPath> Path;
+
+			// Liczba wierzchołków zdjętych z kolejki - miara pracy wykonanej przez heurystykę
+			size_t VerticesSettled;
+		};
+
+	public:
+		ShortestPathSolver(const Graph & G);
+
+	private:
+		const Graph & G;
+
+		/*
+			Najmniejsza waga krawędzi i największa odległość (Czebyszewa) pomiędzy końcami krawędzi
+		*/
+		Graph::EdgeWeight_t EdgeWeightMin;
+		Graph::VertexId_t HopRadius;
+
+	public:
+		const Graph::EdgeWeight_t & GetEdgeWeightMin() const;
+		const Graph::VertexId_t & GetHopRadius() const;
+
+		/*
+			Dolne ograniczenie wagi ścieżki pomiędzy wierzchołkami
+		*/
+		GraphPath::PathWeight_t GetHeuristic(const Graph::VertexIndex_t & VertexIndex, const Graph::VertexIndex_t & VertexIndexTarget) const;
+
+	public:
+		/*
+			Najkrótsza ścieżka zadania T
+
+			Heuristic - true: A*, false: Dijkstra
+		*/
+		Result_t Solve(const Task & T, const bool & Heuristic) const;
+
+		/*
+			Odległości wszystkich wierzchołków od VertexIndexSource (Dijkstra). Graf jest nieskierowany, więc to również odległości do VertexIndexSource.
+			Wierzchołki nieosiągalne - std::numeric_limits<GraphPath::PathWeight_t>::max()
+		*/
+		static std::vector<GraphPath::PathWeight_t> CalculateDistances(const Graph & G, const Graph::VertexIndex_t & VertexIndexSource);
+
+		/*
+			Odległość wierzchołków w siatce grafu (metryka Czebyszewa) - bez przechodzenia krawędzi, O(1)
+		*/
+		static Graph::VertexId_t GetGridDistance(const Graph & G, const Graph::VertexIndex_t & Vertex1Index, const Graph::VertexIndex_t & Vertex2Index);
+};
+
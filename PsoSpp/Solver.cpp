@@ -0,0 +1,99 @@
+#include "Solver.hpp"
+
+Solver::Solver(ThreadPool & Pool, const Parameters_t & Parameters):
+	Pool(Pool), Parameters(Parameters), QueriesActive(0)
+{
+
+}
+
+Solver::~Solver()
+{
+	// Zlecone zadania trzymają wskaźnik na Solver - nie może zniknąć przed nimi
+	std::unique_lock<std::mutex> Lock(QueriesMutex);
+	QueriesCondition.wait(Lock, [&] { return QueriesActive == 0; });
+}
+
+const Solver::Parameters_t & Solver::GetParameters() const
+{
+	return Parameters;
+}
+
+size_t Solver::GetQueriesActive()
+{
+	std::lock_guard<std::mutex> Lock(QueriesMutex);
+	return QueriesActive;
+}
+
+Solver::Query_t Solver::Submit(const Task & T)
+{
+	return Submit(T, StopToken::Criteria_t());
+}
+
+Solver::Query_t Solver::Submit(const Task & T, const StopToken::Criteria_t & Criteria)
+{
+	return Submit(T, Criteria, nullptr);
+}
+
+Solver::Query_t Solver::Submit(const Task & T, const StopToken::Criteria_t & Criteria, TraceWriter * Trace)
+{
+	// Stan zapytania współdzielony z zadaniem puli. std::function wymaga kopiowalnego obiektu, stąd std::shared_ptr na std::promise
+	std::shared_ptr<std::promise<ParticleGroupRunner::RunResult_t>> Promise = std::make_shared<std::promise<ParticleGroupRunner::RunResult_t>>();
+	std::shared_ptr<StopToken> Stop = std::make_shared<StopToken>(Criteria);
+	std::shared_ptr<PerformanceCounters> Counters = std::make_shared<PerformanceCounters>();
+
+	Query_t Query{ Promise->get_future(), Stop, Counters };
+
+	{
+		std::lock_guard<std::mutex> Lock(QueriesMutex);
+		++QueriesActive;
+	}
+
+	Pool.Post([this, T, Promise, Stop, Counters, Trace]()
+	{
+		try
+		{
+			// Zapytanie przerwane lub przeterminowane w kolejce - bez tworzenia grup
+			if(Stop->IsStopRequested() || Stop->IsDeadlineReached())
+			{
+				Promise->set_value({ std::nullopt, 0, 0, 0, true, PerformanceCounters::Values_t(), std::vector<std::optional<GraphPath>>(T.GetVertexIndexEnds().size()), std::vector<Particle::Priority_t>() });
+			}
+			else
+			{
+				ParticleGroupRunner PGR(
+					Pool,
+					T,
+					Parameters.ParticleGroupNumber,
+					Parameters.ParticleNumberTotal,
+					Parameters.ParticleIterations,
+					Parameters.ParticleBetterSolutionFoundNoCountMax,
+					Parameters.Fi1,
+					Parameters.Fi2,
+					Parameters.MigrationInterval,
+					Parameters.MigrationTopology,
+					Parameters.GlobalBestAsync,
+					Parameters.SeedFraction,
+					Parameters.LocalSearch
+				);
+				PGR.SetTrace(Trace);
+				Promise->set_value(PGR.Run(*Stop, *Counters));
+			}
+		}
+		catch(...)
+		{
+			// Wyjątek (np. brak pamięci) trafia do odbiorcy wyniku
+			Promise->set_exception(std::current_exception());
+		}
+
+		// Powiadomienie pod blokadą - destruktor Solver może zakończyć się zaraz po zwolnieniu blokady
+		std::lock_guard<std::mutex> Lock(QueriesMutex);
+		--QueriesActive;
+		QueriesCondition.notify_all();
+	});
+
+	return Query;
+}
+
+void Solver::Cancel(const Query_t & Query)
+{
+	Query.Stop->RequestStop();
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+
+#include "Task.hpp"
+#include "ParticleGroupRunner.hpp"
+#include "ThreadPool.hpp"
+#include "StopToken.hpp"
+#include "PerformanceCounters.hpp"
+#include "TraceWriter.hpp"
+
+/*
+	Długo żyjący silnik rozwiązujący strumień zapytań (Task) na trwałej puli wątków.
+
+	Submit zleca zapytanie na pulę i wraca natychmiast - wynik odbierany jest przez std::future.
+	Zapytania wykonywane są współbieżnie, po jednym na wolny wątek roboczy puli. Grupy cząstek zapytania korzystają z tej samej puli,
+	więc wątki bez własnego zapytania pomagają w już rozpoczętych. Nie powstają żadne nowe wątki.
+
+	Zadania przechowują referencję do grafu - graf musi żyć dłużej niż wszystkie zapytania, które go dotyczą.
+*/
+class Solver
+{
+	public:
+		/*
+			Parametry roju, wspólne dla wszystkich zapytań. Opisane w ParticleGroupRunner.hpp
+		*/
+		struct Parameters_t
+		{
+			size_t ParticleGroupNumber;
+			size_t ParticleNumberTotal;
+			size_t ParticleIterations;
+			size_t ParticleBetterSolutionFoundNoCountMax;
+			double Fi1;
+			double Fi2;
+			size_t MigrationInterval;
+			ParticleGroupRunner::MigrationTopology_t MigrationTopology;
+			bool GlobalBestAsync;
+			double SeedFraction;
+			PathLocalSearch::Mode_t LocalSearch;
+		};
+
+		/*
+			Zlecone zapytanie
+		*/
+		struct Query_t
+		{
+			// Wynik - gotowy po zakończeniu (lub przerwaniu) obliczeń
+			std::future<ParticleGroupRunner::RunResult_t> Result;
+
+			// Żądanie przerwania i kryteria zakończenia zapytania. Przerwane zapytanie zwraca najlepszy dotychczasowy wynik
+			std::shared_ptr<StopToken> Stop;
+
+			// Liczniki wydajności zapytania - aktualizowane po każdej iteracji grup, można je odczytywać w trakcie obliczeń
+			std::shared_ptr<PerformanceCounters> Counters;
+		};
+
+	public:
+		/*
+			Pool - pula, na której wykonywane są zapytania. Musi żyć dłużej niż Solver
+			Parameters - parametry roju
+		*/
+		Solver(ThreadPool & Pool, const Parameters_t & Parameters);
+		Solver(const Solver &) = delete;
+		Solver & operator=(const Solver &) = delete;
+
+		/*
+			Czeka na zakończenie wszystkich zleconych zapytań
+		*/
+		~Solver();
+
+	private:
+		ThreadPool & Pool;
+		const Parameters_t Parameters;
+
+		/*
+			Liczba zapytań zleconych i jeszcze niezakończonych
+		*/
+		std::mutex QueriesMutex;
+		std::condition_variable QueriesCondition;
+		size_t QueriesActive;
+
+	public:
+		const Parameters_t & GetParameters() const;
+		size_t GetQueriesActive();
+
+	public:
+		/*
+			Zleca zapytanie T i wraca natychmiast. Zadanie jest kopiowane
+		*/
+		Query_t Submit(const Task & T);
+
+		/*
+			Jak Submit(T), z kryteriami wcześniejszego zakończenia - np. dla zapytań z ograniczonym czasem odpowiedzi.
+			Czas Criteria.Deadline liczy się również w kolejce - zapytanie, które doczekało się wątku po terminie, kończy się bez obliczeń
+		*/
+		Query_t Submit(const Task & T, const StopToken::Criteria_t & Criteria);
+
+		/*
+			Jak Submit(T, Criteria), a poprawy najlepszych rozwiązań grup są na bieżąco zapisywane przez Trace (ParticleGroupRunner::SetTrace).
+			Trace musi żyć do odebrania wyniku zapytania
+		*/
+		Query_t Submit(const Task & T, const StopToken::Criteria_t & Criteria, TraceWriter * Trace);
+
+		/*
+			Przerywa zapytanie. Zapytanie jeszcze nierozpoczęte kończy się bez obliczeń i bez wyniku
+		*/
+		static void Cancel(const Query_t & Query);
+};
+
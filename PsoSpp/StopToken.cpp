@@ -0,0 +1,91 @@
+#include "StopToken.hpp"
+
+#include <limits>
+
+StopToken::StopToken():
+	StopToken(Criteria_t())
+{
+
+}
+
+StopToken::StopToken(const Criteria_t & Criteria):
+	Criteria(Criteria), StopRequested(false), PathWeightBest(std::numeric_limits<GraphPath::PathWeight_t>::max()), ImprovementNumber(0)
+{
+
+}
+
+const StopToken::Criteria_t & StopToken::GetCriteria() const
+{
+	return Criteria;
+}
+
+GraphPath::PathWeight_t StopToken::GetPathWeightBest() const
+{
+	return PathWeightBest.load(std::memory_order_relaxed);
+}
+
+void StopToken::RequestStop()
+{
+	StopRequested.store(true, std::memory_order_relaxed);
+}
+
+bool StopToken::IsStopRequested() const
+{
+	return StopRequested.load(std::memory_order_relaxed);
+}
+
+bool StopToken::IsDeadlineReached() const
+{
+	// Bez limitu - bez odczytu zegara
+	if(Criteria.Deadline == std::chrono::steady_clock::time_point::max())
+		return false;
+
+	return std::chrono::steady_clock::now() >= Criteria.Deadline;
+}
+
+bool StopToken::Check(Progress_t & Progress, const size_t & ParticleIteration)
+{
+	if(IsStopRequested())
+		return true;
+
+	if(IsDeadlineReached())
+	{
+		RequestStop();
+		return true;
+	}
+
+	if(Criteria.StagnationIterationsMax > 0)
+	{
+		// Poprawa od poprzedniego sprawdzenia - liczymy od nowa
+		const uint64_t ImprovementNumberCurrent = ImprovementNumber.load(std::memory_order_relaxed);
+		if(ImprovementNumberCurrent != Progress.ImprovementNumberSeen)
+		{
+			Progress.ImprovementNumberSeen = ImprovementNumberCurrent;
+			Progress.ParticleIterationImprovement = ParticleIteration;
+		}
+		else if(ParticleIteration - Progress.ParticleIterationImprovement >= Criteria.StagnationIterationsMax)
+		{
+			RequestStop();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void StopToken::ReportPathWeight(const GraphPath::PathWeight_t & PathWeight)
+{
+	// Atomowe minimum - inna grupa mogła w międzyczasie zgłosić lepszy wynik
+	GraphPath::PathWeight_t PathWeightBestCurrent = PathWeightBest.load(std::memory_order_relaxed);
+	while(PathWeight < PathWeightBestCurrent)
+	{
+		if(PathWeightBest.compare_exchange_weak(PathWeightBestCurrent, PathWeight, std::memory_order_relaxed))
+		{
+			ImprovementNumber.fetch_add(1, std::memory_order_relaxed);
+
+			if(PathWeight <= Criteria.PathWeightTarget)
+				RequestStop();
+			break;
+		}
+	}
+}
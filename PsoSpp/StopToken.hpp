@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+#include "GraphPath.hpp"
+
+/*
+	Żądanie przerwania obliczeń, współdzielone przez wszystkie wątki jednego zapytania.
+
+	Przerwanie zgłasza właściciel (np. Solver na prośbę użytkownika - RequestStop()) lub samo zapytanie po spełnieniu kryterium zakończenia (Criteria_t):
+		- przekroczenie czasu (Deadline)
+		- znalezienie wystarczająco dobrej ścieżki (PathWeightTarget)
+		- brak poprawy najlepszego wyniku wszystkich grup przez zadaną liczbę iteracji (StagnationIterationsMax)
+	Grupy cząstek sprawdzają kryteria przed każdą iteracją (Check), a poprawę swojego najlepszego rozwiązania zgłaszają przez ReportPathWeight.
+	Pierwsza grupa, która wykryje spełnienie kryterium, zgłasza przerwanie - pozostałe zobaczą je przed swoją następną iteracją.
+
+	Sprawdzenie to kilka odczytów atomowych (oraz odczyt zegara, jeśli ustawiono Deadline). Zapis do współdzielonych pól odbywa się tylko przy poprawie wyniku.
+*/
+class StopToken
+{
+	public:
+		struct Criteria_t
+		{
+			// Chwila, po której obliczenia są przerywane. time_point::max() - bez limitu czasu
+			std::chrono::steady_clock::time_point Deadline = std::chrono::steady_clock::time_point::max();
+
+			// Obliczenia są przerywane po znalezieniu ścieżki o wadze <= PathWeightTarget. 0 - bez celu
+			GraphPath::PathWeight_t PathWeightTarget = 0;
+
+			// Obliczenia są przerywane, gdy grupa wykona tyle iteracji od ostatniej poprawy najlepszego wyniku wszystkich grup. 0 - bez limitu
+			size_t StagnationIterationsMax = 0;
+		};
+
+		/*
+			Stan sprawdzania kryteriów jednej grupy cząstek
+		*/
+		struct Progress_t
+		{
+			// Liczba popraw najlepszego wyniku widziana przy poprzednim sprawdzeniu
+			uint64_t ImprovementNumberSeen = 0;
+
+			// Iteracja, w której grupa zauważyła ostatnią poprawę
+			size_t ParticleIterationImprovement = 0;
+		};
+
+	public:
+		StopToken();
+		StopToken(const Criteria_t & Criteria);
+		StopToken(const StopToken &) = delete;
+		StopToken & operator=(const StopToken &) = delete;
+
+	private:
+		const Criteria_t Criteria;
+
+		std::atomic<bool> StopRequested;
+
+		/*
+			Najlepsza waga zgłoszona przez wszystkie grupy i liczba jej popraw
+		*/
+		std::atomic<GraphPath::PathWeight_t> PathWeightBest;
+		std::atomic<uint64_t> ImprovementNumber;
+
+	public:
+		const Criteria_t & GetCriteria() const;
+
+		/*
+			Najlepsza zgłoszona waga ścieżki. std::numeric_limits<GraphPath::PathWeight_t>::max() - brak ścieżki
+		*/
+		GraphPath::PathWeight_t GetPathWeightBest() const;
+
+	public:
+		/*
+			Zgłasza żądanie przerwania. Bezpieczne z dowolnego wątku, wielokrotne wywołanie nie ma dodatkowych skutków
+		*/
+		void RequestStop();
+
+		bool IsStopRequested() const;
+		bool IsDeadlineReached() const;
+
+		/*
+			Sprawdzenie przed iteracją ParticleIteration grupy o stanie Progress. Zwraca true, jeśli grupa powinna zakończyć pracę
+		*/
+		bool Check(Progress_t & Progress, const size_t & ParticleIteration);
+
+		/*
+			Zgłasza nowe najlepsze rozwiązanie grupy. Bezpieczne z dowolnego wątku
+		*/
+		void ReportPathWeight(const GraphPath::PathWeight_t & PathWeight);
+};
+
@@ -0,0 +1,54 @@
+#include "SwarmMatrix.hpp"
+
+#include <algorithm>
+#include <new>
+
+SwarmMatrix::SwarmMatrix(const size_t & ParticleNumber, const Graph::VertexIndex_t & Size):
+	ParticleNumber(ParticleNumber),
+	Size(Size),
+	Stride((Size + Alignment / sizeof(Value_t) - 1) / (Alignment / sizeof(Value_t)) * (Alignment / sizeof(Value_t))),
+	Values(static_cast<Value_t *>(::operator new(3 * ParticleNumber * Stride * sizeof(Value_t), std::align_val_t(Alignment))))
+{
+	// Dopełnienie wierszy nigdy nie jest czytane, ale zerujemy cały blok - brak śmieci przy podglądzie / zrzucie pamięci
+	std::fill(Values.get(), Values.get() + 3 * ParticleNumber * Stride, 0.0);
+}
+
+void SwarmMatrix::AlignedDelete_t::operator()(Value_t * Values) const
+{
+	::operator delete(Values, std::align_val_t(Alignment));
+}
+
+const size_t & SwarmMatrix::GetParticleNumber() const
+{
+	return ParticleNumber;
+}
+
+const Graph::VertexIndex_t & SwarmMatrix::GetSize() const
+{
+	return Size;
+}
+
+const size_t & SwarmMatrix::GetStride() const
+{
+	return Stride;
+}
+
+size_t SwarmMatrix::GetFootprint() const
+{
+	return 3 * ParticleNumber * Stride * sizeof(Value_t);
+}
+
+SwarmMatrix::Value_t * SwarmMatrix::GetPriorities(const size_t & ParticleId) const
+{
+	return Values.get() + (0 * ParticleNumber + ParticleId) * Stride;
+}
+
+SwarmMatrix::Value_t * SwarmMatrix::GetVelocities(const size_t & ParticleId) const
+{
+	return Values.get() + (1 * ParticleNumber + ParticleId) * Stride;
+}
+
+SwarmMatrix::Value_t * SwarmMatrix::GetBestPriorities(const size_t & ParticleId) const
+{
+	return Values.get() + (2 * ParticleNumber + ParticleId) * Stride;
+}
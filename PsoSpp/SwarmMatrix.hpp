@@ -0,0 +1,62 @@
+#pragma once
+
+#include <memory>
+
+#include "Graph.hpp"
+
+/*
+	Stan całego roju cząstek w jednym, ciągłym i wyrównanym bloku pamięci.
+
+	Blok zawiera trzy macierze ParticleNumber x Stride (kolejno):
+		- Priorities - bieżące położenia cząstek
+		- Velocities - prędkości cząstek
+		- BestPriorities - położenia najlepszych lokalnych rozwiązań
+	Wiersz (cząstka) ma długość Stride >= Size, zaokrągloną do wielokrotności linii pamięci podręcznej, więc każdy wiersz zaczyna się na granicy Alignment.
+	Rozmiar bloku zależy wyłącznie od ParticleNumber i Size.
+*/
+class SwarmMatrix
+{
+	public:
+		typedef double Value_t;
+
+		// Wyrównanie wierszy (linia pamięci podręcznej, rejestr AVX-512)
+		static const size_t Alignment = 64;
+
+	public:
+		/*
+			ParticleNumber - liczba cząstek (wierszy)
+			Size - liczba węzłów grafu (kolumn)
+		*/
+		SwarmMatrix(const size_t & ParticleNumber, const Graph::VertexIndex_t & Size);
+
+	private:
+		struct AlignedDelete_t
+		{
+			void operator()(Value_t * Values) const;
+		};
+
+		const size_t ParticleNumber;
+		const Graph::VertexIndex_t Size;
+		const size_t Stride;
+
+		std::unique_ptr<Value_t[], AlignedDelete_t> Values; /* 3 * ParticleNumber * Stride */
+
+	public:
+		const size_t & GetParticleNumber() const;
+		const Graph::VertexIndex_t & GetSize() const;
+		const size_t & GetStride() const;
+
+		/*
+			Rozmiar bloku w bajtach
+		*/
+		size_t GetFootprint() const;
+
+	public:
+		/*
+			Wiersze poszczególnych macierzy dla cząstki ParticleId
+		*/
+		Value_t * GetPriorities(const size_t & ParticleId) const;
+		Value_t * GetVelocities(const size_t & ParticleId) const;
+		Value_t * GetBestPriorities(const size_t & ParticleId) const;
+};
+
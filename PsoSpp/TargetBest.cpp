@@ -0,0 +1,83 @@
+#include "TargetBest.hpp"
+
+#include <limits>
+
+#include "PathLocalSearch.hpp"
+
+TargetBest::TargetBest(const Task & T):
+	T(T),
+	Targets(T.GetVertexIndexEnds().size(), Target_t{ std::numeric_limits<GraphPath::PathWeight_t>::max(), GraphPath::VertexIndexes_t() })
+{
+
+}
+
+void TargetBest::SetLocalSearch(const bool & LocalSearch)
+{
+	LocalSearchScratch.reset(LocalSearch ? new DecodeScratch(T.GetGraph()) : nullptr);
+}
+
+bool TargetBest::Offer(const Task::TargetId_t & TargetId, const DecodeScratch & Scratch)
+{
+	Target_t & Target = Targets[TargetId];
+	if(!(Scratch.GetPathWeight() < Target.PathWeight))
+		return false;
+
+	// Przeszukiwanie lokalne kopii ścieżki - nie zwiększa wagi, więc ścieżka nadal poprawia wynik
+	const DecodeScratch * ScratchBest = &Scratch;
+	if(LocalSearchScratch)
+	{
+		LocalSearchScratch->Begin();
+		for(size_t Position = 0; Position < Scratch.GetVertexIndexes().size(); Position++)
+			LocalSearchScratch->Push(Scratch.GetVertexIndexes()[Position], Scratch.GetEdgeWeights()[Position]);
+
+		// Okrężna ścieżka ma wiele skrótów, a skrót dalej na ścieżce może otworzyć nowy wcześniej - do braku zmian
+		while(PathLocalSearch::Improve(T.GetGraph(), *LocalSearchScratch));
+		ScratchBest = LocalSearchScratch.get();
+	}
+
+	// Przypisanie wektora zachowuje jego pojemność
+	Target.PathWeight = ScratchBest->GetPathWeight();
+	Target.VertexIndexes = ScratchBest->GetVertexIndexes();
+	return true;
+}
+
+size_t TargetBest::Merge(const TargetBest & Other)
+{
+	size_t Improved = 0;
+	for(size_t TargetId = 0; TargetId < Targets.size(); TargetId++)
+	{
+		const Target_t & TargetOther = Other.Targets[TargetId];
+		if(!(TargetOther.PathWeight < Targets[TargetId].PathWeight))
+			continue;
+
+		Targets[TargetId].PathWeight = TargetOther.PathWeight;
+		Targets[TargetId].VertexIndexes = TargetOther.VertexIndexes;
+		++Improved;
+	}
+
+	return Improved;
+}
+
+size_t TargetBest::GetReachedNumber() const
+{
+	size_t ReachedNumber = 0;
+	for(const Target_t & Target : Targets)
+		if(Target.PathWeight != std::numeric_limits<GraphPath::PathWeight_t>::max())
+			++ReachedNumber;
+
+	return ReachedNumber;
+}
+
+const GraphPath::PathWeight_t & TargetBest::GetPathWeight(const Task::TargetId_t & TargetId) const
+{
+	return Targets[TargetId].PathWeight;
+}
+
+std::optional<GraphPath> TargetBest::GetGraphPath(const Task::TargetId_t & TargetId) const
+{
+	const Target_t & Target = Targets[TargetId];
+	if(Target.PathWeight == std::numeric_limits<GraphPath::PathWeight_t>::max())
+		return std::nullopt;
+
+	return GraphPath(T.GetGraph(), GraphPath::VertexIndexes_t(Target.VertexIndexes), Target.PathWeight);
+}
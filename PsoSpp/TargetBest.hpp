@@ -0,0 +1,84 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "Task.hpp"
+#include "GraphPath.hpp"
+#include "DecodeScratch.hpp"
+
+/*
+	Najlepsze znane ścieżki od początku zadania wielocelowego do każdego z jego celów.
+
+	Dekodowanie nie odwiedza wierzchołków ponownie, więc każdy cel pojawia się na ścieżce dekodowania co najwyżej raz,
+	a początek ścieżki aż do niego jest gotową ścieżką do tego celu - Offer zapisuje go, jeśli jest lżejszy od dotychczasowego.
+	Ścieżka kopiowana jest tylko przy poprawie, do bufora celu (alokacja tylko, gdy bufor jest za mały).
+
+	Ścieżka dekodowania prowadzi do pierwszego celu zadania, więc do pozostałych celów dochodzi zwykle okrężną drogą.
+	Z włączonym przeszukiwaniem lokalnym (SetLocalSearch) ścieżka, która poprawia wynik celu, jest przed zapisaniem skracana przez PathLocalSearch::Improve
+	we własnym buforze - bufor dekodowania, które zgłasza ścieżkę, pozostaje nienaruszony.
+
+	Każdy fragment grupy cząstek ma własny TargetBest (zapis bez synchronizacji), grupa po dekodowaniu scala do swojego fragmenty z poprawami (Merge),
+	a ParticleGroupRunner - wszystkie grupy do wyniku.
+*/
+class TargetBest
+{
+	public:
+		/*
+			T - zadanie, dla którego zbierane są ścieżki. Na początku brak ścieżki do każdego celu
+		*/
+		TargetBest(const Task & T);
+
+	private:
+		struct Target_t
+		{
+			// Waga najlepszej ścieżki. std::numeric_limits<GraphPath::PathWeight_t>::max() - brak ścieżki
+			GraphPath::PathWeight_t PathWeight;
+
+			GraphPath::VertexIndexes_t VertexIndexes;
+		};
+
+		const Task & T;
+
+		std::vector<Target_t> Targets; /* T.GetVertexIndexEnds().size() */
+
+		/*
+			Bufor przeszukiwania lokalnego zgłaszanych ścieżek. nullptr - przeszukiwanie wyłączone
+		*/
+		std::unique_ptr<DecodeScratch> LocalSearchScratch;
+
+	public:
+		/*
+			Włącza lub wyłącza przeszukiwanie lokalne zgłaszanych ścieżek. Wywoływane przed pierwszym Offer
+		*/
+		void SetLocalSearch(const bool & LocalSearch);
+
+	public:
+		/*
+			Zgłasza ścieżkę Scratch, kończącą się celem TargetId. Zwraca true, jeśli poprawiła najlepszą ścieżkę do tego celu
+		*/
+		bool Offer(const Task::TargetId_t & TargetId, const DecodeScratch & Scratch);
+
+		/*
+			Przejmuje ścieżki Other lepsze od własnych. Zwraca liczbę poprawionych celów
+		*/
+		size_t Merge(const TargetBest & Other);
+
+	public:
+		/*
+			Liczba celów, do których znana jest ścieżka
+		*/
+		size_t GetReachedNumber() const;
+
+		/*
+			Waga najlepszej ścieżki do celu TargetId, std::numeric_limits<GraphPath::PathWeight_t>::max() - brak ścieżki
+		*/
+		const GraphPath::PathWeight_t & GetPathWeight(const Task::TargetId_t & TargetId) const;
+
+		/*
+			Kopia najlepszej ścieżki do celu TargetId
+		*/
+		std::optional<GraphPath> GetGraphPath(const Task::TargetId_t & TargetId) const;
+};
+
@@ -1,8 +1,58 @@
 #include "Task.hpp"
 
+#include <stdexcept>
+
+const Task::TargetId_t Task::TargetIdNone;
+
 Task::Task(const Graph & G, const Graph::VertexIndex_t & VertexIndexStart, const Graph::VertexIndex_t & VertexIndexEnd):
-	G(G), VertexIndexStart(VertexIndexStart), VertexIndexEnd(VertexIndexEnd)
+	G(G), VertexIndexStart(VertexIndexStart), VertexIndexEnds(1, VertexIndexEnd)
 {
+	Validate();
+}
+
+Task::Task(const Graph & G, const Graph::VertexIndex_t & VertexIndexStart, const std::vector<Graph::VertexIndex_t> & VertexIndexEnds):
+	G(G), VertexIndexStart(VertexIndexStart), VertexIndexEnds(VertexIndexEnds)
+{
+	if(VertexIndexEnds.empty())
+		throw std::invalid_argument("VertexIndexEnds.empty()");
+
+	if(VertexIndexEnds.size() >= TargetIdNone)
+		throw std::invalid_argument("VertexIndexEnds.size() >= TargetIdNone");
+
+	Validate();
+
+	for(const Graph::VertexIndex_t & VertexIndexEnd : VertexIndexEnds)
+	{
+		if(VertexIndexEnd == VertexIndexStart)
+			throw std::invalid_argument("VertexIndexEnd == VertexIndexStart");
+	}
+
+	// Zadanie jednocelowe - bez tablicy celów, dekodowanie kończy się na jedynym celu
+	if(VertexIndexEnds.size() == 1)
+		return;
+
+	TargetIds.assign(G.GetSize(), TargetIdNone);
+	for(size_t TargetId = 0; TargetId < VertexIndexEnds.size(); TargetId++)
+	{
+		const Graph::VertexIndex_t & VertexIndexEnd = VertexIndexEnds[TargetId];
+
+		if(TargetIds[VertexIndexEnd] != TargetIdNone)
+			throw std::invalid_argument("VertexIndexEnds contains duplicates");
+
+		TargetIds[VertexIndexEnd] = (TargetId_t) TargetId;
+	}
+}
+
+void Task::Validate() const
+{
+	if(VertexIndexStart >= G.GetSize())
+		throw std::invalid_argument("VertexIndexStart >= G.GetSize()");
+
+	for(const Graph::VertexIndex_t & VertexIndexEnd : VertexIndexEnds)
+	{
+		if(VertexIndexEnd >= G.GetSize())
+			throw std::invalid_argument("VertexIndexEnd >= G.GetSize()");
+	}
 }
 
 const Graph & Task::GetGraph() const
@@ -17,5 +67,20 @@ const Graph::VertexIndex_t & Task::GetVertexIndexStart() const
 
 const Graph::VertexIndex_t & Task::GetVertexIndexEnd() const
 {
-	return VertexIndexEnd;
+	return VertexIndexEnds.front();
+}
+
+const std::vector<Graph::VertexIndex_t> & Task::GetVertexIndexEnds() const
+{
+	return VertexIndexEnds;
+}
+
+bool Task::IsMultiTarget() const
+{
+	return VertexIndexEnds.size() > 1;
+}
+
+const Task::TargetId_t & Task::GetTargetId(const Graph::VertexIndex_t & VertexIndex) const
+{
+	return TargetIds[VertexIndex];
 }
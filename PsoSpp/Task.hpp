@@ -1,27 +1,70 @@
 #pragma once
 
+#include <cstdint>
 #include <optional>
 #include <list>
+#include <vector>
 
 #include "Graph.hpp"
 
 /*
-	Klasa reprezentujca zadanie optymalizacji
-	Wrapper na graf + indeksy wza pocztku i koca
+	Klasa reprezentująca zadanie optymalizacji
+	Wrapper na graf + indeksy węzła początku i końca
+
+	Zadanie wielocelowe (jeden początek, wiele końców) - rój optymalizuje ścieżkę do pierwszego celu (GetVertexIndexEnd()),
+	ale dekodowanie idzie dalej, aż odwiedzi wszystkie cele lub utknie, i zapisuje po drodze najlepszą znaną ścieżkę do każdego celu (TargetBest).
+	Jedno przejście roju odpowiada więc na wszystkie cele zamiast osobnego uruchomienia dla każdej pary.
 */
 class Task
 {
 	public:
+		// Numer celu - pozycja w GetVertexIndexEnds()
+		typedef uint32_t TargetId_t;
+
+		// Wierzchołek nie jest celem zadania
+		static const TargetId_t TargetIdNone = UINT32_MAX;
+
+	public:
+		/*
+			Zadanie jednocelowe. VertexIndexEnd może być wierzchołkiem początkowym - wynikiem jest wtedy ścieżka jednowierzchołkowa o wadze 0
+		*/
 		Task(const Graph & G, const Graph::VertexIndex_t & VertexIndexStart, const Graph::VertexIndex_t & VertexIndexEnd);
 
+		/*
+			Zadanie wielocelowe. VertexIndexEnds - cele, niepuste, bez powtórzeń i bez wierzchołka początkowego.
+			Pierwszy cel wyznacza ścieżkę optymalizowaną przez rój (GetVertexIndexEnd())
+		*/
+		Task(const Graph & G, const Graph::VertexIndex_t & VertexIndexStart, const std::vector<Graph::VertexIndex_t> & VertexIndexEnds);
+
 	private:
 		const Graph & G;
 		const Graph::VertexIndex_t VertexIndexStart;
-		const Graph::VertexIndex_t VertexIndexEnd;
+		std::vector<Graph::VertexIndex_t> VertexIndexEnds;
+
+		/*
+			Numer celu dla każdego wierzchołka grafu (TargetIdNone - wierzchołek nie jest celem). Tylko dla zadania wielocelowego
+		*/
+		std::vector<TargetId_t> TargetIds; /* G.GetSize() lub 0 */
+
+		/*
+			Sprawdzenie wspólne dla obu konstruktorów: początek i wszystkie cele w grafie
+		*/
+		void Validate() const;
 
 	public:
 		const Graph & GetGraph() const;
 		const Graph::VertexIndex_t & GetVertexIndexStart() const;
 		const Graph::VertexIndex_t & GetVertexIndexEnd() const;
+		const std::vector<Graph::VertexIndex_t> & GetVertexIndexEnds() const;
+
+		/*
+			Czy zadanie ma więcej niż jeden cel
+		*/
+		bool IsMultiTarget() const;
+
+		/*
+			Numer celu VertexIndex lub TargetIdNone. Tylko dla zadania wielocelowego
+		*/
+		const TargetId_t & GetTargetId(const Graph::VertexIndex_t & VertexIndex) const;
 };
 
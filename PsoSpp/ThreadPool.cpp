@@ -0,0 +1,403 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+#if defined(_WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#elif defined(__linux__)
+	#include <pthread.h>
+	#include <sched.h>
+#endif
+
+namespace
+{
+	// Pula i kolejka, do których należy bieżący wątek roboczy
+	thread_local const ThreadPool * ThreadPoolCurrent = nullptr;
+	thread_local size_t QueueIdCurrent = 0;
+
+	// Zadanie, którego indeks wykonuje bieżący wątek (nullptr - poza zadaniem ParallelFor)
+	thread_local const void * JobCurrent = nullptr;
+
+	// Przypina wątek do jednego procesora. Zwraca false, jeśli system odmówił lub nie obsługuje przypinania
+	bool Pin(std::thread & Thread, const size_t & Cpu)
+	{
+	#if defined(_WIN32)
+		if(Cpu >= 8 * sizeof(DWORD_PTR))
+			return false;
+
+		return SetThreadAffinityMask(Thread.native_handle(), (DWORD_PTR) 1 << Cpu) != 0;
+	#elif defined(__linux__)
+		if(Cpu >= CPU_SETSIZE)
+			return false;
+
+		cpu_set_t CpuSet;
+		CPU_ZERO(&CpuSet);
+		CPU_SET(Cpu, &CpuSet);
+		return pthread_setaffinity_np(Thread.native_handle(), sizeof(CpuSet), &CpuSet) == 0;
+	#else
+		(void) Thread;
+		(void) Cpu;
+		return false;
+	#endif
+	}
+
+	// Ogranicza wątek do zbioru procesorów - system wybiera procesor spośród Cpus. Zwraca false, jeśli system odmówił, nie obsługuje przypinania lub żaden procesor nie mieści się w masce
+	bool Bind(const std::thread::native_handle_type & Thread, const std::vector<size_t> & Cpus)
+	{
+	#if defined(_WIN32)
+		DWORD_PTR Mask = 0;
+		for(const size_t & Cpu : Cpus)
+			if(Cpu < 8 * sizeof(DWORD_PTR))
+				Mask |= (DWORD_PTR) 1 << Cpu;
+
+		if(Mask == 0)
+			return false;
+
+		return SetThreadAffinityMask(Thread, Mask) != 0;
+	#elif defined(__linux__)
+		cpu_set_t CpuSet;
+		CPU_ZERO(&CpuSet);
+		for(const size_t & Cpu : Cpus)
+			if(Cpu < CPU_SETSIZE)
+				CPU_SET(Cpu, &CpuSet);
+
+		if(CPU_COUNT(&CpuSet) == 0)
+			return false;
+
+		return pthread_setaffinity_np(Thread, sizeof(CpuSet), &CpuSet) == 0;
+	#else
+		(void) Thread;
+		(void) Cpus;
+		return false;
+	#endif
+	}
+}
+
+ThreadPool::ThreadPool(const size_t & ThreadNumber):
+	ThreadPool(ThreadNumber, std::vector<size_t>())
+{
+
+}
+
+ThreadPool::ThreadPool(const size_t & ThreadNumber, const std::vector<size_t> & Cpus):
+	ThreadPool(ThreadNumber, Cpus, Affinity_t::Cpu)
+{
+
+}
+
+ThreadPool::ThreadPool(const size_t & ThreadNumber, const std::vector<size_t> & Cpus, const Affinity_t & Affinity):
+	QueueNumber((ThreadNumber ? ThreadNumber : std::max<size_t>(1, std::thread::hardware_concurrency())) + 1),
+	ThreadsPinned(0),
+	WorkEpoch(0),
+	Stopping(false)
+{
+	Queues.reset(new Queue_t[QueueNumber]);
+	for(size_t QueueId = 0; QueueId < QueueNumber; QueueId++)
+	{
+		Queues[QueueId].Begin = 0;
+		Queues[QueueId].Size = 0;
+	}
+
+	// Ostatnia kolejka należy do wątków spoza puli
+	for(size_t QueueId = 0; QueueId + 1 < QueueNumber; QueueId++)
+	{
+		Threads.emplace_back(&ThreadPool::Worker, this, QueueId);
+
+		// Przypięcie z wątku tworzącego - po powrocie z konstruktora liczba przypiętych wątków jest już znana
+		if(Cpus.empty())
+			continue;
+
+		if(Affinity == Affinity_t::Cpu ? Pin(Threads.back(), Cpus[QueueId % Cpus.size()]) : Bind(Threads.back().native_handle(), Cpus))
+			++ThreadsPinned;
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> Lock(SleepMutex);
+		Stopping = true;
+	}
+	SleepCondition.notify_all();
+
+	for(std::thread & Thread : Threads)
+		Thread.join();
+}
+
+size_t ThreadPool::GetThreadNumber() const
+{
+	return Threads.size();
+}
+
+size_t ThreadPool::GetThreadsPinned() const
+{
+	return ThreadsPinned;
+}
+
+bool ThreadPool::BindCurrentThread(const std::vector<size_t> & Cpus)
+{
+#if defined(_WIN32)
+	return Bind(GetCurrentThread(), Cpus);
+#elif defined(__linux__)
+	return Bind(pthread_self(), Cpus);
+#else
+	(void) Cpus;
+	return false;
+#endif
+}
+
+void ThreadPool::Worker(const size_t & QueueId)
+{
+	ThreadPoolCurrent = this;
+	QueueIdCurrent = QueueId;
+
+	while(true)
+	{
+		// Epoka sprzed przeszukania kolejek - jeśli w międzyczasie pojawi się zadanie, nie zaśniemy
+		const uint64_t WorkEpochSeen = WorkEpoch.load(std::memory_order_acquire);
+
+		Job_t * Job = Acquire(QueueId, nullptr);
+		if(Job)
+		{
+			while(RunIndex(*Job));
+			Release(*Job);
+			continue;
+		}
+
+		// Brak pracy ParallelFor - zadanie niezależne, a jeśli go nie ma, śpimy do nowego zadania
+		std::function<void()> Function;
+		{
+			std::unique_lock<std::mutex> Lock(SleepMutex);
+			if(Posted.empty())
+			{
+				// Zatrzymanie dopiero po wykonaniu wszystkich zleconych zadań
+				if(Stopping)
+					return;
+
+				SleepCondition.wait(Lock, [&] { return Stopping || WorkEpoch.load(std::memory_order_acquire) != WorkEpochSeen; });
+				continue;
+			}
+
+			Function = std::move(Posted.front());
+			Posted.pop_front();
+		}
+
+		Function();
+	}
+}
+
+void ThreadPool::Post(std::function<void()> && Function)
+{
+	{
+		std::lock_guard<std::mutex> Lock(SleepMutex);
+		Posted.push_back(std::move(Function));
+		WorkEpoch.fetch_add(1, std::memory_order_release);
+	}
+	SleepCondition.notify_one();
+}
+
+void ThreadPool::Execute(Job_t & Job)
+{
+	Job.IndexNext.store(0, std::memory_order_relaxed);
+	Job.IndexRemaining.store(Job.Count, std::memory_order_relaxed);
+	Job.Users.store(0, std::memory_order_relaxed);
+	Job.Parent = static_cast<const Job_t *>(JobCurrent);
+	Job.Failed.store(false, std::memory_order_relaxed);
+	Job.Exception = nullptr;
+
+	if(Job.Count == 0)
+		return;
+
+	// Publikacja zadania w kolejce bieżącego wątku
+	const size_t QueueId = GetQueueId();
+	Queue_t & Queue = Queues[QueueId];
+
+	bool Published = false;
+	if(Job.Count > 1)
+	{
+		std::lock_guard<std::mutex> Lock(Queue.Mutex);
+		if(Queue.Size < QueueCapacity)
+		{
+			Queue.Jobs[(Queue.Begin + Queue.Size) % QueueCapacity] = &Job;
+			++Queue.Size;
+			Published = true;
+		}
+	}
+
+	if(Published)
+	{
+		{
+			std::lock_guard<std::mutex> Lock(SleepMutex);
+			WorkEpoch.fetch_add(1, std::memory_order_release);
+		}
+		SleepCondition.notify_all();
+		WaitCondition.notify_all();
+	}
+
+	// Wykonujemy własne indeksy
+	while(RunIndex(Job));
+
+	// Zadanie bez wolnych indeksów nie może zostać w kolejce - zdejmujemy je, jeśli nikt tego jeszcze nie zrobił
+	if(Published)
+	{
+		std::lock_guard<std::mutex> Lock(Queue.Mutex);
+		for(size_t Position = 0; Position < Queue.Size; Position++)
+		{
+			if(Queue.Jobs[(Queue.Begin + Position) % QueueCapacity] != &Job)
+				continue;
+
+			// Przesunięcie późniejszych wpisów o jeden w stronę początku
+			for(size_t PositionNext = Position + 1; PositionNext < Queue.Size; PositionNext++)
+				Queue.Jobs[(Queue.Begin + PositionNext - 1) % QueueCapacity] = Queue.Jobs[(Queue.Begin + PositionNext) % QueueCapacity];
+			--Queue.Size;
+			break;
+		}
+	}
+
+	// Czekamy na indeksy wykonywane przez inne wątki i na zwolnienie zadania, pomagając wyłącznie w zadaniach w nim zagnieżdżonych. Również po wyjątku - zadanie żyje na naszym stosie
+	const auto IsDone = [&]() { return Job.IndexRemaining.load(std::memory_order_acquire) == 0 && Job.Users.load(std::memory_order_acquire) == 0; };
+	size_t Spins = 0;
+	while(!IsDone())
+	{
+		// Epoka sprzed przeszukania kolejek - jeśli w międzyczasie pojawi się zadanie zagnieżdżone, nie zaśniemy
+		const uint64_t WorkEpochSeen = WorkEpoch.load(std::memory_order_acquire);
+
+		Job_t * JobOther = Acquire(QueueId, &Job);
+		if(JobOther)
+		{
+			RunIndex(*JobOther);
+			Release(*JobOther);
+			Spins = 0;
+			continue;
+		}
+
+		if(Spins < WaitSpinMax)
+		{
+			++Spins;
+			std::this_thread::yield();
+			continue;
+		}
+
+		// Brak pracy zagnieżdżonej - śpimy do zwolnienia zadania lub nowego zadania
+		std::unique_lock<std::mutex> Lock(SleepMutex);
+		WaitCondition.wait(Lock, [&] { return IsDone() || WorkEpoch.load(std::memory_order_acquire) != WorkEpochSeen; });
+		Spins = 0;
+	}
+
+	if(Job.Exception)
+		std::rethrow_exception(Job.Exception);
+}
+
+ThreadPool::Job_t * ThreadPool::Acquire(const size_t & QueueId, const Job_t * Ancestor)
+{
+	for(size_t QueueOffset = 0; QueueOffset < QueueNumber; QueueOffset++)
+	{
+		Queue_t & Queue = Queues[(QueueId + QueueOffset) % QueueNumber];
+
+		std::lock_guard<std::mutex> Lock(Queue.Mutex);
+		if(Queue.Size == 0)
+			continue;
+
+		// Własna kolejka - od końca (najnowsze, najgłębiej zagnieżdżone zadanie), cudze - od początku (najstarsze, największe)
+		const bool QueueOwn = QueueOffset == 0;
+
+		// Zadania bez wolnych indeksów na końcu, od którego pobieramy - zdejmujemy z kolejki
+		while(Queue.Size > 0)
+		{
+			const size_t Position = QueueOwn ? (Queue.Begin + Queue.Size - 1) % QueueCapacity : Queue.Begin;
+			const Job_t * Job = Queue.Jobs[Position];
+			if(Job->IndexNext.load(std::memory_order_relaxed) < Job->Count)
+				break;
+
+			if(QueueOwn)
+			{
+				--Queue.Size;
+			}
+			else
+			{
+				Queue.Begin = (Queue.Begin + 1) % QueueCapacity;
+				--Queue.Size;
+			}
+		}
+
+		for(size_t Offset = 0; Offset < Queue.Size; Offset++)
+		{
+			const size_t Position = QueueOwn ? (Queue.Begin + Queue.Size - 1 - Offset) % QueueCapacity : (Queue.Begin + Offset) % QueueCapacity;
+			Job_t * Job = Queue.Jobs[Position];
+
+			if(Job->IndexNext.load(std::memory_order_relaxed) < Job->Count && IsNested(*Job, Ancestor))
+			{
+				// Zadanie nie zniknie, dopóki Users > 0
+				Job->Users.fetch_add(1, std::memory_order_acquire);
+				return Job;
+			}
+		}
+	}
+
+	return nullptr;
+}
+
+bool ThreadPool::IsNested(const Job_t & Job, const Job_t * Ancestor)
+{
+	if(!Ancestor)
+		return true;
+
+	// Zadanie w kolejce żyje, a wraz z nim wszystkie zadania, z których zostało zlecone
+	for(const Job_t * Parent = Job.Parent; Parent; Parent = Parent->Parent)
+	{
+		if(Parent == Ancestor)
+			return true;
+	}
+
+	return false;
+}
+
+bool ThreadPool::RunIndex(Job_t & Job)
+{
+	const size_t Index = Job.IndexNext.fetch_add(1, std::memory_order_relaxed);
+	if(Index >= Job.Count)
+		return false;
+
+	// Po wyjątku zadanie jest przerwane - pozostałe indeksy tylko odliczamy
+	if(!Job.Failed.load(std::memory_order_relaxed))
+	{
+		// Zadania zlecone z tego indeksu są w nim zagnieżdżone
+		const void * JobPrevious = JobCurrent;
+		JobCurrent = &Job;
+		try
+		{
+			Job.Invoke(Job.Context, Index);
+		}
+		catch(...)
+		{
+			// Zapis przed zmniejszeniem IndexRemaining - wątek czekający odczyta go po zakończeniu zadania
+			if(!Job.Failed.exchange(true, std::memory_order_relaxed))
+				Job.Exception = std::current_exception();
+		}
+		JobCurrent = JobPrevious;
+	}
+
+	Job.IndexRemaining.fetch_sub(1, std::memory_order_acq_rel);
+	return true;
+}
+
+void ThreadPool::Release(Job_t & Job)
+{
+	if(Job.Users.fetch_sub(1, std::memory_order_acq_rel) != 1)
+		return;
+
+	// Pod blokadą - czekający sprawdza warunek i zasypia pod tą samą blokadą
+	std::lock_guard<std::mutex> Lock(SleepMutex);
+	WaitCondition.notify_all();
+}
+
+size_t ThreadPool::GetQueueId() const
+{
+	// Wątek spoza puli (lub innej puli) - kolejka wspólna
+	if(ThreadPoolCurrent != this)
+		return QueueNumber - 1;
+
+	return QueueIdCurrent;
+}
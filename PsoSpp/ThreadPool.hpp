@@ -0,0 +1,210 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/*
+	Trwała pula wątków z podkradaniem pracy (work-stealing).
+
+	Podstawową operacją jest ParallelFor - równoległe wykonanie Function(Index) dla Index = 0 .. Count - 1.
+	Zadanie (Job_t) trafia do kolejki wątku, który je zlecił. Wolne wątki przeglądają najpierw własną kolejkę, a potem podkradają zadania z kolejek innych wątków.
+	Indeksy zadania pobierane są pojedynczo z licznika atomowego, więc wolniejsze indeksy (np. dłuższe dekodowania) nie blokują pozostałych wątków.
+
+	Wątek czekający na zakończenie swojego zadania nie zasypia - wykonuje w tym czasie indeksy zadań w nim zagnieżdżonych (zleconych z jego indeksów).
+	Dzięki temu ParallelFor można zagnieżdżać (np. grupy cząstek -> fragmenty grup) bez ryzyka zakleszczenia,
+	a czekający wątek nie podejmuje zadań zewnętrznych (np. kolejnej grupy), które opóźniłyby powrót z ParallelFor.
+
+	Zlecenie zadania nie alokuje pamięci - zadanie żyje na stosie wątku zlecającego, a kolejki mają stałą pojemność.
+	Wyjątek rzucony przez Function przerywa zadanie - pozostałe indeksy nie są wykonywane, a pierwszy wyjątek ParallelFor rzuca ponownie po zwolnieniu zadania przez wszystkie wątki.
+	Czekający wątek bez pracy zagnieżdżonej krótko aktywnie czeka, a potem zasypia do zakończenia zadania lub pojawienia się nowej pracy.
+
+	Post zleca zadanie niezależne (np. całe zapytanie Solver) bez czekania na jego wykonanie. Zadania te wykonują wyłącznie wątki robocze,
+	gdy nie mają pracy ParallelFor - rozpoczęte obliczenia mają pierwszeństwo przed nowymi.
+*/
+class ThreadPool
+{
+	public:
+		/*
+			ThreadNumber - liczba wątków roboczych. Podanie 0 spowoduje automatyczne ustalenie wartości na podstawie hardware concurency
+		*/
+		ThreadPool(const size_t & ThreadNumber);
+
+		/*
+			Jak wyżej, a wątek roboczy I przypięty jest do procesora Cpus[I % Cpus.size()] (Linux, Windows). Pusty Cpus - bez przypinania.
+			Przypięcie, które się nie powiedzie (np. procesor spoza dozwolonego zbioru), jest pomijane - GetThreadsPinned
+		*/
+		ThreadPool(const size_t & ThreadNumber, const std::vector<size_t> & Cpus);
+
+		/*
+			Sposób przypięcia wątków roboczych do procesorów Cpus
+		*/
+		enum class Affinity_t
+		{
+			Cpu, // wątek roboczy I przypięty do procesora Cpus[I % Cpus.size()]
+			CpuSet, // każdy wątek roboczy może działać na dowolnym procesorze z Cpus (np. wszystkich procesorach węzła NUMA)
+		};
+
+		/*
+			Jak wyżej, a sposób przypięcia wybiera Affinity
+		*/
+		ThreadPool(const size_t & ThreadNumber, const std::vector<size_t> & Cpus, const Affinity_t & Affinity);
+		ThreadPool(const ThreadPool &) = delete;
+		ThreadPool & operator=(const ThreadPool &) = delete;
+		~ThreadPool();
+
+	private:
+		/*
+			Zadanie ParallelFor
+		*/
+		struct Job_t
+		{
+			// Wywołanie Function(Index) - wskaźnik na funkcję i kontekst, bez std::function (bez alokacji)
+			void (*Invoke)(void * Context, const size_t & Index);
+			void * Context;
+
+			size_t Count;
+
+			// Następny nieprzydzielony indeks
+			std::atomic<size_t> IndexNext;
+
+			// Liczba niewykonanych indeksów
+			std::atomic<size_t> IndexRemaining;
+
+			// Liczba wątków trzymających wskaźnik na zadanie (pobrany z kolejki)
+			std::atomic<size_t> Users;
+
+			// Zadanie, z którego indeksu zlecono to zadanie (nullptr - zadanie zewnętrzne). Żyje dłużej niż zadanie zagnieżdżone
+			const Job_t * Parent;
+
+			// Pierwszy wyjątek rzucony przez Function - zapisuje go wątek, który pierwszy ustawi Failed. Czytany po zakończeniu zadania
+			std::atomic<bool> Failed;
+			std::exception_ptr Exception;
+		};
+
+		/*
+			Kolejka zadań jednego wątku - bufor cykliczny o stałej pojemności
+		*/
+		static const size_t QueueCapacity = 64;
+		struct alignas(64) Queue_t
+		{
+			std::mutex Mutex;
+			Job_t * Jobs[QueueCapacity];
+			size_t Begin;
+			size_t Size;
+		};
+
+		/*
+			Kolejki wątków roboczych + jedna kolejka dla wątków spoza puli (ostatnia)
+		*/
+		std::unique_ptr<Queue_t[]> Queues;
+		size_t QueueNumber;
+
+		std::vector<std::thread> Threads;
+
+		/*
+			Liczba wątków roboczych przypiętych do procesora lub zbioru procesorów
+		*/
+		size_t ThreadsPinned;
+
+		/*
+			Usypianie bezczynnych wątków. WorkEpoch zmienia się przy każdym nowym zadaniu
+			WaitCondition - wątki czekające na zakończenie swojego zadania (Execute), budzone przez nowe zadanie i zwolnienie zadania przez ostatni wątek
+		*/
+		std::mutex SleepMutex;
+		std::condition_variable SleepCondition;
+		std::condition_variable WaitCondition;
+		std::atomic<uint64_t> WorkEpoch;
+		bool Stopping;
+
+		/*
+			Zadania niezależne (Post), chronione przez SleepMutex
+		*/
+		std::deque<std::function<void()>> Posted;
+
+	public:
+		/*
+			Liczba wątków roboczych
+		*/
+		size_t GetThreadNumber() const;
+		size_t GetThreadsPinned() const;
+
+		/*
+			Ogranicza bieżący wątek do procesorów Cpus (Linux, Windows) - wątki, które utworzy później (np. wątki robocze puli), dziedziczą to ograniczenie.
+			Zwraca false, jeśli system odmówił lub nie obsługuje przypinania
+		*/
+		static bool BindCurrentThread(const std::vector<size_t> & Cpus);
+
+		/*
+			Wykonuje Function(Index) dla Index = 0 .. Count - 1 na wątkach puli i czeka na zakończenie.
+			Wątek wywołujący również wykonuje indeksy. Kolejność wykonania indeksów jest dowolna.
+			Pierwszy wyjątek rzucony przez Function jest ponownie rzucany w wątku wywołującym
+		*/
+		template<typename Function_t>
+		void ParallelFor(const size_t & Count, Function_t && Function)
+		{
+			Job_t Job;
+			Job.Invoke = [](void * Context, const size_t & Index) { (*static_cast<typename std::remove_reference<Function_t>::type *>(Context))(Index); };
+			Job.Context = const_cast<void *>(static_cast<const void *>(&Function));
+			Job.Count = Count;
+			Execute(Job);
+		}
+
+		/*
+			Zleca wykonanie Function() na jednym z wątków roboczych i wraca natychmiast.
+			Zadania wykonywane są w kolejności zlecenia. Destruktor puli czeka na wykonanie wszystkich zleconych zadań.
+			Function nie może rzucać wyjątków
+		*/
+		void Post(std::function<void()> && Function);
+
+	private:
+		/*
+			Pętla wątku roboczego
+		*/
+		void Worker(const size_t & QueueId);
+
+		/*
+			Publikuje zadanie, wykonuje je wspólnie z innymi wątkami i czeka na jego zakończenie
+		*/
+		void Execute(Job_t & Job);
+
+		/*
+			Pobiera zadanie z wolnymi indeksami - najpierw z kolejki QueueId, potem z pozostałych. Zwiększa Job_t::Users
+			Ancestor różny od nullptr - tylko zadania zagnieżdżone (bezpośrednio lub pośrednio) w zadaniu Ancestor
+		*/
+		Job_t * Acquire(const size_t & QueueId, const Job_t * Ancestor);
+
+		/*
+			Czy zadanie Job zostało zlecone (bezpośrednio lub pośrednio) z indeksu zadania Ancestor. Dla Ancestor == nullptr zawsze true
+		*/
+		static bool IsNested(const Job_t & Job, const Job_t * Ancestor);
+
+		/*
+			Wykonuje jeden indeks zadania. Zwraca false, jeśli zadanie nie ma już wolnych indeksów.
+			Wyjątek Function zapisywany jest w zadaniu, a pozostałe indeksy są tylko odliczane
+		*/
+		static bool RunIndex(Job_t & Job);
+
+		/*
+			Zmniejsza Job_t::Users. Ostatni wątek budzi czekających w Execute - po zwolnieniu zadanie może już nie istnieć
+		*/
+		void Release(Job_t & Job);
+
+		/*
+			Liczba prób pobrania pracy zagnieżdżonej przed uśpieniem wątku czekającego w Execute
+		*/
+		static const size_t WaitSpinMax = 64;
+
+		/*
+			Kolejka bieżącego wątku (wątki spoza puli - kolejka wspólna)
+		*/
+		size_t GetQueueId() const;
+};
+
@@ -0,0 +1,64 @@
+#include "TraceRing.hpp"
+
+namespace
+{
+	size_t RoundUpToPowerOfTwo(const size_t & Value)
+	{
+		size_t Result = 1;
+		while(Result < Value)
+			Result <<= 1;
+		return Result;
+	}
+}
+
+TraceRing::TraceRing(const size_t & Capacity):
+	Capacity(RoundUpToPowerOfTwo(Capacity)), Records(new Record_t[this->Capacity]), Head(0), Tail(0), Dropped(0), Closed(false)
+{
+
+}
+
+const size_t & TraceRing::GetCapacity() const
+{
+	return Capacity;
+}
+
+uint64_t TraceRing::GetDropped() const
+{
+	return Dropped.load(std::memory_order_relaxed);
+}
+
+bool TraceRing::IsDrained() const
+{
+	// Closed przed Head - wpisy zapisane przed zamknięciem są już widoczne
+	return Closed.load(std::memory_order_acquire) && Tail.load(std::memory_order_relaxed) == Head.load(std::memory_order_acquire);
+}
+
+bool TraceRing::Push(const Record_t & Record)
+{
+	const uint64_t HeadCurrent = Head.load(std::memory_order_relaxed);
+	if(HeadCurrent - Tail.load(std::memory_order_acquire) >= Capacity)
+	{
+		Dropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	Records[HeadCurrent & (Capacity - 1)] = Record;
+	Head.store(HeadCurrent + 1, std::memory_order_release);
+	return true;
+}
+
+void TraceRing::Close()
+{
+	Closed.store(true, std::memory_order_release);
+}
+
+bool TraceRing::Pop(Record_t & Record)
+{
+	const uint64_t TailCurrent = Tail.load(std::memory_order_relaxed);
+	if(TailCurrent == Head.load(std::memory_order_acquire))
+		return false;
+
+	Record = Records[TailCurrent & (Capacity - 1)];
+	Tail.store(TailCurrent + 1, std::memory_order_release);
+	return true;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include "GraphPath.hpp"
+
+/*
+	Bufor cykliczny wpisów śladu zbieżności - jeden producent (grupa cząstek), jeden konsument (TraceWriter).
+
+	Pamięć rezerwowana jest raz, w konstruktorze - zapis wpisu nie alokuje i nie blokuje.
+	Producent i konsument przesuwają własne liczniki (Head, Tail), każdy w osobnej linii pamięci podręcznej, a widoczność wpisów zapewnia para release / acquire.
+	Gdy bufor jest pełny (konsument nie nadąża), nowy wpis jest odrzucany i liczony w Dropped - producent nigdy nie czeka.
+*/
+class TraceRing
+{
+	public:
+		struct Record_t
+		{
+			std::chrono::steady_clock::time_point TimePoint;
+			size_t ParticleGroupId;
+			size_t ParticleIteration;
+			GraphPath::PathWeight_t PathWeight;
+		};
+
+	public:
+		/*
+			Capacity - pojemność bufora, zaokrąglana w górę do potęgi dwójki
+		*/
+		TraceRing(const size_t & Capacity);
+		TraceRing(const TraceRing &) = delete;
+		TraceRing & operator=(const TraceRing &) = delete;
+
+	private:
+		const size_t Capacity;
+		std::unique_ptr<Record_t[]> Records;
+
+		// Licznik zapisanych wpisów - zmieniany tylko przez producenta
+		alignas(64) std::atomic<uint64_t> Head;
+
+		// Licznik odczytanych wpisów - zmieniany tylko przez konsumenta
+		alignas(64) std::atomic<uint64_t> Tail;
+
+		// Wpisy odrzucone przy pełnym buforze
+		std::atomic<uint64_t> Dropped;
+
+		// Producent nie będzie już zapisywał (Close)
+		std::atomic<bool> Closed;
+
+	public:
+		const size_t & GetCapacity() const;
+		uint64_t GetDropped() const;
+
+		/*
+			Czy bufor jest zamknięty i opróżniony - konsument może go zwolnić
+		*/
+		bool IsDrained() const;
+
+	public:
+		/*
+			Producent - zapisuje wpis. Zwraca false, jeśli bufor jest pełny (wpis odrzucony)
+		*/
+		bool Push(const Record_t & Record);
+
+		/*
+			Producent - kończy zapis. Po Close() bufor należy wyłącznie do konsumenta
+		*/
+		void Close();
+
+		/*
+			Konsument - odczytuje najstarszy wpis. Zwraca false, jeśli bufor jest pusty
+		*/
+		bool Pop(Record_t & Record);
+};
@@ -0,0 +1,137 @@
+#include "TraceWriter.hpp"
+
+#include <algorithm>
+
+const size_t TraceWriter::RingCapacity;
+constexpr std::chrono::milliseconds TraceWriter::DrainInterval;
+
+TraceWriter::TraceWriter(std::ostream & Stream, const Format_t & Format, const std::chrono::steady_clock::time_point & TimePointZero):
+	Stream(&Stream), Format(Format), TimePointZero(TimePointZero),
+	Written(0), DroppedReleased(0), Stopping(false)
+{
+	if(Format == Format_t::Csv)
+		Stream << "time_us,group,iteration,weight" << std::endl;
+
+	Thread = std::thread(&TraceWriter::Worker, this);
+}
+
+TraceWriter::TraceWriter(Callback_t && Callback):
+	Stream(nullptr), Format(Format_t::Csv), TimePointZero(), Callback(std::move(Callback)),
+	Written(0), DroppedReleased(0), Stopping(false)
+{
+	Thread = std::thread(&TraceWriter::Worker, this);
+}
+
+TraceWriter::~TraceWriter()
+{
+	Close();
+}
+
+TraceRing & TraceWriter::CreateRing()
+{
+	std::lock_guard<std::mutex> Lock(Mutex);
+	Rings.emplace_back(new TraceRing(RingCapacity));
+	return *Rings.back();
+}
+
+void TraceWriter::Close()
+{
+	{
+		std::lock_guard<std::mutex> Lock(Mutex);
+		if(Stopping)
+			return;
+		Stopping = true;
+	}
+	Condition.notify_all();
+	Thread.join();
+
+	// Wpisy zapisane od ostatniego opróżnienia
+	std::unique_lock<std::mutex> Lock(Mutex);
+	Drain(Lock);
+}
+
+uint64_t TraceWriter::GetWritten()
+{
+	std::lock_guard<std::mutex> Lock(Mutex);
+	return Written;
+}
+
+uint64_t TraceWriter::GetDropped()
+{
+	std::lock_guard<std::mutex> Lock(Mutex);
+
+	uint64_t Dropped = DroppedReleased;
+	for(const std::unique_ptr<TraceRing> & Ring : Rings)
+		Dropped += Ring->GetDropped();
+	return Dropped;
+}
+
+void TraceWriter::Worker()
+{
+	std::unique_lock<std::mutex> Lock(Mutex);
+	while(!Stopping)
+	{
+		Condition.wait_for(Lock, DrainInterval, [&] { return Stopping; });
+		Drain(Lock);
+	}
+}
+
+void TraceWriter::Drain(std::unique_lock<std::mutex> & Lock)
+{
+	// Bufory istniejące w chwili opróżnienia - obiekty buforów nie zmieniają położenia, gdy CreateRing dopisuje nowe
+	RingsDrained.clear();
+	for(const std::unique_ptr<TraceRing> & Ring : Rings)
+		RingsDrained.push_back(Ring.get());
+
+	Lock.unlock();
+
+	// Porcja ze wszystkich buforów, uporządkowana według czasu - grupy poprawiają wyniki niezależnie od siebie
+	Batch.clear();
+	for(TraceRing * Ring : RingsDrained)
+	{
+		TraceRing::Record_t Record;
+		while(Ring->Pop(Record))
+			Batch.push_back(Record);
+	}
+
+	std::stable_sort(Batch.begin(), Batch.end(), [](const TraceRing::Record_t & Record1, const TraceRing::Record_t & Record2) { return Record1.TimePoint < Record2.TimePoint; });
+
+	for(const TraceRing::Record_t & Record : Batch)
+		Write(Record);
+
+	if(Stream && !Batch.empty())
+		Stream->flush();
+
+	Lock.lock();
+	Written += Batch.size();
+
+	// Bufory zamknięte i opróżnione - producent już ich nie używa
+	for(std::vector<std::unique_ptr<TraceRing>>::iterator Ring = Rings.begin(); Ring != Rings.end(); )
+	{
+		if((*Ring)->IsDrained())
+		{
+			DroppedReleased += (*Ring)->GetDropped();
+			Ring = Rings.erase(Ring);
+		}
+		else
+		{
+			++Ring;
+		}
+	}
+}
+
+void TraceWriter::Write(const TraceRing::Record_t & Record)
+{
+	if(Callback)
+	{
+		Callback(Record);
+		return;
+	}
+
+	const long long TimeMicroseconds = (long long) std::chrono::duration_cast<std::chrono::microseconds>(Record.TimePoint - TimePointZero).count();
+
+	if(Format == Format_t::Csv)
+		*Stream << TimeMicroseconds << "," << Record.ParticleGroupId << "," << Record.ParticleIteration << "," << Record.PathWeight << "\n";
+	else
+		*Stream << "{\"time_us\":" << TimeMicroseconds << ",\"group\":" << Record.ParticleGroupId << ",\"iteration\":" << Record.ParticleIteration << ",\"weight\":" << Record.PathWeight << "}\n";
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+#include "TraceRing.hpp"
+
+/*
+	Strumieniowy zapis śladu zbieżności (poprawy najlepszych rozwiązań grup) w trakcie obliczeń.
+
+	Każda grupa cząstek dostaje własny bufor (CreateRing), do którego zapisuje wpisy bez blokad i alokacji.
+	Wątek zapisu co DrainInterval opróżnia wszystkie bufory, porządkuje zebraną porcję wpisów według czasu i przekazuje je dalej:
+		- do strumienia (np. pliku) jako CSV lub JSON lines, z czasem w mikrosekundach od TimePointZero
+		- albo do funkcji Callback
+	Bufory zamknięte przez producenta (TraceRing::Close) są zwalniane po opróżnieniu, więc jeden TraceWriter może obsługiwać wiele kolejnych zapytań.
+*/
+class TraceWriter
+{
+	public:
+		enum class Format_t
+		{
+			// time_us,group,iteration,weight
+			Csv,
+			// {"time_us":...,"group":...,"iteration":...,"weight":...}
+			JsonLines
+		};
+
+		typedef std::function<void(const TraceRing::Record_t & Record)> Callback_t;
+
+		// Pojemność bufora grupy - poprawy są rzadkie (co najwyżej kilka na iterację), bufor opróżniany jest co DrainInterval
+		static const size_t RingCapacity = 1024;
+
+		// Odstęp pomiędzy kolejnymi opróżnieniami buforów
+		static constexpr std::chrono::milliseconds DrainInterval = std::chrono::milliseconds(10);
+
+	public:
+		/*
+			Zapis do strumienia Stream w formacie Format. Stream musi żyć do Close()
+			TimePointZero - chwila odniesienia dla czasu wpisów (np. start zapytania)
+		*/
+		TraceWriter(std::ostream & Stream, const Format_t & Format, const std::chrono::steady_clock::time_point & TimePointZero);
+
+		/*
+			Przekazywanie wpisów do Callback, wywoływanej z wątku zapisu
+		*/
+		TraceWriter(Callback_t && Callback);
+
+		TraceWriter(const TraceWriter &) = delete;
+		TraceWriter & operator=(const TraceWriter &) = delete;
+		~TraceWriter();
+
+	private:
+		std::ostream * const Stream;
+		const Format_t Format;
+		const std::chrono::steady_clock::time_point TimePointZero;
+		const Callback_t Callback;
+
+		/*
+			Bufory grup i liczniki - chronione przez Mutex
+		*/
+		std::mutex Mutex;
+		std::vector<std::unique_ptr<TraceRing>> Rings;
+		uint64_t Written;
+		uint64_t DroppedReleased;
+
+		/*
+			Bufory bieżącego opróżnienia (wskaźniki skopiowane z Rings) i porcja wpisów - używane tylko przez Drain, poza Mutex.
+			Bufory usuwa wyłącznie Drain, a opróżnienia nie biegną równolegle (wątek zapisu, potem Close po jego zakończeniu)
+		*/
+		std::vector<TraceRing *> RingsDrained;
+		std::vector<TraceRing::Record_t> Batch;
+
+		std::condition_variable Condition;
+		bool Stopping;
+
+		std::thread Thread;
+
+	public:
+		/*
+			Nowy bufor dla jednej grupy cząstek. Należy do TraceWriter - producent kończy z nim pracę przez TraceRing::Close()
+		*/
+		TraceRing & CreateRing();
+
+		/*
+			Opróżnia bufory po raz ostatni i kończy wątek zapisu. Wywoływane po zakończeniu zapytań - późniejsze wpisy nie zostaną zapisane
+		*/
+		void Close();
+
+		/*
+			Liczba zapisanych wpisów i wpisów odrzuconych przez przepełnione bufory
+		*/
+		uint64_t GetWritten();
+		uint64_t GetDropped();
+
+	private:
+		void Worker();
+
+		/*
+			Jedno opróżnienie wszystkich buforów. Wywoływane z Lock na Mutex - zapis do strumienia i wywołania Callback odbywają się po zwolnieniu Lock,
+			więc wolny zapis nie blokuje CreateRing grup, które właśnie startują
+		*/
+		void Drain(std::unique_lock<std::mutex> & Lock);
+
+		void Write(const TraceRing::Record_t & Record);
+};
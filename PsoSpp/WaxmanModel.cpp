@@ -0,0 +1,185 @@
+#include "WaxmanModel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+	// Stała złotego podziału - krok licznika splitmix64
+	const uint64_t GoldenGamma = 0x9E3779B97F4A7C15ull;
+
+	// Finalizator splitmix64
+	uint64_t Mix(uint64_t Z)
+	{
+		Z = (Z ^ (Z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		Z = (Z ^ (Z >> 27)) * 0x94D049BB133111EBull;
+		return Z ^ (Z >> 31);
+	}
+}
+
+WaxmanModel::WaxmanModel(const Graph::VertexId_t & SideSize, const double & Alpha, const double & Beta, const Graph::EdgeWeight_t & EdgeWeightMin, const Graph::EdgeWeight_t & EdgeWeightMax, const Seed_t & Seed, const double & Epsilon):
+	SideSize(SideSize), Alpha(Alpha), Beta(Beta), EdgeWeightMin(EdgeWeightMin), EdgeWeightMax(EdgeWeightMax), Seed(Seed), Epsilon(Epsilon),
+	Radius(0), ProbabilityMassTotal(0.0), ProbabilityMassDiscarded(0.0)
+{
+	// Sprawdzenie sensowności parametrów generowania
+	if(SideSize <= 0)
+		throw std::invalid_argument("SideSize <= 0");
+
+	if(Alpha < 0 || Alpha > 1)
+		throw std::invalid_argument("Alpha < 0 || Alpha > 1");
+
+	if(Beta < 0 || Beta > 1)
+		throw std::invalid_argument("Beta < 0 || Beta > 1");
+
+	if(EdgeWeightMin >= EdgeWeightMax || EdgeWeightMin <= 0 || EdgeWeightMax >= std::numeric_limits<Graph::EdgeWeight_t>::max())
+		throw std::invalid_argument("EdgeWeightMin >= EdgeWeightMax || EdgeWeightMin <= 0 || EdgeWeightMax >= std::numeric_limits<EdgeWeight_t>::max()");
+
+	if(Epsilon < 0 || Epsilon > 1)
+		throw std::invalid_argument("Epsilon < 0 || Epsilon > 1");
+
+	// Indeksy wierzchołków muszą mieścić się w Graph::NeighborVertexIndex_t (i w 32-bitowej liczbie ze znakiem dla jąder wektorowych)
+	if((Graph::VertexIndex_t) SideSize * SideSize > (Graph::VertexIndex_t) std::numeric_limits<int32_t>::max())
+		throw std::invalid_argument("SideSize * SideSize > std::numeric_limits<int32_t>::max()");
+
+	// Masy prawdopodobieństwa i promień obcięcia - po wszystkich przesunięciach, bez zapamiętywania prawdopodobieństw
+	for(Graph::VertexId_t DistanceY = 0; DistanceY < SideSize; DistanceY++)
+	{
+		for(Graph::VertexId_t DistanceX = 0; DistanceX < SideSize; DistanceX++)
+		{
+			const double AdjascencyProbability = CalculateAdjascencyProbability(DistanceX, DistanceY);
+
+			// Przesunięcie (0, 0) to ten sam wierzchołek
+			if(DistanceX == 0 && DistanceY == 0)
+				continue;
+
+			// Liczba nieuporządkowanych par wierzchołków o tym przesunięciu - dla dX, dY > 0 dwie orientacje (w prawo / w lewo)
+			const double PairNumber = (DistanceX > 0 && DistanceY > 0 ? 2.0 : 1.0) * (SideSize - DistanceX) * (SideSize - DistanceY);
+
+			ProbabilityMassTotal += PairNumber * AdjascencyProbability;
+
+			if(AdjascencyProbability < Epsilon)
+			{
+				// Pary pomijane przez obcięcie
+				ProbabilityMassDiscarded += PairNumber * AdjascencyProbability;
+			}
+			else
+			{
+				// Prawdopodobieństwo maleje z odległością - wystarczy zapamiętać największe przesunięcie
+				Radius = std::max(Radius, std::max(DistanceX, DistanceY));
+			}
+		}
+	}
+
+	// Tablica tylko dla przesunięć w promieniu obcięcia
+	const size_t RadiusSide = (size_t) Radius + 1;
+	AdjascencyProbabilities.resize(RadiusSide * RadiusSide);
+	for(Graph::VertexId_t DistanceY = 0; DistanceY <= Radius; DistanceY++)
+		for(Graph::VertexId_t DistanceX = 0; DistanceX <= Radius; DistanceX++)
+			AdjascencyProbabilities[RadiusSide * DistanceY + DistanceX] = CalculateAdjascencyProbability(DistanceX, DistanceY);
+}
+
+const Graph::VertexId_t & WaxmanModel::GetSideSize() const
+{
+	return SideSize;
+}
+
+const WaxmanModel::Seed_t & WaxmanModel::GetSeed() const
+{
+	return Seed;
+}
+
+const double & WaxmanModel::GetEpsilon() const
+{
+	return Epsilon;
+}
+
+const Graph::VertexId_t & WaxmanModel::GetRadius() const
+{
+	return Radius;
+}
+
+const double & WaxmanModel::GetProbabilityMassTotal() const
+{
+	return ProbabilityMassTotal;
+}
+
+const double & WaxmanModel::GetProbabilityMassDiscarded() const
+{
+	return ProbabilityMassDiscarded;
+}
+
+size_t WaxmanModel::GetFootprint() const
+{
+	return sizeof(WaxmanModel) + AdjascencyProbabilities.size() * sizeof(double);
+}
+
+double WaxmanModel::GetAdjascencyProbability(const Graph::VertexId_t & DistanceX, const Graph::VertexId_t & DistanceY) const
+{
+	// Poza promieniem obcięcia tablicy nie ma - liczymy wprost
+	if(DistanceX > Radius || DistanceY > Radius)
+		return CalculateAdjascencyProbability(DistanceX, DistanceY);
+
+	return AdjascencyProbabilities[((size_t) Radius + 1) * DistanceY + DistanceX];
+}
+
+Graph::EdgeWeight_t WaxmanModel::GetEdgeWeight(const Graph::VertexIndex_t & Vertex1Index, const Graph::VertexIndex_t & Vertex2Index) const
+{
+	// Brak krawędzi pomiędzy tymi samymi punktami (na przekątnej)
+	if(Vertex1Index == Vertex2Index)
+		return std::numeric_limits<Graph::EdgeWeight_t>::max();
+
+	// Para uporządkowana - wynik symetryczny
+	const Graph::VertexIndex_t VertexIndexHigh = Vertex1Index > Vertex2Index ? Vertex1Index : Vertex2Index;
+	const Graph::VertexIndex_t VertexIndexLow = Vertex1Index > Vertex2Index ? Vertex2Index : Vertex1Index;
+
+	// Odległość pomiędzy dwoma wierzchołkami
+	const Graph::VertexId_t VertexHighX = (Graph::VertexId_t) (VertexIndexHigh % SideSize);
+	const Graph::VertexId_t VertexHighY = (Graph::VertexId_t) (VertexIndexHigh / SideSize);
+	const Graph::VertexId_t VertexLowX = (Graph::VertexId_t) (VertexIndexLow % SideSize);
+	const Graph::VertexId_t VertexLowY = (Graph::VertexId_t) (VertexIndexLow / SideSize);
+
+	const Graph::VertexId_t DistanceX = VertexHighX > VertexLowX ? VertexHighX - VertexLowX : VertexLowX - VertexHighX;
+	const Graph::VertexId_t DistanceY = VertexHighY - VertexLowY;
+
+	// Para poza promieniem lub progiem obcięcia - nigdy nie jest połączona
+	if(DistanceX > Radius || DistanceY > Radius)
+		return std::numeric_limits<Graph::EdgeWeight_t>::max();
+
+	const double AdjascencyProbability = AdjascencyProbabilities[((size_t) Radius + 1) * DistanceY + DistanceX];
+	if(AdjascencyProbability < Epsilon)
+		return std::numeric_limits<Graph::EdgeWeight_t>::max();
+
+	// Czy krawędź istnieje?
+	const bool EdgeExists = AdjascencyProbability >= Uniform(VertexIndexHigh, VertexIndexLow, 0);
+	if(!EdgeExists)
+		return std::numeric_limits<Graph::EdgeWeight_t>::max();
+
+	// Krawędź istnieje - losowa waga z zakresu [EdgeWeightMin, EdgeWeightMax]
+	return EdgeWeightMin + (Graph::EdgeWeight_t) (Uniform(VertexIndexHigh, VertexIndexLow, 1) * (EdgeWeightMax - EdgeWeightMin));
+}
+
+double WaxmanModel::CalculateAdjascencyProbability(const Graph::VertexId_t & DistanceX, const Graph::VertexId_t & DistanceY) const
+{
+	// Traktujemy (VertexId1, VertexId2) jako (x, y)
+	const double VertexDistanceEuclideanMaximal = sqrt(2.0 * SideSize * SideSize);
+
+	// Odległość pomiędzy dwoma wierzchołkami
+	const double VertexDistanceEuclidean = sqrt(1.0 * DistanceX * DistanceX + 1.0 * DistanceY * DistanceY);
+
+	// Formuła Waxmana - prawdopodobieństwo sąsiedzstwa
+	return Alpha * exp((-1.0 * VertexDistanceEuclidean) / (Beta * VertexDistanceEuclideanMaximal));
+}
+
+double WaxmanModel::Uniform(const Graph::VertexIndex_t & Vertex1Index, const Graph::VertexIndex_t & Vertex2Index, const uint64_t & Stream) const
+{
+	// Licznik - para wierzchołków (oba indeksy < 2^31) i numer strumienia
+	const uint64_t Counter = ((((uint64_t) Vertex1Index << 32) | (uint64_t) Vertex2Index) << 1) | Stream;
+
+	// splitmix64 z kluczem zależnym od Seed - generator licznikowy
+	const uint64_t Result = Mix(Mix(Seed) + Counter * GoldenGamma);
+
+	// Górne 53 bity jako liczba z zakresu [0.0; 1.0)
+	return (Result >> 11) * (1.0 / 9007199254740992.0);
+}
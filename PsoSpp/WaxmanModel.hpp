@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Graph.hpp"
+
+/*
+	Model losowego grafu Waxman'a z generatorem licznikowym (counter-based).
+
+	Istnienie i waga krawędzi (Vertex1, Vertex2) wyznaczane są deterministycznie z funkcji mieszającej (Seed, para wierzchołków).
+	Wynik dla danej pary nie zależy od kolejności ani liczby zapytań - krawędzie można więc generować równolegle, w dowolnym porządku,
+	i zawsze otrzymać identyczny graf.
+*/
+class WaxmanModel
+{
+	public:
+		typedef uint64_t Seed_t;
+
+	public:
+		/*
+			SideSize - długość boku kwadratowego grafu
+			Parametry Alpha i Beta w zakresie 0.0 - 1.0 sterują prawdopodobieństwem pojawienia się krawędzi pomiędzy dwoma punktami.
+			EdgeWeightMin, EdgeWeightMax - minimalna i maksymalna waga krawędzi
+			Seed - wartość inicjująca generator
+			Epsilon - próg obcięcia. Pary, dla których prawdopodobieństwo krawędzi jest mniejsze niż Epsilon, nigdy nie są połączone.
+				Dzięki temu krawędzie istnieją tylko w promieniu GetRadius() i generowanie kosztuje O(V * Radius^2) zamiast O(V^2).
+				Epsilon = 0 - model dokładny
+		*/
+		WaxmanModel(const Graph::VertexId_t & SideSize, const double & Alpha, const double & Beta, const Graph::EdgeWeight_t & EdgeWeightMin, const Graph::EdgeWeight_t & EdgeWeightMax, const Seed_t & Seed, const double & Epsilon);
+
+	private:
+		const Graph::VertexId_t SideSize;
+		const double Alpha;
+		const double Beta;
+		const Graph::EdgeWeight_t EdgeWeightMin;
+		const Graph::EdgeWeight_t EdgeWeightMax;
+		const Seed_t Seed;
+		const double Epsilon;
+
+		/*
+			Największe przesunięcie (w osi X lub Y), dla którego prawdopodobieństwo krawędzi jest >= Epsilon
+		*/
+		Graph::VertexId_t Radius;
+
+		/*
+			Prawdopodobieństwa krawędzi w zależności od przesunięcia |dX|, |dY| w promieniu Radius - zamiast liczenia exp() dla każdej pary.
+			Dalsze przesunięcia mają prawdopodobieństwo < Epsilon, więc rozmiar tablicy zależy od Epsilon, a nie od rozmiaru grafu
+		*/
+		std::vector<double> AdjascencyProbabilities; /* (Radius + 1) * (Radius + 1) */
+
+		/*
+			Suma prawdopodobieństw (oczekiwana liczba krawędzi) po wszystkich parach wierzchołków oraz po parach pominiętych przez obcięcie
+		*/
+		double ProbabilityMassTotal;
+		double ProbabilityMassDiscarded;
+
+	public:
+		const Graph::VertexId_t & GetSideSize() const;
+		const Seed_t & GetSeed() const;
+		const double & GetEpsilon() const;
+
+		const Graph::VertexId_t & GetRadius() const;
+		const double & GetProbabilityMassTotal() const;
+		const double & GetProbabilityMassDiscarded() const;
+
+		/*
+			Pamięć zajmowana przez model (z tablicą prawdopodobieństw) w bajtach
+		*/
+		size_t GetFootprint() const;
+
+		/*
+			Prawdopodobieństwo istnienia krawędzi pomiędzy wierzchołkami odległymi o (DistanceX, DistanceY)
+		*/
+		double GetAdjascencyProbability(const Graph::VertexId_t & DistanceX, const Graph::VertexId_t & DistanceY) const;
+
+		/*
+			Waga krawędzi pomiędzy wierzchołkami lub std::numeric_limits<Graph::EdgeWeight_t>::max() jeśli krawędź nie istnieje.
+			Symetryczna - GetEdgeWeight(A, B) == GetEdgeWeight(B, A)
+		*/
+		Graph::EdgeWeight_t GetEdgeWeight(const Graph::VertexIndex_t & Vertex1Index, const Graph::VertexIndex_t & Vertex2Index) const;
+
+	private:
+		/*
+			Formuła Waxmana - prawdopodobieństwo krawędzi dla przesunięcia (DistanceX, DistanceY), liczone z exp()
+		*/
+		double CalculateAdjascencyProbability(const Graph::VertexId_t & DistanceX, const Graph::VertexId_t & DistanceY) const;
+
+		/*
+			Liczba z zakresu [0.0; 1.0) dla pary wierzchołków (Vertex1Index > Vertex2Index) i numeru strumienia (0 - istnienie, 1 - waga)
+		*/
+		double Uniform(const Graph::VertexIndex_t & Vertex1Index, const Graph::VertexIndex_t & Vertex2Index, const uint64_t & Stream) const;
+};
+
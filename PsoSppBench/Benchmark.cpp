@@ -0,0 +1,58 @@
+#include "Benchmark.hpp"
+
+#include <iomanip>
+
+Benchmark::Benchmark(const double & MinimalSeconds, const std::string & Filter):
+	MinimalSeconds(MinimalSeconds), Filter(Filter)
+{
+
+}
+
+const Benchmark::Results_t & Benchmark::GetResults() const
+{
+	return Results;
+}
+
+bool Benchmark::IsEnabled(const std::string & Name) const
+{
+	return Filter.empty() || Name.find(Filter) != std::string::npos;
+}
+
+void Benchmark::Print(const Results_t & Results, std::ostream & Stream)
+{
+	const std::ios_base::fmtflags Flags = Stream.flags();
+
+	Stream << std::left << std::setw(48) << "Benchmark" << std::right << std::setw(14) << "ns/op" << std::setw(12) << "allocs/op" << std::setw(12) << "bytes/op" << "  " << "throughput" << std::endl;
+	for(const Result_t & Result : Results)
+	{
+		Stream << std::left << std::setw(48) << Result.Name << std::right << std::fixed;
+		Stream << std::setprecision(1) << std::setw(14) << Result.Seconds * 1e9 / Result.Operations;
+		Stream << std::setprecision(2) << std::setw(12) << 1.0 * Result.Allocations / Result.Operations;
+		Stream << std::setprecision(0) << std::setw(12) << 1.0 * Result.AllocatedBytes / Result.Operations;
+		if(!Result.ItemName.empty())
+			Stream << "  " << std::setprecision(0) << Result.ItemsPerOperation * Result.Operations / Result.Seconds << " " << Result.ItemName << "/s";
+		Stream << std::endl;
+	}
+
+	Stream.flags(Flags);
+}
+
+void Benchmark::PrintCsv(const Results_t & Results, std::ostream & Stream)
+{
+	const std::ios_base::fmtflags Flags = Stream.flags();
+	const std::streamsize Precision = Stream.precision();
+
+	Stream << "name,operations,seconds,ns_per_op,allocs_per_op,bytes_per_op,items_per_sec,item" << std::endl;
+	for(const Result_t & Result : Results)
+	{
+		Stream << Result.Name << "," << Result.Operations << "," << std::setprecision(9) << Result.Seconds << ",";
+		Stream << Result.Seconds * 1e9 / Result.Operations << ",";
+		Stream << 1.0 * Result.Allocations / Result.Operations << "," << 1.0 * Result.AllocatedBytes / Result.Operations << ",";
+		if(!Result.ItemName.empty())
+			Stream << Result.ItemsPerOperation * Result.Operations / Result.Seconds;
+		Stream << "," << Result.ItemName << std::endl;
+	}
+
+	Stream.flags(Flags);
+	Stream.precision(Precision);
+}
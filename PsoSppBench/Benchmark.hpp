@@ -0,0 +1,107 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "AllocationCounter.hpp"
+
+/*
+	Prosty pomiar czasu wykonania operacji (mikrobenchmark).
+
+	Operacja wykonywana jest seriami o podwajanej liczbie powtórzeń, aż seria potrwa co najmniej MinimalSeconds - wynik pochodzi z ostatniej serii.
+	Poza czasem zliczane są alokacje i bajty zaalokowane przez wszystkie wątki procesu (AllocationCounter), więc pomiar obejmuje również pracę puli wątków.
+	Dane wejściowe operacji przygotowywane są poza pomiarem i deterministycznie (stałe ziarna), więc kolejne uruchomienia mierzą to samo - wyniki można porównywać z zapisanym punktem odniesienia.
+*/
+class Benchmark
+{
+	public:
+		struct Result_t
+		{
+			std::string Name;
+
+			// Liczba wykonanych operacji i ich łączny czas
+			uint64_t Operations;
+			double Seconds;
+
+			// Alokacje wykonane przez wszystkie operacje serii
+			AllocationCounter::Count_t Allocations;
+			AllocationCounter::Count_t AllocatedBytes;
+
+			// Liczba jednostek pracy (np. dekodowań) w jednej operacji i ich nazwa. Pusta nazwa - brak przepustowości w raporcie
+			double ItemsPerOperation;
+			std::string ItemName;
+		};
+		typedef std::vector<Result_t> Results_t;
+
+	public:
+		/*
+			MinimalSeconds - minimalny czas serii pomiarowej
+			Filter - wykonywane są tylko pomiary, których nazwa zawiera Filter (pusty - wszystkie)
+		*/
+		Benchmark(const double & MinimalSeconds, const std::string & Filter);
+
+	private:
+		const double MinimalSeconds;
+		const std::string Filter;
+
+		Results_t Results;
+
+	public:
+		const Results_t & GetResults() const;
+
+		/*
+			Czy pomiar o nazwie Name zostanie wykonany? Pozwala pominąć przygotowanie danych pomiarów odfiltrowanych
+		*/
+		bool IsEnabled(const std::string & Name) const;
+
+	public:
+		/*
+			Mierzy operację Function(OperationIndex), OperationIndex = 0, 1, ... w obrębie serii
+
+			Name - nazwa pomiaru (np. "Particle::Run/side=50")
+			ItemsPerOperation, ItemName - jednostki pracy jednej operacji, raportowane jako przepustowość (ItemName/s)
+		*/
+		template<typename Function_t>
+		void Run(const std::string & Name, const double & ItemsPerOperation, const std::string & ItemName, Function_t && Function)
+		{
+			if(!IsEnabled(Name))
+				return;
+
+			// Rozgrzewka - pierwsze wykonanie (pamięć podręczna, leniwe alokacje) nie wchodzi do wyniku
+			Function(0);
+
+			for(uint64_t Operations = 1; ; Operations *= 2)
+			{
+				const AllocationCounter::Count_t AllocationsBegin = AllocationCounter::GetAllocations();
+				const AllocationCounter::Count_t AllocatedBytesBegin = AllocationCounter::GetAllocatedBytes();
+				const std::chrono::steady_clock::time_point Begin = std::chrono::steady_clock::now();
+
+				for(uint64_t OperationIndex = 0; OperationIndex < Operations; OperationIndex++)
+					Function(OperationIndex);
+
+				const double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Begin).count();
+				const AllocationCounter::Count_t Allocations = AllocationCounter::GetAllocations() - AllocationsBegin;
+				const AllocationCounter::Count_t AllocatedBytes = AllocationCounter::GetAllocatedBytes() - AllocatedBytesBegin;
+				if(Seconds < MinimalSeconds)
+					continue;
+
+				// Liczniki odczytane przed kopiowaniem nazwy - alokacje raportu nie wchodzą do wyniku
+				Results.push_back({ Name, Operations, Seconds, Allocations, AllocatedBytes, ItemsPerOperation, ItemName });
+				return;
+			}
+		}
+
+	public:
+		/*
+			Raport - tabela czytelna dla człowieka
+		*/
+		static void Print(const Results_t & Results, std::ostream & Stream);
+
+		/*
+			Raport - CSV (nagłówek + wiersz na pomiar) do porównań z punktem odniesienia
+		*/
+		static void PrintCsv(const Results_t & Results, std::ostream & Stream);
+};
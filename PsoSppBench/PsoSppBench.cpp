@@ -0,0 +1,396 @@
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "Graph.hpp"
+#include "WaxmanModel.hpp"
+#include "Task.hpp"
+#include "Particle.hpp"
+#include "ParticleGroup.hpp"
+#include "ShortestPathSolver.hpp"
+#include "ThreadPool.hpp"
+#include "StopToken.hpp"
+#include "TargetBest.hpp"
+#include "ProcessRunner.hpp"
+#include "NumaPlacement.hpp"
+
+namespace
+{
+	// Wyniki operacji, których kompilator nie może usunąć jako nieużywanych
+	volatile uint64_t Sink = 0;
+
+	// Parametry roju jak w PsoSpp.cpp
+	const size_t ParticleIterations = 20;
+	const size_t ParticleBetterSolutionFoundNoCountMax = 5;
+	const double Fi1 = 4.0;
+	const double Fi2 = 2.0;
+
+	// Liczba cząstek w pomiarach pojedynczej cząstki - dekodowania krążą po nich, więc dane nie mieszczą się w całości w L1
+	const size_t ParticleNumberSingle = 64;
+
+	// Liczba par wierzchołków w pomiarze losowego dostępu do wag
+	const size_t VertexPairNumber = 4096;
+
+	// Liczba celów w pomiarze zadania wielocelowego
+	const size_t TargetNumber = 64;
+
+	WaxmanModel CreateModel(const Graph::VertexId_t & SideSize)
+	{
+		return WaxmanModel(SideSize, 1.0, 0.20, 10, 100, 0, 1e-6);
+	}
+
+	/*
+		Cząstki na wierszach Swarm - z rozłącznymi strumieniami liczb losowych, jak w ParticleGroup::Run
+	*/
+	std::vector<Particle> CreateParticles(const ParticleGroup & PG, const SwarmMatrix & Swarm)
+	{
+		FastRandom RandomGenerator(0);
+		std::vector<Particle> Particles;
+		Particles.reserve(Swarm.GetParticleNumber());
+		for(size_t ParticleId = 0; ParticleId < Swarm.GetParticleNumber(); ParticleId++)
+		{
+			RandomGenerator.LongJump();
+			Particles.emplace_back(PG, RandomGenerator, Swarm, ParticleId);
+		}
+		return Particles;
+	}
+
+	/*
+		Generowanie grafu - jednym wątkiem i wszystkimi
+	*/
+	void BenchmarkGenerate(Benchmark & B, const Graph::VertexId_t & SideSize)
+	{
+		const WaxmanModel Model = CreateModel(SideSize);
+		const double VertexNumber = 1.0 * SideSize * SideSize;
+
+		for(const size_t ThreadNumber : { (size_t) 1, (size_t) 0 })
+		{
+			B.Run("Graph::GenerateWaxmanRandom/side=" + std::to_string(SideSize) + "/threads=" + (ThreadNumber ? std::to_string(ThreadNumber) : "all"), VertexNumber, "vertices", [&](const uint64_t &)
+			{
+				const Graph G = Graph::GenerateWaxmanRandom(Model, ThreadNumber);
+				Sink = Sink + G.GetEdgeCount();
+			});
+		}
+	}
+
+	/*
+		Dostęp do wag krawędzi - przegląd sąsiadów, pary bliskich wierzchołków (jak przy liczeniu wagi ścieżki) i przegląd całego wiersza macierzy sąsiedztwa
+	*/
+	void BenchmarkEdgeWeight(Benchmark & B, const Graph & G, const std::string & GraphName, const Graph::VertexId_t & SideSize, const Graph::VertexId_t & Radius)
+	{
+		const std::string Prefix = "Graph::GetEdgeWeight/" + GraphName + "/side=" + std::to_string(SideSize);
+		const Graph::VertexIndex_t Size = G.GetSize();
+
+		Graph::NeighborsBuffer_t Buffer = G.CreateNeighborsBuffer();
+		B.Run(Prefix + "/neighbors", 1.0, "vertices", [&](const uint64_t & OperationIndex)
+		{
+			const Graph::Neighbors_t Neighbors = G.GetNeighbors((Graph::VertexIndex_t) (OperationIndex % Size), Buffer);
+			uint64_t Sum = 0;
+			for(size_t NeighborId = 0; NeighborId < Neighbors.Size; NeighborId++)
+				Sum += Neighbors.EdgeWeights[NeighborId];
+			Sink = Sink + Sum;
+		});
+
+		// Pary w odległości nie większej niż promień modelu - tylko takie mogą być krawędziami
+		std::vector<std::pair<Graph::VertexIndex_t, Graph::VertexIndex_t>> VertexPairs(VertexPairNumber);
+		std::mt19937 RandomGenerator(0);
+		std::uniform_int_distribution<Graph::VertexId_t> CoordinateDistribution(0, SideSize - 1);
+		std::uniform_int_distribution<int64_t> OffsetDistribution(-(int64_t) Radius, (int64_t) Radius);
+		const auto Shift = [&](const Graph::VertexId_t & Coordinate)
+		{
+			return (Graph::VertexId_t) std::min<int64_t>(SideSize - 1, std::max<int64_t>(0, Coordinate + OffsetDistribution(RandomGenerator)));
+		};
+		for(auto & VertexPair : VertexPairs)
+		{
+			const Graph::VertexId_t X = CoordinateDistribution(RandomGenerator);
+			const Graph::VertexId_t Y = CoordinateDistribution(RandomGenerator);
+			const Graph::VertexId_t X2 = Shift(X);
+			const Graph::VertexId_t Y2 = Shift(Y);
+			VertexPair = { (Graph::VertexIndex_t) Y * SideSize + X, (Graph::VertexIndex_t) Y2 * SideSize + X2 };
+		}
+
+		B.Run(Prefix + "/near-pairs", 1.0, "lookups", [&](const uint64_t & OperationIndex)
+		{
+			const auto & VertexPair = VertexPairs[OperationIndex % VertexPairNumber];
+			Sink = Sink + G.GetEdgeWeight(VertexPair.first, VertexPair.second);
+		});
+
+		B.Run(Prefix + "/row-scan", 1.0, "lookups", [&](const uint64_t & OperationIndex)
+		{
+			Sink = Sink + G.GetEdgeWeight((Graph::VertexIndex_t) ((OperationIndex / Size) % Size), (Graph::VertexIndex_t) (OperationIndex % Size));
+		});
+	}
+
+	/*
+		Zadanie wielocelowe - cel zadania T i TargetNumber - 1 kolejnych celów rozłożonych równomiernie po wierzchołkach grafu
+	*/
+	Task CreateMultiTargetTask(const Task & T)
+	{
+		const Graph::VertexIndex_t Size = T.GetGraph().GetSize();
+
+		std::vector<Graph::VertexIndex_t> VertexIndexEnds(1, T.GetVertexIndexEnd());
+		for(size_t TargetId = 1; VertexIndexEnds.size() < TargetNumber; TargetId++)
+		{
+			const Graph::VertexIndex_t VertexIndex = (Graph::VertexIndex_t) (TargetId * Size / TargetNumber);
+			if(VertexIndex != T.GetVertexIndexStart() && VertexIndex != T.GetVertexIndexEnd())
+				VertexIndexEnds.push_back(VertexIndex);
+		}
+
+		return Task(T.GetGraph(), T.GetVertexIndexStart(), VertexIndexEnds);
+	}
+
+	/*
+		Pojedyncza cząstka - dekodowanie (z przeszukiwaniem lokalnym i bez, dla jednego i wielu celów) i aktualizacja
+	*/
+	void BenchmarkParticle(Benchmark & B, const Task & T, const Graph::VertexId_t & SideSize)
+	{
+		const std::string Suffix = "/side=" + std::to_string(SideSize);
+		const Graph::VertexIndex_t Size = T.GetGraph().GetSize();
+
+		const Task TMultiTarget = CreateMultiTargetTask(T);
+
+		for(const bool MultiTarget : { false, true })
+		{
+			for(const PathLocalSearch::Mode_t LocalSearch : { PathLocalSearch::Mode_t::None, PathLocalSearch::Mode_t::PathAndPriorities })
+			{
+				const std::string Name = std::string("Particle::Run") + (MultiTarget ? "/targets=" + std::to_string(TargetNumber) : "") + (LocalSearch == PathLocalSearch::Mode_t::None ? "" : "/local-search") + Suffix;
+				if(!B.IsEnabled(Name))
+					continue;
+
+				// Grupa nie jest uruchamiana - dostarcza cząstkom zadanie i ustawienia
+				const Task & TCurrent = MultiTarget ? TMultiTarget : T;
+				ParticleGroup PG(TCurrent, ParticleNumberSingle, ParticleIterations, ParticleBetterSolutionFoundNoCountMax, Fi1, Fi2, 0);
+				PG.SetLocalSearch(LocalSearch);
+
+				SwarmMatrix Swarm(ParticleNumberSingle, Size);
+				std::vector<Particle> Particles = CreateParticles(PG, Swarm);
+
+				// Pierwsze dekodowanie każdej cząstki zapisuje jej najlepszą ścieżkę (alokacja) - mierzymy stan ustalony
+				DecodeScratch Scratch(TCurrent.GetGraph());
+				TargetBest Targets(TCurrent);
+				PerformanceCounters::Values_t Counters;
+				for(Particle & P : Particles)
+					P.Run(Scratch, Targets, Counters);
+
+				B.Run(Name, 1.0, "decodes", [&](const uint64_t & OperationIndex)
+				{
+					Sink = Sink + Particles[OperationIndex % ParticleNumberSingle].Run(Scratch, Targets, Counters);
+				});
+			}
+		}
+
+		if(!B.IsEnabled("Particle::Update" + Suffix) && !B.IsEnabled("Particle::RandomInitialize" + Suffix))
+			return;
+
+		ParticleGroup PG(T, ParticleNumberSingle, ParticleIterations, ParticleBetterSolutionFoundNoCountMax, Fi1, Fi2, 0);
+		SwarmMatrix Swarm(ParticleNumberSingle, Size);
+		std::vector<Particle> Particles = CreateParticles(PG, Swarm);
+
+		const double Chi = Particle::CalculateChi(Fi1, Fi2);
+		std::unique_ptr<double[]> RandomFactors(new double[2 * Size]);
+
+		B.Run("Particle::Update" + Suffix, 1.0 * Size, "priorities", [&](const uint64_t & OperationIndex)
+		{
+			Particles[OperationIndex % ParticleNumberSingle].Update(Fi1, Fi2, Chi, Swarm.GetBestPriorities(0), RandomFactors.get());
+		});
+
+		// Losowanie priorytetów i prędkości - przepustowość generatora cząstki
+		B.Run("Particle::RandomInitialize" + Suffix, 2.0 * Size, "numbers", [&](const uint64_t & OperationIndex)
+		{
+			Particles[OperationIndex % ParticleNumberSingle].RandomInitialize();
+		});
+	}
+
+	/*
+		Ścieżka - budowa z wyliczeniem wagi i nadpisanie w miejscu
+	*/
+	void BenchmarkGraphPath(Benchmark & B, const Task & T, const Graph::VertexId_t & SideSize)
+	{
+		const std::string Suffix = "/side=" + std::to_string(SideSize);
+		if(!B.IsEnabled("GraphPath::GraphPath" + Suffix) && !B.IsEnabled("GraphPath::Assign" + Suffix))
+			return;
+
+		// Ścieżka najkrótsza - typowa długość ścieżki w końcowej fazie roju
+		const ShortestPathSolver::Result_t Result = ShortestPathSolver(T.GetGraph()).Solve(T, true);
+		if(!Result.Path)
+			return;
+		const GraphPath & Path = Result.Path.value();
+
+		B.Run("GraphPath::GraphPath" + Suffix, 1.0 * Path.GetVertexIndexes().size(), "vertices", [&](const uint64_t &)
+		{
+			GraphPath::VertexIndexes_t VertexIndexes = Path.GetVertexIndexes();
+			const GraphPath Copy(T.GetGraph(), std::move(VertexIndexes));
+			Sink = Sink + Copy.GetPathWeight();
+		});
+
+		GraphPath Target(T.GetGraph(), GraphPath::VertexIndexes_t(Path.GetVertexIndexes()));
+		B.Run("GraphPath::Assign" + Suffix, 1.0 * Path.GetVertexIndexes().size(), "vertices", [&](const uint64_t &)
+		{
+			Target.Assign(Path.GetVertexIndexes(), Path.GetPathWeight());
+			Sink = Sink + Target.GetPathWeight();
+		});
+	}
+
+	/*
+		Cała grupa cząstek na puli wątków - ParticleIterations iteracji, razem z budową grupy
+	*/
+	void BenchmarkParticleGroup(Benchmark & B, ThreadPool & Pool, const Task & T, const Graph::VertexId_t & SideSize)
+	{
+		for(const size_t ParticleNumber : { (size_t) 16, (size_t) 64, (size_t) 256 })
+		{
+			B.Run("ParticleGroup::Run/side=" + std::to_string(SideSize) + "/particles=" + std::to_string(ParticleNumber), 1.0 * ParticleNumber * ParticleIterations, "decodes", [&](const uint64_t & OperationIndex)
+			{
+				ParticleGroup PG(T, ParticleNumber, ParticleIterations, ParticleBetterSolutionFoundNoCountMax, Fi1, Fi2, (FastRandom::Seed_t) OperationIndex);
+				StopToken Stop;
+				Sink = Sink + PG.Run(Pool, Stop);
+			});
+		}
+	}
+
+	/*
+		Rój grup na wszystkich wątkach - na wspólnej puli i rozmieszczony na węzłach NUMA (pule węzłów z przypiętymi wątkami, kopie grafu).
+		Na maszynie z jednym węzłem oba warianty różnią się tylko przypięciem wątków
+	*/
+	void BenchmarkParticleGroupRunner(Benchmark & B, ThreadPool & Pool, const Task & T, const Graph::VertexId_t & SideSize)
+	{
+		const std::string Prefix = "ParticleGroupRunner::Run/side=" + std::to_string(SideSize) + "/placement=";
+		if(!B.IsEnabled(Prefix + "none") && !B.IsEnabled(Prefix + "numa"))
+			return;
+
+		NumaPlacement Placement(T.GetGraph(), NumaPlacement::DetectTopology(), Pool.GetThreadNumber(), true);
+
+		const size_t ParticleNumber = 64 * Pool.GetThreadNumber();
+		for(NumaPlacement * const RunPlacement : { (NumaPlacement *) nullptr, &Placement })
+		{
+			B.Run(Prefix + (RunPlacement ? "numa" : "none"), 1.0 * ParticleNumber * ParticleIterations, "decodes", [&](const uint64_t &)
+			{
+				ParticleGroupRunner Runner(Pool, T, 0, ParticleNumber, ParticleIterations, ParticleBetterSolutionFoundNoCountMax, Fi1, Fi2, 5, ParticleGroupRunner::MigrationTopology_t::Ring, false, 0.0, PathLocalSearch::Mode_t::None);
+				Runner.SetPlacement(RunPlacement);
+
+				StopToken Stop;
+				const ParticleGroupRunner::RunResult_t Result = Runner.Run(Stop);
+				Sink = Sink + (Result.GraphPathBest ? Result.GraphPathBest.value().GetPathWeight() : 0);
+			});
+		}
+	}
+
+	/*
+		Zapytanie w kilku procesach roboczych (ProcessRunner) - razem z uruchomieniem procesów i mapowaniem grafu, każdy proces z jednym wątkiem
+	*/
+	void BenchmarkProcessRunner(Benchmark & B, const Task & T, const Graph::VertexId_t & SideSize)
+	{
+	#if defined(_WIN32)
+		(void) B;
+		(void) T;
+		(void) SideSize;
+	#else
+		const std::string Suffix = "/side=" + std::to_string(SideSize);
+		if(!B.IsEnabled("ProcessRunner::Run" + Suffix))
+			return;
+
+		// Procesy robocze mapują graf z pliku
+		const std::string GraphFilePath = (std::filesystem::temp_directory_path() / ("PsoSppBench." + std::to_string(SideSize) + ".graph")).string();
+		T.GetGraph().Write(GraphFilePath);
+		const Graph G = Graph::Load(GraphFilePath, false, false);
+		const Task TFile(G, T.GetVertexIndexStart(), T.GetVertexIndexEnd());
+
+		const size_t ParticleNumber = 64;
+		const Solver::Parameters_t Parameters = { 1, ParticleNumber, ParticleIterations, ParticleBetterSolutionFoundNoCountMax, Fi1, Fi2, 5, ParticleGroupRunner::MigrationTopology_t::Ring, false, 0.0, PathLocalSearch::Mode_t::None };
+
+		for(const size_t WorkerNumber : { (size_t) 1, (size_t) 2 })
+		{
+			B.Run("ProcessRunner::Run" + Suffix + "/workers=" + std::to_string(WorkerNumber), 1.0 * WorkerNumber * ParticleNumber * ParticleIterations, "decodes", [&](const uint64_t &)
+			{
+				ProcessRunner PR(TFile, GraphFilePath, WorkerNumber, 1, Parameters);
+				StopToken Stop;
+				const ProcessRunner::RunResult_t Result = PR.Run(Stop);
+				Sink = Sink + Result.WorkersDone + (Result.Swarm.GraphPathBest ? Result.Swarm.GraphPathBest.value().GetPathWeight() : 0);
+			});
+		}
+
+		std::filesystem::remove(GraphFilePath);
+	#endif
+	}
+
+	void PrintUsage(std::ostream & Stream)
+	{
+		Stream << "Usage: PsoSppBench [--filter TEXT] [--min-time SECONDS] [--csv]" << std::endl;
+		Stream << "  --filter TEXT       run only benchmarks whose name contains TEXT" << std::endl;
+		Stream << "  --min-time SECONDS  minimal duration of a measured series (default 0.5)" << std::endl;
+		Stream << "  --csv               print results as CSV instead of a table" << std::endl;
+	}
+}
+
+int main(int argc, char ** argv)
+{
+	// Proces roboczy uruchomiony przez ProcessRunner (BenchmarkProcessRunner)
+	if(ProcessRunner::IsWorkerCommandLine(argc, argv))
+		return ProcessRunner::WorkerMain(argc, argv);
+
+	std::string Filter;
+	double MinimalSeconds = 0.5;
+	bool Csv = false;
+
+	for(int ArgumentId = 1; ArgumentId < argc; ArgumentId++)
+	{
+		const std::string Argument = argv[ArgumentId];
+		if(Argument == "--filter" && ArgumentId + 1 < argc)
+		{
+			Filter = argv[++ArgumentId];
+		}
+		else if(Argument == "--min-time" && ArgumentId + 1 < argc)
+		{
+			MinimalSeconds = std::atof(argv[++ArgumentId]);
+		}
+		else if(Argument == "--csv")
+		{
+			Csv = true;
+		}
+		else
+		{
+			PrintUsage(Argument == "--help" ? std::cout : std::cerr);
+			return Argument == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	Benchmark B(MinimalSeconds, Filter);
+	ThreadPool Pool(0);
+
+	for(const Graph::VertexId_t SideSize : { 20, 50, 100 })
+	{
+		BenchmarkGenerate(B, SideSize);
+
+		const WaxmanModel Model = CreateModel(SideSize);
+		const Graph G = Graph::GenerateWaxmanRandom(Model, 0);
+		const Graph GImplicit(Model);
+
+		BenchmarkEdgeWeight(B, G, "csr", SideSize, Model.GetRadius());
+		BenchmarkEdgeWeight(B, GImplicit, "implicit", SideSize, Model.GetRadius());
+
+		// Zadanie jak w PsoSpp.cpp - z lewego dolnego do prawego górnego rogu
+		const Task T(G, 0, G.GetSize() - 1);
+		BenchmarkParticle(B, T, SideSize);
+		BenchmarkGraphPath(B, T, SideSize);
+
+		// Grupa na największym grafie trwa zbyt długo na mikrobenchmark
+		if(SideSize <= 50)
+		{
+			BenchmarkParticleGroup(B, Pool, T, SideSize);
+			BenchmarkParticleGroupRunner(B, Pool, T, SideSize);
+			BenchmarkProcessRunner(B, T, SideSize);
+		}
+	}
+
+	if(Csv)
+		Benchmark::PrintCsv(B.GetResults(), std::cout);
+	else
+		Benchmark::Print(B.GetResults(), std::cout);
+
+	return EXIT_SUCCESS;
+}